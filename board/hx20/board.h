@@ -195,6 +195,8 @@
 #define CONFIG_HOSTCMD_ESPI_VW_SLP_S3
 #define CONFIG_HOSTCMD_ESPI_VW_SLP_S4
 #define CONFIG_HOSTCMD_ESPI_VW_SLP_S5
+#define CONFIG_HOSTCMD_DISPATCH_TABLE
+#define CONFIG_HOSTCMD_BATCH
 
 #define CONFIG_POWER_S0IX
 #define CONFIG_POWER_TRACK_HOST_SLEEP_STATE
@@ -205,6 +207,7 @@
 /* #define CONFIG_HOSTCMD_PD_PANIC */
 #define CONFIG_I2C
 #define CONFIG_I2C_MASTER
+#define CONFIG_I2C_STATS
 #define CONFIG_KEYBOARD_BOARD_CONFIG
 #define CONFIG_KEYBOARD_PROTOCOL_8042
 #define CONFIG_SIMULATE_KEYCODE
@@ -204,6 +204,8 @@
 #define CONFIG_HOSTCMD_ESPI_VW_SLP_S3
 #define CONFIG_HOSTCMD_ESPI_VW_SLP_S4
 #define CONFIG_HOSTCMD_ESPI_VW_SLP_S5
+#define CONFIG_HOSTCMD_DISPATCH_TABLE
+#define CONFIG_HOSTCMD_BATCH
 
 #define CONFIG_POWER_S0IX
 #define CONFIG_POWER_TRACK_HOST_SLEEP_STATE
@@ -12,6 +12,7 @@
 #include "task.h"
 #include "timer.h"
 #include "util.h"
+#include "vboot_hash.h"
 #include "watchdog.h"
 
 static void system_init(void)
@@ -308,6 +309,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int res = EC_SUCCESS;
 	int i;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if ((uint32_t)address > CONFIG_PROGRAM_MEMORY_BASE + CONFIG_FLASH_SIZE)
 		return EC_ERROR_INVAL;
 
@@ -357,6 +360,8 @@ int flash_physical_erase(int offset, int size)
 {
 	int res = EC_SUCCESS;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	/* unlock CR if needed */
 	if (STM32_FLASH_CR & CR_LOCK) {
 		STM32_FLASH_KEYR = KEY1;
@@ -12,6 +12,7 @@
 #include "flash.h"
 #include "persistence.h"
 #include "util.h"
+#include "vboot_hash.h"
 
 /* This needs to be aligned to the erase bank size for NVCTR. */
 __aligned(CONFIG_FLASH_ERASE_SIZE) char __host_flash[CONFIG_FLASH_SIZE];
@@ -65,10 +66,19 @@ static void flash_get_persistent(void)
 	release_persistent_storage(f);
 }
 
+int flash_physical_read(int offset, int size, char *data)
+{
+	memcpy(data, __host_flash + offset, size);
+
+	return EC_SUCCESS;
+}
+
 int flash_physical_write(int offset, int size, const char *data)
 {
 	ASSERT((size & (CONFIG_FLASH_WRITE_SIZE - 1)) == 0);
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (flash_pre_op() != EC_SUCCESS)
 		return EC_ERROR_UNKNOWN;
 
@@ -85,6 +95,8 @@ int flash_physical_erase(int offset, int size)
 {
 	ASSERT((size & (CONFIG_FLASH_ERASE_SIZE - 1)) == 0);
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (flash_pre_op() != EC_SUCCESS)
 		return EC_ERROR_UNKNOWN;
 
@@ -9,6 +9,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <termio.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "common.h"
@@ -55,6 +56,27 @@ static void test_capture_char(char c)
 	capture_buf[capture_size++] = c;
 }
 
+static struct uart_tx_stats tx_stats;
+
+void test_get_uart_tx_stats(struct uart_tx_stats *stats)
+{
+	*stats = tx_stats;
+}
+
+void test_reset_uart_tx_stats(void)
+{
+	memset(&tx_stats, 0, sizeof(tx_stats));
+}
+
+/* CPU time used by the calling thread, in nanoseconds */
+static uint64_t thread_cpu_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
 
 const char *test_get_captured_console(void)
 {
@@ -63,8 +85,13 @@ const char *test_get_captured_console(void)
 
 static void uart_interrupt(void)
 {
+	uint64_t start;
+
 	uart_process_input();
+
+	start = thread_cpu_ns();
 	uart_process_output();
+	tx_stats.cpu_ns += thread_cpu_ns() - start;
 }
 
 int uart_init_done(void)
@@ -109,6 +136,24 @@ void uart_write_char(char c)
 		test_capture_char(c);
 	printf("%c", c);
 	fflush(stdout);
+	tx_stats.bytes++;
+	tx_stats.writes++;
+}
+
+__override int uart_write_buf(const char *src, int len)
+{
+	int i;
+
+	if (capture_enabled) {
+		for (i = 0; i < len; i++)
+			test_capture_char(src[i]);
+	}
+	fwrite(src, 1, len, stdout);
+	fflush(stdout);
+	tx_stats.bytes += len;
+	tx_stats.writes++;
+
+	return len;
 }
 
 int uart_read_char(void)
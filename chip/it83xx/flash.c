@@ -16,6 +16,7 @@
 #include "task.h"
 #include "shared_mem.h"
 #include "uart.h"
+#include "vboot_hash.h"
 
 #define FLASH_DMA_START ((uint32_t) &__flash_dma_start)
 #define FLASH_DMA_CODE __attribute__((section(".flash_direct_map")))
@@ -436,6 +437,8 @@ int FLASH_DMA_CODE flash_physical_write(int offset, int size, const char *data)
 {
 	int ret = EC_ERROR_UNKNOWN;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (flash_dma_code_enabled == 0)
 		return EC_ERROR_ACCESS_DENIED;
 
@@ -479,6 +482,8 @@ int FLASH_DMA_CODE flash_physical_erase(int offset, int size)
 {
 	int v_size = size, v_addr = offset, ret = EC_ERROR_UNKNOWN;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (flash_dma_code_enabled == 0)
 		return EC_ERROR_ACCESS_DENIED;
 
@@ -11,6 +11,7 @@
 #include "system.h"
 #include "timer.h"
 #include "util.h"
+#include "vboot_hash.h"
 #include "watchdog.h"
 
 #define FLASH_FWB_WORDS 32
@@ -93,6 +94,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int rv;
 	int i;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (all_protected)
 		return EC_ERROR_ACCESS_DENIED;
 
@@ -127,6 +130,8 @@ int flash_physical_write(int offset, int size, const char *data)
 
 int flash_physical_erase(int offset, int size)
 {
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (all_protected)
 		return EC_ERROR_ACCESS_DENIED;
 
@@ -15,6 +15,7 @@
 #include "common.h"
 #include "icc_regs.h"
 #include "flc_regs.h"
+#include "vboot_hash.h"
 
 #define CPUTS(outstr) cputs(CC_SYSTEM, outstr)
 #define CPRINTS(format, args...) cprints(CC_SYSTEM, format, ##args)
@@ -114,6 +115,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	uint32_t bytes_written;
 	uint8_t current_data[4];
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if ((err = flash_init_controller()) != EC_SUCCESS)
 		return err;
 
@@ -238,6 +241,8 @@ int flash_physical_erase(int offset, int size)
 	int pages;
 	int error_status;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	/*
 	 * erase 'size' number of bytes starting at address 'offset'
 	 */
@@ -9,11 +9,14 @@
 #include "host_command.h"
 #include "shared_mem.h"
 #include "spi.h"
+#include "spi_chip.h"
 #include "spi_flash.h"
 #include "system.h"
+#include "timer.h"
 #include "util.h"
 #include "hooks.h"
 #include "tfdp_chip.h"
+#include "vboot_hash.h"
 
 #define PAGE_SIZE 256
 
@@ -43,6 +46,73 @@ int flash_physical_read(int offset, int size, char *data)
 	return spi_flash_read(data, offset, size);
 }
 
+#ifdef CONFIG_FLASH_READ_ASYNC
+/* Read in flight; sent as transfers of up to SPI_FLASH_MAX_READ_SIZE */
+static struct {
+	uint8_t cmd[4];		/* Sent after the start call returns */
+	int offset;		/* Start of the current transfer */
+	int size;		/* Bytes left, including the current transfer */
+	char *data;		/* Destination of the current transfer */
+} read_async;
+
+/* Start the next transfer of the read in flight */
+static int flash_read_async_next(void)
+{
+	read_async.cmd[0] = SPI_FLASH_READ;
+	read_async.cmd[1] = (read_async.offset >> 16) & 0xFF;
+	read_async.cmd[2] = (read_async.offset >> 8) & 0xFF;
+	read_async.cmd[3] = read_async.offset & 0xFF;
+
+	return spi_transaction_start(SPI_FLASH_DEVICE, read_async.cmd,
+				     sizeof(read_async.cmd),
+				     (uint8_t *)read_async.data,
+				     MIN(read_async.size,
+					 SPI_FLASH_MAX_READ_SIZE));
+}
+
+/**
+ * Start reading from physical flash, with the data moved by QMSPI DMA, so the
+ * caller can work while it completes.  Like spi_flash_read(), a read larger
+ * than SPI_FLASH_MAX_READ_SIZE is split into several transfers, with a 1 ms
+ * sleep between them; only the first overlaps the caller's work.
+ *
+ * @param offset        Flash offset to read.
+ * @param size          Number of bytes to read.
+ * @param data          Destination buffer for data.  Must be 32-bit aligned.
+ */
+int flash_physical_read_async(int offset, int size, char *data)
+{
+	if (offset < 0 || size <= 0 || offset + size > CONFIG_FLASH_SIZE)
+		return EC_ERROR_INVAL;
+
+	read_async.offset = offset;
+	read_async.size = size;
+	read_async.data = data;
+
+	return flash_read_async_next();
+}
+
+int flash_physical_read_wait(void)
+{
+	int rv, len;
+
+	while (1) {
+		rv = spi_transaction_finish(SPI_FLASH_DEVICE);
+		len = MIN(read_async.size, SPI_FLASH_MAX_READ_SIZE);
+		read_async.offset += len;
+		read_async.size -= len;
+		read_async.data += len;
+		if (rv != EC_SUCCESS || !read_async.size)
+			return rv;
+
+		msleep(1);
+		rv = flash_read_async_next();
+		if (rv != EC_SUCCESS)
+			return rv;
+	}
+}
+#endif
+
 /**
  * Write to physical flash.
  *
@@ -57,6 +127,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int ret = EC_SUCCESS;
 	int  i, write_size;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	trace13(0, FLASH, 0,
 		"flash_phys_write: offset=0x%08X size=0x%08X dataptr=0x%08X",
 		offset, size, (uint32_t)data);
@@ -91,6 +163,8 @@ int flash_physical_erase(int offset, int size)
 {
 	int ret;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (entire_flash_locked)
 		return EC_ERROR_ACCESS_DENIED;
 
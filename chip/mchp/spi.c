@@ -264,6 +264,45 @@ int spi_transaction(const struct spi_device_t *spi_device,
 	return rc;
 }
 
+int spi_transaction_start(const struct spi_device_t *spi_device,
+			  const uint8_t *txdata, int txlen,
+			  uint8_t *rxdata, int rxlen)
+{
+	int rc;
+
+	if (spi_device == NULL)
+		return EC_ERROR_PARAM1;
+
+#ifndef LFW
+	spi_mutex_lock(spi_device->port);
+#endif
+
+	rc = spi_transaction_async(spi_device, txdata, txlen, rxdata, rxlen);
+
+#ifndef LFW
+	if (rc != EC_SUCCESS)
+		spi_mutex_unlock(spi_device->port);
+#endif
+
+	return rc;
+}
+
+int spi_transaction_finish(const struct spi_device_t *spi_device)
+{
+	int rc;
+
+	if (spi_device == NULL)
+		return EC_ERROR_PARAM1;
+
+	rc = spi_transaction_flush(spi_device);
+
+#ifndef LFW
+	spi_mutex_unlock(spi_device->port);
+#endif
+
+	return rc;
+}
+
 /**
  * Enable SPI port and associated controller
  *
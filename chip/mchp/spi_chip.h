@@ -54,6 +54,20 @@
 const void *spi_dma_option(const struct spi_device_t *spi_device,
 				int is_tx);
 
+/*
+ * Same as spi_transaction_async() but takes the port mutex, which is held
+ * until spi_transaction_finish() is called from the same task.
+ */
+int spi_transaction_start(const struct spi_device_t *spi_device,
+			  const uint8_t *txdata, int txlen,
+			  uint8_t *rxdata, int rxlen);
+
+/*
+ * Wait for a transaction begun by spi_transaction_start() and release the
+ * port mutex.
+ */
+int spi_transaction_finish(const struct spi_device_t *spi_device);
+
 #endif /* #ifndef _QMSPI_CHIP_H */
 /**   @}
  */
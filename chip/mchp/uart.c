@@ -92,6 +92,26 @@ void uart_write_char(char c)
 	MCHP_UART_TB(0) = c;
 }
 
+__override int uart_write_buf(const char *src, int len)
+{
+	int i;
+
+	if (!uart_tx_ready())
+		return 0;
+
+	/*
+	 * The FIFO was empty when this group of TX_FIFO_SIZE characters was
+	 * started, so whatever is left of the group fits without re-reading
+	 * the line status after every character.
+	 */
+	len = MIN(len, TX_FIFO_SIZE - tx_fifo_used);
+	for (i = 0; i < len; i++)
+		MCHP_UART_TB(0) = src[i];
+
+	tx_fifo_used = (tx_fifo_used + len) % TX_FIFO_SIZE;
+	return len;
+}
+
 int uart_read_char(void)
 {
 	return MCHP_UART_RB(0);
@@ -13,6 +13,7 @@
 #include "system.h"
 #include "util.h"
 #include "hooks.h"
+#include "vboot_hash.h"
 
 #define PAGE_SIZE 256
 
@@ -53,6 +54,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int ret = EC_SUCCESS;
 	int  i, write_size;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (entire_flash_locked)
 		return EC_ERROR_ACCESS_DENIED;
 
@@ -83,6 +86,8 @@ int flash_physical_erase(int offset, int size)
 {
 	int ret;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (entire_flash_locked)
 		return EC_ERROR_ACCESS_DENIED;
 
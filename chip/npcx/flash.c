@@ -17,6 +17,7 @@
 #include "watchdog.h"
 #include "console.h"
 #include "hwtimer_chip.h"
+#include "vboot_hash.h"
 
 static int all_protected; /* Has all-flash protection been requested? */
 static int addr_prot_start;
@@ -498,6 +499,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int write_len;
 	int rv;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	/* Fail if offset, size, and data aren't at least word-aligned */
 	if ((offset | size
 	     | (uint32_t)(uintptr_t)data) & (CONFIG_FLASH_WRITE_SIZE - 1))
@@ -545,6 +548,9 @@ int flash_physical_write(int offset, int size, const char *data)
 int flash_physical_erase(int offset, int size)
 {
 	int rv = EC_SUCCESS;
+
+	vboot_hash_cache_invalidate(offset, size);
+
 	/* check protection */
 	if (all_protected)
 		return EC_ERROR_ACCESS_DENIED;
@@ -19,6 +19,7 @@
 #include "timer.h"
 #include "util.h"
 #include "watchdog.h"
+#include "vboot_hash.h"
 
 #define CPRINTF(format, args...) cprintf(CC_SYSTEM, format, ## args)
 #define CPRINTS(format, args...) cprints(CC_SYSTEM, format, ## args)
@@ -358,6 +359,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int res = EC_SUCCESS;
 	int timeout = calculate_flash_timeout();
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (unlock(NO_EXTRA_LOCK) != EC_SUCCESS) {
 		res = EC_ERROR_UNKNOWN;
 		goto exit_wr;
@@ -432,6 +435,8 @@ int flash_physical_erase(int offset, int size)
 		return EC_ERROR_INVAL;  /* Invalid range */
 #endif
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (unlock(NO_EXTRA_LOCK) != EC_SUCCESS)
 		return EC_ERROR_UNKNOWN;
 
@@ -15,6 +15,7 @@
 #include "timer.h"
 #include "util.h"
 #include "watchdog.h"
+#include "vboot_hash.h"
 
 /*
  * Approximate number of CPU cycles per iteration of the loop when polling
@@ -264,6 +265,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int unaligned = (uint32_t)data & (STM32_FLASH_MIN_WRITE_SIZE - 1);
 	uint32_t *data32 = (void *)data;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (unlock(FLASH_CR_LOCK) != EC_SUCCESS)
 		return EC_ERROR_UNKNOWN;
 
@@ -336,6 +339,8 @@ int flash_physical_erase(int offset, int size)
 	int pg;
 	int last;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (unlock(FLASH_CR_LOCK) != EC_SUCCESS)
 		return EC_ERROR_UNKNOWN;
 
@@ -16,6 +16,7 @@
 #include "timer.h"
 #include "util.h"
 #include "watchdog.h"
+#include "vboot_hash.h"
 
 /*
  * Approximate number of CPU cycles per iteration of the loop when polling
@@ -222,6 +223,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int unaligned = (uint32_t)data & (CONFIG_FLASH_WRITE_SIZE - 1);
 	uint32_t *data32 = (void *)data;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (access_disabled)
 		return EC_ERROR_ACCESS_DENIED;
 
@@ -297,6 +300,8 @@ int flash_physical_erase(int offset, int size)
 	int last = (offset + size) / CONFIG_FLASH_ERASE_SIZE;
 	int sect;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	if (access_disabled)
 		return EC_ERROR_ACCESS_DENIED;
 
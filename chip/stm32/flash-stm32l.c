@@ -13,6 +13,7 @@
 #include "task.h"
 #include "timer.h"
 #include "util.h"
+#include "vboot_hash.h"
 #include "watchdog.h"
 
 /*
@@ -166,6 +167,8 @@ int flash_physical_write(int offset, int size, const char *data)
 	int word_mode = 0;
 	int i;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	/* Fail if offset, size, and data aren't at least word-aligned */
 	if ((offset | size | (uint32_t)(uintptr_t)data) & 3)
 		return EC_ERROR_INVAL;
@@ -245,6 +248,8 @@ int flash_physical_erase(int offset, int size)
 	uint32_t *address;
 	int res = EC_SUCCESS;
 
+	vboot_hash_cache_invalidate(offset, size);
+
 	res = unlock(STM32_FLASH_PECR_PRG_LOCK);
 	if (res)
 		return res;
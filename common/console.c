@@ -122,30 +122,42 @@ static int split_words(char *input, int *argc, char **argv)
  * command.  So "foo" will match "foobar" as long as there isn't also a
  * command "food".
  *
+ * The linker sorts the .rodata.cmds.* sections by name, so binary search for
+ * the first command not below the name.  All commands starting with the name
+ * follow it, with an exact match first.
+ *
  * @param name		Command name to find.
  *
  * @return A pointer to the command structure, or NULL if no match found.
  */
 static const struct console_command *find_command(char *name)
 {
-	const struct console_command *cmd, *match = NULL;
+	const struct console_command *l = __cmds, *r = __cmds_end, *m;
 	int match_length = strlen(name);
 
-	for (cmd = __cmds; cmd < __cmds_end; cmd++) {
-		if (!strncasecmp(name, cmd->name, match_length)) {
-			if (match)
-				return NULL;
-			/*
-			 * Check if 'cmd->name' is of the same length as
-			 * 'name'. If yes, then we have a full match.
-			 */
-			if (cmd->name[match_length] == '\0')
-				return cmd;
-			match = cmd;
-		}
+	while (l < r) {
+		m = l + (r - l) / 2;
+		if (strcasecmp(m->name, name) < 0)
+			l = m + 1;
+		else
+			r = m;
 	}
 
-	return match;
+	if (l == __cmds_end || strncasecmp(name, l->name, match_length))
+		return NULL;
+
+	/*
+	 * Check if 'l->name' is of the same length as 'name'. If yes, then we
+	 * have a full match.
+	 */
+	if (l->name[match_length] == '\0')
+		return l;
+
+	/* Otherwise the partial match must be unique */
+	if (l + 1 < __cmds_end && !strncasecmp(name, l[1].name, match_length))
+		return NULL;
+
+	return l;
 }
 
 
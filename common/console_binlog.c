@@ -0,0 +1,261 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Binary (deferred-formatting) console log records */
+
+#include "common.h"
+#include "console.h"
+#include "console_binlog.h"
+#include "printf.h"
+#include "timer.h"
+#include "uart.h"
+#include "util.h"
+
+/* Cleared by the binlog console command to go back to text output */
+static int binlog_enabled = 1;
+
+struct binlog_record {
+	uint8_t data[BINLOG_MAX_RECORD];
+	int len;
+	int overflow;
+};
+
+static void put_bytes(struct binlog_record *r, const void *data, int len)
+{
+	if (len > (int)sizeof(r->data) - r->len) {
+		r->overflow = 1;
+		return;
+	}
+	memcpy(r->data + r->len, data, len);
+	r->len += len;
+}
+
+static void put_varint(struct binlog_record *r, uint64_t v)
+{
+	uint8_t buf[10];
+	int len = 0;
+
+	while (v >= 0x80) {
+		buf[len++] = (v & 0x7f) | 0x80;
+		v >>= 7;
+	}
+	buf[len++] = v;
+
+	put_bytes(r, buf, len);
+}
+
+static void put_svarint(struct binlog_record *r, int64_t v)
+{
+	put_varint(r, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+/**
+ * Store the arguments of each conversion in format.
+ *
+ * This walks the format the same way vfnprintf() does, but only pulls the
+ * arguments off the list; nothing is converted to text.
+ *
+ * @return EC_SUCCESS, or EC_ERROR_INVAL if the format has a conversion the
+ *         host decoder would not understand.
+ */
+static int put_args(struct binlog_record *r, const char *format,
+		    va_list args)
+{
+	int c;
+
+	while ((c = *format++)) {
+		int is_64bit = 0;
+
+		if (c != '%')
+			continue;
+
+		c = *format++;
+		if (c == '%')
+			continue;
+		if (c == '\0')
+			break;
+
+		/* Flags */
+		while (c == '-' || c == '+' || c == '0')
+			c = *format++;
+
+		/* Width and precision */
+		if (c == '*') {
+			put_svarint(r, va_arg(args, int));
+			c = *format++;
+		}
+		while (c >= '0' && c <= '9')
+			c = *format++;
+		if (c == '.') {
+			c = *format++;
+			if (c == '*') {
+				put_svarint(r, va_arg(args, int));
+				c = *format++;
+			}
+			while (c >= '0' && c <= '9')
+				c = *format++;
+		}
+
+		/* Length */
+		if (c == 'l') {
+			is_64bit = sizeof(long) == sizeof(uint64_t);
+			c = *format++;
+			if (c == 'l') {
+				is_64bit = 1;
+				c = *format++;
+			}
+			/* %l on 32-bit systems prints ERROR; see printf.c */
+			if (!is_64bit)
+				return EC_ERROR_INVAL;
+		} else if (c == 'z') {
+			is_64bit = sizeof(size_t) == sizeof(uint64_t);
+			c = *format++;
+		}
+
+		switch (c) {
+		case 'c':
+			put_varint(r, (uint8_t)va_arg(args, int));
+			break;
+		case 'd':
+#ifdef CONFIG_PRINTF_LEGACY_LI_FORMAT
+		case 'i':
+#endif
+			if (is_64bit)
+				put_svarint(r, va_arg(args, int64_t));
+			else
+				put_svarint(r, va_arg(args, int));
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+			if (is_64bit)
+				put_varint(r, va_arg(args, uint64_t));
+			else
+				put_varint(r, va_arg(args, uint32_t));
+			break;
+		case 's': {
+			const char *str = va_arg(args, const char *);
+			int len;
+
+			if (str == NULL)
+				str = "(NULL)";
+			len = strlen(str);
+			put_varint(r, len);
+			put_bytes(r, str, len);
+			break;
+		}
+		case 'p': {
+			int spec = *format++;
+			void *ptr = va_arg(args, void *);
+
+			if (spec == 'T') {
+				put_varint(r, ptr == PRINTF_TIMESTAMP_NOW ?
+					   get_time().val : *(uint64_t *)ptr);
+			} else if (spec == 'P') {
+				put_varint(r, (uintptr_t)ptr);
+			} else if (spec == 'h') {
+				struct hex_buffer_params *hex = ptr;
+
+				if (!hex) {
+					put_varint(r, 0);
+					break;
+				}
+				put_varint(r, hex->size + 1);
+				put_bytes(r, hex->buffer, hex->size);
+			} else if (spec == 'b') {
+				struct binary_print_params *bin = ptr;
+
+				if (!bin) {
+					put_varint(r, 0);
+					break;
+				}
+				put_varint(r, bin->count + 1);
+				put_varint(r, bin->value);
+			} else {
+				return EC_ERROR_INVAL;
+			}
+			break;
+		}
+		default:
+			return EC_ERROR_INVAL;
+		}
+	}
+
+	return EC_SUCCESS;
+}
+
+static const char base64_chars[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * Encode data as unpadded base64.
+ *
+ * @return Number of characters written to out.
+ */
+static int base64_encode(char *out, const uint8_t *data, int len)
+{
+	char *start = out;
+	int i;
+
+	for (i = 0; i < len; i += 3) {
+		uint32_t v = data[i] << 16;
+
+		if (i + 1 < len)
+			v |= data[i + 1] << 8;
+		if (i + 2 < len)
+			v |= data[i + 2];
+
+		*out++ = base64_chars[(v >> 18) & 0x3f];
+		*out++ = base64_chars[(v >> 12) & 0x3f];
+		if (i + 1 < len)
+			*out++ = base64_chars[(v >> 6) & 0x3f];
+		if (i + 2 < len)
+			*out++ = base64_chars[v & 0x3f];
+	}
+
+	return out - start;
+}
+
+int console_binlog_vprints(enum console_channel channel, const char *format,
+			   va_list args)
+{
+	struct binlog_record r;
+	/* Marker, base64 of the record, and the newline */
+	char line[1 + DIV_ROUND_UP(BINLOG_MAX_RECORD, 3) * 4 + 1];
+	uint32_t id = (uintptr_t)format;
+	uint8_t ch = channel | (IS_ENABLED(CONFIG_CONSOLE_VERBOSE) ?
+				0 : BINLOG_TIMESTAMP_MSEC);
+	int len;
+
+	if (!binlog_enabled)
+		return EC_ERROR_UNIMPLEMENTED;
+
+	r.len = 0;
+	r.overflow = 0;
+
+	put_bytes(&r, &id, sizeof(id));
+	put_bytes(&r, &ch, sizeof(ch));
+	put_varint(&r, get_time().val);
+	if (put_args(&r, format, args) || r.overflow)
+		return EC_ERROR_UNIMPLEMENTED;
+
+	line[0] = BINLOG_MARKER;
+	len = 1 + base64_encode(line + 1, r.data, r.len);
+	line[len++] = '\n';
+
+	return uart_put(line, len);
+}
+
+static int command_binlog(int argc, char **argv)
+{
+	if (argc > 1 && !parse_bool(argv[1], &binlog_enabled))
+		return EC_ERROR_PARAM1;
+
+	ccprintf("Binary log %s\n", binlog_enabled ? "on" : "off");
+	return EC_SUCCESS;
+}
+DECLARE_SAFE_CONSOLE_COMMAND(binlog, command_binlog,
+			     "[on | off]",
+			     "Get or set binary logging of timestamped output");
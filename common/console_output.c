@@ -6,6 +6,7 @@
 /* Console output module for Chrome EC */
 
 #include "console.h"
+#include "console_binlog.h"
 #include "uart.h"
 #include "usb_console.h"
 #include "util.h"
@@ -78,6 +79,40 @@ int cprintf(enum console_channel channel, const char *format, ...)
 	return rv1 == EC_SUCCESS ? rv2 : rv1;
 }
 
+#ifdef CONFIG_CONSOLE_BINARY_LOG
+#if defined(CONFIG_USB_CONSOLE) || defined(CONFIG_USB_CONSOLE_STREAM)
+static int usb_printf(const char *format, ...)
+{
+	int rv;
+	va_list args;
+
+	va_start(args, format);
+	rv = usb_vprintf(format, args);
+	va_end(args);
+
+	return rv;
+}
+
+/* Print a cprints() line to the USB console only */
+static int usb_vprints(const char *format, va_list args)
+{
+	int r, rv;
+
+	rv = usb_printf("[%pT ", PRINTF_TIMESTAMP_NOW);
+	r = usb_vprintf(format, args);
+	if (r)
+		rv = r;
+	r = usb_puts("]\n");
+	return r ? r : rv;
+}
+#else
+static inline int usb_vprints(const char *format, va_list args)
+{
+	return EC_SUCCESS;
+}
+#endif
+#endif /* CONFIG_CONSOLE_BINARY_LOG */
+
 int cprints(enum console_channel channel, const char *format, ...)
 {
 	int r, rv;
@@ -89,6 +124,20 @@ int cprints(enum console_channel channel, const char *format, ...)
 		return EC_SUCCESS;
 #endif
 
+#ifdef CONFIG_CONSOLE_BINARY_LOG
+	/* Leave the formatting to the host if the record can be encoded */
+	va_start(args, format);
+	rv = console_binlog_vprints(channel, format, args);
+	va_end(args);
+	if (rv != EC_ERROR_UNIMPLEMENTED) {
+		/* Nothing decodes records on the USB console; send it text */
+		va_start(args, format);
+		r = usb_vprints(format, args);
+		va_end(args);
+		return rv ? rv : r;
+	}
+#endif
+
 	rv = cprintf(channel, "[%pT ", PRINTF_TIMESTAMP_NOW);
 
 	va_start(args, format);
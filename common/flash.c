@@ -623,6 +623,32 @@ int flash_read(int offset, int size, char *data)
 #endif
 }
 
+#if defined(CONFIG_FLASH_READ_ASYNC) && !defined(CONFIG_MAPPED_STORAGE)
+int flash_read_async(int offset, int size, char *data)
+{
+	return flash_physical_read_async(offset, size, data);
+}
+
+int flash_read_wait(void)
+{
+	return flash_physical_read_wait();
+}
+#else
+/* Result of the last read, reported by flash_read_wait() */
+static int flash_read_result;
+
+int flash_read_async(int offset, int size, char *data)
+{
+	flash_read_result = flash_read(offset, size, data);
+	return EC_SUCCESS;
+}
+
+int flash_read_wait(void)
+{
+	return flash_read_result;
+}
+#endif
+
 static void flash_abort_or_invalidate_hash(int offset, int size)
 {
 #ifdef CONFIG_VBOOT_HASH
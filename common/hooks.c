@@ -8,6 +8,7 @@
 #include "atomic.h"
 #include "console.h"
 #include "hooks.h"
+#include "host_command.h"
 #include "link_defs.h"
 #include "timer.h"
 #include "util.h"
@@ -21,6 +22,7 @@
 #endif
 
 #define DEFERRED_FUNCS_COUNT (__deferred_funcs_end - __deferred_funcs)
+#define DEFERRED_PENDING_WORDS ((DEFERRED_FUNCS_COUNT + 31) / 32)
 
 struct hook_ptrs {
 	const struct hook_data *start;
@@ -64,10 +66,23 @@ static const struct hook_ptrs hook_list[] = {
 	{__hooks_usb_pd_connect, __hooks_usb_pd_connect_end},
 };
 
+/*
+ * Bitmap of hook types whose call order in __hooks_order has been built.
+ *
+ * Building is idempotent: every entry is written with its final value, so two
+ * tasks racing to build the same type write identical data, and a bit lost to
+ * a racing update of a different type only costs a redundant rebuild.
+ */
+static volatile uint32_t hooks_ordered;
+BUILD_ASSERT(ARRAY_SIZE(hook_list) <= 32);
+
 /* Times for deferrable functions */
 static int defer_new_call;
 static int hook_task_started;
 
+/* Number of routines in the deferred call queue */
+static int deferred_queue_len;
+
 #ifdef CONFIG_HOOK_DEBUG
 /* Stats for hooks */
 static uint64_t max_hook_tick_delay;
@@ -100,13 +115,73 @@ static void record_hook_delay(uint64_t now, uint64_t last, uint64_t interval,
 		CPRINTS("Hook at interval %d us delayed by %d us",
 			(uint32_t)interval, (uint32_t)delayed);
 }
+
+BUILD_ASSERT(HOOK_STATS_LATE_BUCKETS == EC_HOOK_STATS_LATE_BUCKETS);
+
+/**
+ * Call a hook or deferred routine and update its profile.
+ *
+ * @param routine	Routine to call
+ * @param stats		Profile of the routine
+ * @param due		Time the routine should have started
+ */
+static void hook_call_profiled(void (*routine)(void),
+			       struct hook_routine_stats *stats, uint64_t due)
+{
+	uint64_t start = get_time().val;
+	uint64_t late = start > due ? start - due : 0;
+	uint64_t run_time;
+	int b;
+
+	routine();
+	run_time = get_time().val - start;
+
+	stats->calls++;
+	stats->total_us += run_time;
+	if (run_time > stats->max_us)
+		stats->max_us = MIN(run_time, UINT32_MAX);
+
+	for (b = 0; b < HOOK_STATS_LATE_BUCKETS - 1; b++)
+		if (late < (64 << (2 * b)))
+			break;
+	if (stats->late[b] < UINT16_MAX)
+		stats->late[b]++;
+}
 #endif
 
+/**
+ * Build the priority-sorted call order for a hook type.
+ *
+ * The hooks of each type are placed in link order, not in priority order.
+ * Rather than rescanning the whole section for every distinct priority on
+ * each notify, compute once where each hook lands in the sorted order.  Hooks
+ * with equal priority keep their link order, as before.
+ */
+static void hook_build_order(enum hook_type type)
+{
+	const struct hook_data *start = hook_list[type].start;
+	int count = hook_list[type].end - start;
+	volatile uint16_t *order = __hooks_order + (start - __hooks_init);
+	int i, j, rank;
+
+	for (i = 0; i < count; i++) {
+		rank = 0;
+		for (j = 0; j < count; j++) {
+			if (start[j].priority < start[i].priority ||
+			    (start[j].priority == start[i].priority && j < i))
+				rank++;
+		}
+		order[rank] = i;
+	}
+
+	hooks_ordered |= BIT(type);
+}
+
 void hook_notify(enum hook_type type)
 {
-	const struct hook_data *start, *end, *p;
-	int count, called = 0;
-	int last_prio = HOOK_PRIO_FIRST - 1, prio;
+	const struct hook_data *start;
+	const uint16_t *order;
+	int count, i;
 #ifdef CONFIG_HOOK_DEBUG
 	uint64_t start_time = get_time().val;
 	uint64_t run_time;
@@ -114,26 +189,22 @@ void hook_notify(enum hook_type type)
 
 	CPRINTS("hook notify %d", type);
 
+	if (!(hooks_ordered & BIT(type)))
+		hook_build_order(type);
+
 	start = hook_list[type].start;
-	end = hook_list[type].end;
-	count = end - start;
+	count = hook_list[type].end - start;
+	order = __hooks_order + (start - __hooks_init);
 
 	/* Call all the hooks in priority order */
-	while (called < count) {
-		/* Find the lowest remaining priority */
-		for (p = start, prio = HOOK_PRIO_LAST + 1; p < end; p++) {
-			if (p->priority < prio && p->priority > last_prio)
-				prio = p->priority;
-		}
-		last_prio = prio;
-
-		/* Call all the hooks with that priority */
-		for (p = start; p < end; p++) {
-			if (p->priority == prio) {
-				called++;
-				p->routine();
-			}
-		}
+	for (i = 0; i < count; i++) {
+#ifdef CONFIG_HOOK_DEBUG
+		hook_call_profiled(start[order[i]].routine,
+				   __hooks_stats + (start - __hooks_init) +
+				   order[i], start_time);
+#else
+		start[order[i]].routine();
+#endif
 	}
 
 #ifdef CONFIG_HOOK_DEBUG
@@ -144,6 +215,104 @@ void hook_notify(enum hook_type type)
 #endif
 }
 
+/*****************************************************************************/
+/* Deferred call queue */
+
+/*
+ * hook_call_deferred() only updates __deferred_until[] and flags the routine
+ * in __deferred_pending[], so it stays safe to call from interrupts.  The hook
+ * task folds the pending requests into __deferred_queue, a min-heap ordered by
+ * firing time, so the next routine due is always at the top.
+ *
+ * The heap keeps the low 32 bits of each firing time.  Deferred delays are at
+ * most INT32_MAX us, so comparing the signed difference of two keys is safe.
+ */
+static inline int deferred_before(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+static inline void deferred_queue_set(int slot, uint32_t deadline, int func)
+{
+	__deferred_queue[slot].deadline = deadline;
+	__deferred_queue[slot].func = func;
+	__deferred_queue[func].pos = slot + 1;
+}
+
+/* Move a node towards the top or bottom of the heap until it is in order */
+static void deferred_queue_sift(int slot, uint32_t deadline, int func)
+{
+	int parent, child;
+
+	while (slot > 0) {
+		parent = (slot - 1) / 2;
+		if (!deferred_before(deadline,
+				     __deferred_queue[parent].deadline))
+			break;
+		deferred_queue_set(slot, __deferred_queue[parent].deadline,
+				   __deferred_queue[parent].func);
+		slot = parent;
+	}
+
+	while ((child = 2 * slot + 1) < deferred_queue_len) {
+		if (child + 1 < deferred_queue_len &&
+		    deferred_before(__deferred_queue[child + 1].deadline,
+				    __deferred_queue[child].deadline))
+			child++;
+		if (!deferred_before(__deferred_queue[child].deadline,
+				     deadline))
+			break;
+		deferred_queue_set(slot, __deferred_queue[child].deadline,
+				   __deferred_queue[child].func);
+		slot = child;
+	}
+
+	deferred_queue_set(slot, deadline, func);
+}
+
+static void deferred_queue_remove(int func)
+{
+	int slot = __deferred_queue[func].pos - 1;
+	int last;
+
+	if (slot < 0)
+		return;
+
+	__deferred_queue[func].pos = 0;
+	last = --deferred_queue_len;
+	if (slot != last)
+		deferred_queue_sift(slot, __deferred_queue[last].deadline,
+				    __deferred_queue[last].func);
+}
+
+/* Fold routines armed or cancelled since the last call into the queue */
+static void deferred_queue_sync(void)
+{
+	uint32_t bits;
+	uint64_t until;
+	int w, i, slot;
+
+	for (w = 0; w < DEFERRED_PENDING_WORDS; w++) {
+		bits = deprecated_atomic_read_clear(&__deferred_pending[w]);
+		while (bits) {
+			i = __fls(bits);
+			bits &= ~BIT(i);
+			i += w * 32;
+
+			until = __deferred_until[i];
+			if (!until) {
+				deferred_queue_remove(i);
+				continue;
+			}
+
+			slot = __deferred_queue[i].pos - 1;
+			if (slot < 0)
+				slot = deferred_queue_len++;
+			deferred_queue_sift(slot, until, i);
+		}
+	}
+}
+
 int hook_call_deferred(const struct deferred_data *data, int us)
 {
 	int i = data - __deferred_funcs;
@@ -154,9 +323,13 @@ int hook_call_deferred(const struct deferred_data *data, int us)
 	if (us == -1) {
 		/* Cancel */
 		__deferred_until[i] = 0;
+		deprecated_atomic_or(&__deferred_pending[i / 32],
+				     BIT(i % 32));
 	} else {
 		/* Set alarm */
 		__deferred_until[i] = get_time().val + us;
+		deprecated_atomic_or(&__deferred_pending[i / 32],
+				     BIT(i % 32));
 		/*
 		 * Flag that hook_call_deferred() has been called.  If the hook
 		 * task is already active, this will allow it to go through the
@@ -190,19 +363,40 @@ void hook_task(void *u)
 		uint64_t t = get_time().val;
 		int next = 0;
 		int i;
+#ifdef CONFIG_HOOK_DEBUG
+		uint64_t due;
+#endif
 
 		/* Handle deferred routines */
-		for (i = 0; i < DEFERRED_FUNCS_COUNT; i++) {
-			if (__deferred_until[i] && __deferred_until[i] < t) {
-				CPRINTS("hook call deferred 0x%pP",
-					__deferred_funcs[i].routine);
-				/*
-				 * Call deferred function.  Clear timer first,
-				 * so it can request itself be called later.
-				 */
-				__deferred_until[i] = 0;
-				__deferred_funcs[i].routine();
-			}
+		deferred_queue_sync();
+		while (deferred_queue_len &&
+		       deferred_before(__deferred_queue[0].deadline, t)) {
+			i = __deferred_queue[0].func;
+			deferred_queue_remove(i);
+
+			/*
+			 * The routine may have been re-armed or cancelled
+			 * since the last sync; if so it is pending again and
+			 * will be requeued with its new time.
+			 */
+			if (!__deferred_until[i] || __deferred_until[i] >= t)
+				continue;
+
+			CPRINTS("hook call deferred 0x%pP",
+				__deferred_funcs[i].routine);
+			/*
+			 * Call deferred function.  Clear timer first,
+			 * so it can request itself be called later.
+			 */
+#ifdef CONFIG_HOOK_DEBUG
+			due = __deferred_until[i];
+			__deferred_until[i] = 0;
+			hook_call_profiled(__deferred_funcs[i].routine,
+					   __deferred_stats + i, due);
+#else
+			__deferred_until[i] = 0;
+			__deferred_funcs[i].routine();
+#endif
 		}
 
 		if (t - last_tick >= HOOK_TICK_INTERVAL) {
@@ -232,15 +426,16 @@ void hook_task(void *u)
 
 		/* Wake earlier if needed by a deferred routine */
 		defer_new_call = 0;
+		deferred_queue_sync();
 
-		for (i = 0; i < DEFERRED_FUNCS_COUNT && next > 0; i++) {
-			if (!__deferred_until[i])
-				continue;
+		if (deferred_queue_len && next > 0) {
+			int32_t delta = __deferred_queue[0].deadline -
+					(uint32_t)t;
 
-			if (__deferred_until[i] < t)
+			if (delta <= 0)
 				next = 0;
-			else if (__deferred_until[i] - t < next)
-				next = __deferred_until[i] - t;
+			else if (delta < next)
+				next = delta;
 		}
 
 		/*
@@ -289,4 +484,74 @@ static int command_stats(int argc, char **argv)
 DECLARE_CONSOLE_COMMAND(hookstats, command_stats,
 			NULL,
 			"Print stats of hooks");
+
+/*****************************************************************************/
+/* Host commands */
+
+/* Return the hook type containing a hook */
+static int hook_type_of(const struct hook_data *hook)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(hook_list); i++)
+		if (hook >= hook_list[i].start && hook < hook_list[i].end)
+			return i;
+
+	return 0;
+}
+
+static enum ec_status hook_command_stats(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_hook_stats *p = args->params;
+	struct ec_response_hook_stats *r = args->response;
+	struct ec_hook_stats_entry *e;
+	struct hook_routine_stats *stats;
+	int total, max, i;
+
+	if (p->kind == EC_HOOK_STATS_HOOKS) {
+		total = __hooks_usb_pd_connect_end - __hooks_init;
+		stats = __hooks_stats;
+	} else if (p->kind == EC_HOOK_STATS_DEFERRED) {
+		total = DEFERRED_FUNCS_COUNT;
+		stats = __deferred_stats;
+	} else {
+		return EC_RES_INVALID_PARAM;
+	}
+
+	if (p->offset > total)
+		return EC_RES_INVALID_PARAM;
+
+	max = (args->response_max - sizeof(*r)) / sizeof(r->entries[0]);
+	r->total = total;
+	r->count = MIN(MIN(total - p->offset, max), UINT8_MAX);
+	r->reserved = 0;
+
+	for (i = 0; i < r->count; i++) {
+		int n = p->offset + i;
+
+		e = &r->entries[i];
+		memset(e, 0, sizeof(*e));
+		if (p->kind == EC_HOOK_STATS_HOOKS) {
+			e->routine = (uintptr_t)__hooks_init[n].routine;
+			e->priority = __hooks_init[n].priority;
+			e->type = hook_type_of(__hooks_init + n);
+		} else {
+			e->routine = (uintptr_t)__deferred_funcs[n].routine;
+			e->type = EC_HOOK_STATS_TYPE_DEFERRED;
+		}
+		e->calls = stats[n].calls;
+		e->max_us = stats[n].max_us;
+		e->total_us = stats[n].total_us;
+		memcpy(e->late, stats[n].late, sizeof(e->late));
+
+		if (p->flags & EC_HOOK_STATS_FLAG_CLEAR)
+			memset(&stats[n], 0, sizeof(stats[n]));
+	}
+
+	args->response_size = sizeof(*r) + r->count * sizeof(r->entries[0]);
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_HOOK_STATS,
+		     hook_command_stats,
+		     EC_VER_MASK(0));
 #endif
@@ -374,13 +374,69 @@ host_packet_bad:
 	host_packet_respond(&args0);
 }
 
+#ifdef CONFIG_HOSTCMD_DISPATCH_TABLE
+/* Number of 256-command pages for device 0 */
+#define HCMD_PAGE_COUNT ((EC_CMD_PASSTHRU_MAX(0) + 1) >> 8)
+/* Page with handlers which did not get a dense table */
+#define HCMD_PAGE_UNMAPPED 0xff
+
+/*
+ * Dispatch table.  hcmd_page[] maps the high byte of a command number to 0 if
+ * the page has no handlers, HCMD_PAGE_UNMAPPED if it must be searched, or
+ * 1 + the dense table of the page.  Dense tables map the low byte of a command
+ * number to 1 + the index of its handler in __hcmds, or 0 if there is none.
+ */
+static uint8_t hcmd_page[HCMD_PAGE_COUNT];
+static uint8_t hcmd_dense[CONFIG_HOSTCMD_DISPATCH_PAGES][256];
+static int hcmd_table_ready;
+
+BUILD_ASSERT(CONFIG_HOSTCMD_DISPATCH_PAGES < HCMD_PAGE_UNMAPPED);
+
+static void host_command_build_table(void)
+{
+	const struct host_command *cmd;
+	int pages = 0;
+	int page;
+
+	/*
+	 * Handler indexes must fit in the dense tables.  The number of
+	 * handlers is only known once the image is linked, so this cannot be
+	 * checked at build time; complain on every boot instead.
+	 */
+	if (__hcmds_end - __hcmds >= UINT8_MAX) {
+		CPRINTS("ERROR: %d host commands, dispatch table holds %d",
+			(int)(__hcmds_end - __hcmds), UINT8_MAX - 1);
+		return;
+	}
+
+	for (cmd = __hcmds; cmd < __hcmds_end; cmd++) {
+		if (cmd->command > EC_CMD_PASSTHRU_MAX(0))
+			continue;
+
+		page = cmd->command >> 8;
+		if (!hcmd_page[page]) {
+			if (pages < CONFIG_HOSTCMD_DISPATCH_PAGES)
+				hcmd_page[page] = ++pages;
+			else
+				hcmd_page[page] = HCMD_PAGE_UNMAPPED;
+		}
+
+		if (hcmd_page[page] != HCMD_PAGE_UNMAPPED)
+			hcmd_dense[hcmd_page[page] - 1][cmd->command & 0xff] =
+				cmd - __hcmds + 1;
+	}
+
+	hcmd_table_ready = 1;
+}
+#endif
+
 /**
- * Find a command by command number.
+ * Search the host command section for a command number.
  *
  * @param command	Command number to find
  * @return The command structure, or NULL if no match found.
  */
-static const struct host_command *find_host_command(int command)
+static const struct host_command *search_host_command(int command)
 {
 #ifdef CONFIG_HOSTCMD_SECTION_SORTED
 	const struct host_command *l, *r, *m;
@@ -416,6 +472,32 @@ static const struct host_command *find_host_command(int command)
 #endif
 }
 
+/**
+ * Find a command by command number.
+ *
+ * @param command	Command number to find
+ * @return The command structure, or NULL if no match found.
+ */
+static const struct host_command *find_host_command(int command)
+{
+#ifdef CONFIG_HOSTCMD_DISPATCH_TABLE
+	if (hcmd_table_ready && command <= EC_CMD_PASSTHRU_MAX(0)) {
+		int page = hcmd_page[command >> 8];
+		int i;
+
+		if (!page)
+			return NULL;
+
+		if (page != HCMD_PAGE_UNMAPPED) {
+			i = hcmd_dense[page - 1][command & 0xff];
+			return i ? __hcmds + i - 1 : NULL;
+		}
+	}
+#endif
+
+	return search_host_command(command);
+}
+
 static void host_command_init(void)
 {
 	/* Initialize memory map ID area */
@@ -435,6 +517,10 @@ static void host_command_init(void)
 #ifdef CONFIG_SUPPRESSED_HOST_COMMANDS
 	suppressed_cmd_deadline.val = get_time().val + SUPPRESSED_CMD_INTERVAL;
 #endif
+
+#ifdef CONFIG_HOSTCMD_DISPATCH_TABLE
+	host_command_build_table();
+#endif
 }
 
 void host_command_task(void *u)
@@ -680,6 +766,51 @@ static void host_command_debug_request(struct host_cmd_handler_args *args)
 		CPRINTS("HC 0x%02x", args->command);
 }
 
+#ifdef CONFIG_HOSTCMD_STATS
+BUILD_ASSERT(HOST_COMMAND_STATS_BUCKETS == EC_HOST_STATS_BUCKETS);
+/* The linker scripts reserve five times the command table for profiles */
+BUILD_ASSERT(sizeof(struct host_command_stats) <=
+	     5 * sizeof(struct host_command));
+
+/**
+ * Call a host command handler and update its profile.
+ *
+ * @param cmd		Host command to call
+ * @param args		Host command args
+ * @return The handler result.
+ */
+static int host_command_call_profiled(const struct host_command *cmd,
+				      struct host_cmd_handler_args *args)
+{
+	struct host_command_stats *stats = __hcmds_stats + (cmd - __hcmds);
+	uint64_t start = get_time().val;
+	uint32_t run_time;
+	int rv, b;
+
+	rv = cmd->handler(args);
+	run_time = MIN(get_time().val - start, UINT32_MAX);
+
+	if (!stats->calls || run_time < stats->min_us)
+		stats->min_us = run_time;
+	if (run_time > stats->max_us)
+		stats->max_us = run_time;
+	stats->total_us += run_time;
+	stats->calls++;
+
+	if (rv != EC_RES_SUCCESS) {
+		stats->errors++;
+		stats->last_error = rv;
+	}
+
+	b = run_time < 16 ? 0 : __fls(run_time) - 3;
+	b = MIN(b, HOST_COMMAND_STATS_BUCKETS - 1);
+	if (stats->hist[b] < UINT16_MAX)
+		stats->hist[b]++;
+
+	return rv;
+}
+#endif
+
 uint16_t host_command_process(struct host_cmd_handler_args *args)
 {
 	const struct host_command *cmd;
@@ -726,7 +857,11 @@ uint16_t host_command_process(struct host_cmd_handler_args *args)
 		else if (!(EC_VER_MASK(args->version) & cmd->version_mask))
 			rv = EC_RES_INVALID_VERSION;
 		else
+#ifdef CONFIG_HOSTCMD_STATS
+			rv = host_command_call_profiled(cmd, args);
+#else
 			rv = cmd->handler(args);
+#endif
 	}
 
 	if (rv != EC_RES_SUCCESS)
@@ -809,6 +944,169 @@ DECLARE_HOST_COMMAND(EC_CMD_GET_FEATURES,
 		     EC_VER_MASK(0));
 
 
+#ifdef CONFIG_HOSTCMD_BATCH
+#define BATCH_PAD(x) (((x) + EC_BATCH_ALIGN - 1) & ~(EC_BATCH_ALIGN - 1))
+
+/*
+ * Commands which send their response early through host_send_response(), or
+ * never return, cannot run inside a batch: the host would not get the batch
+ * response.
+ */
+static int host_command_batch_allowed(uint16_t command)
+{
+	switch (command) {
+	case EC_CMD_BATCH:
+	case EC_CMD_FLASH_ERASE:
+	case EC_CMD_REBOOT:
+	case EC_CMD_REBOOT_EC:
+		return 0;
+	default:
+		return 1;
+	}
+}
+
+/*
+ * Drop any early response a sub-command sends anyway; the host is still
+ * waiting for the whole batch.
+ */
+static void host_command_batch_respond(struct host_cmd_handler_args *args)
+{
+}
+
+static enum ec_status host_command_batch(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_batch *p = args->params;
+	struct ec_response_batch *r = args->response;
+	const uint8_t *in = args->params;
+	uint8_t *out = args->response;
+	const struct ec_params_batch_entry *e;
+	struct ec_response_batch_entry *re;
+	struct host_cmd_handler_args sub;
+	int in_off = sizeof(*p);
+	int out_off = sizeof(*r);
+	int i;
+
+	if (args->params_size < sizeof(*p) ||
+	    args->response_max < sizeof(*r))
+		return EC_RES_INVALID_PARAM;
+
+	/*
+	 * Validate every sub-request before running any, so a malformed
+	 * batch has no side effects.
+	 */
+	for (i = 0; i < p->count; i++) {
+		if (in_off + sizeof(*e) > args->params_size)
+			return EC_RES_INVALID_PARAM;
+		e = (const void *)(in + in_off);
+		if (!host_command_batch_allowed(e->command))
+			return EC_RES_INVALID_PARAM;
+		in_off += sizeof(*e) + BATCH_PAD(e->size);
+		if (in_off > args->params_size)
+			return EC_RES_INVALID_PARAM;
+	}
+
+	in_off = sizeof(*p);
+	r->count = 0;
+
+	for (i = 0; i < p->count; i++) {
+		/* Return what fits; the host sees count is short */
+		if (out_off + sizeof(*re) > args->response_max)
+			break;
+
+		e = (const void *)(in + in_off);
+		in_off += sizeof(*e) + BATCH_PAD(e->size);
+		re = (void *)(out + out_off);
+		out_off += sizeof(*re);
+
+		sub.send_response = host_command_batch_respond;
+		sub.command = e->command;
+		sub.version = e->version;
+		sub.params = e + 1;
+		sub.params_size = e->size;
+		sub.response = out + out_off;
+		sub.response_max = args->response_max - out_off;
+		sub.response_size = 0;
+		sub.result = EC_RES_SUCCESS;
+
+		re->result = host_command_process(&sub);
+#ifdef CONFIG_HOST_COMMAND_STATUS
+		/* An early response must not swallow the batch response */
+		command_pending = 0;
+#endif
+		if (re->result == EC_RES_IN_PROGRESS)
+			re->result = EC_RES_ERROR;
+
+		re->size = 0;
+		if (re->result == EC_RES_SUCCESS) {
+			re->size = MIN(sub.response_size, sub.response_max);
+			/* Some handlers point the response at their own data */
+			if (sub.response != out + out_off)
+				memmove(out + out_off, sub.response, re->size);
+		}
+		out_off = MIN(out_off + BATCH_PAD(re->size),
+			      args->response_max);
+		r->count++;
+
+		if ((p->flags & EC_BATCH_FLAG_STOP_ON_ERROR) &&
+		    re->result != EC_RES_SUCCESS)
+			break;
+	}
+
+	args->response_size = out_off;
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_BATCH,
+		     host_command_batch,
+		     EC_VER_MASK(0));
+#endif /* CONFIG_HOSTCMD_BATCH */
+
+
+#ifdef CONFIG_HOSTCMD_STATS
+static enum ec_status host_command_stats(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_host_stats *p = args->params;
+	struct ec_response_host_stats *r = args->response;
+	struct ec_host_stats_entry *e;
+	struct host_command_stats *stats;
+	int total = __hcmds_end - __hcmds;
+	int max, i;
+
+	if (p->offset > total)
+		return EC_RES_INVALID_PARAM;
+
+	max = (args->response_max - sizeof(*r)) / sizeof(r->entries[0]);
+	r->total = total;
+	r->count = MIN(MIN(total - p->offset, max), UINT8_MAX);
+	r->reserved = 0;
+
+	for (i = 0; i < r->count; i++) {
+		int n = p->offset + i;
+
+		stats = __hcmds_stats + n;
+		e = &r->entries[i];
+		memset(e, 0, sizeof(*e));
+		e->command = __hcmds[n].command;
+		e->last_error = stats->last_error;
+		e->calls = stats->calls;
+		e->errors = stats->errors;
+		e->min_us = stats->min_us;
+		e->max_us = stats->max_us;
+		e->total_us = stats->total_us;
+		memcpy(e->hist, stats->hist, sizeof(e->hist));
+
+		if (p->flags & EC_HOST_STATS_FLAG_CLEAR)
+			memset(stats, 0, sizeof(*stats));
+	}
+
+	args->response_size = sizeof(*r) + r->count * sizeof(r->entries[0]);
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_HOST_STATS,
+		     host_command_stats,
+		     EC_VER_MASK(0));
+#endif /* CONFIG_HOSTCMD_STATS */
+
+
 /*****************************************************************************/
 /* Console commands */
 
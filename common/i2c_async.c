@@ -0,0 +1,240 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Asynchronous I2C transfers with per-port request queues */
+
+#include "common.h"
+#include "i2c.h"
+#include "i2c_bitbang.h"
+#include "task.h"
+#include "util.h"
+
+#ifndef CONFIG_I2C_BITBANG
+#define I2C_BITBANG_PORT_COUNT 0
+#endif
+
+#define I2C_ASYNC_PORT_COUNT (I2C_PORT_COUNT + I2C_BITBANG_PORT_COUNT)
+
+/* Event which tells an I2C async task that a request was queued */
+#define TASK_EVENT_I2C_ASYNC_QUEUED TASK_EVENT_CUSTOM_BIT(0)
+
+/* One FIFO per priority class on each port */
+struct i2c_async_queue {
+	struct i2c_async_req *head[I2C_ASYNC_PRIO_COUNT];
+	struct i2c_async_req *tail[I2C_ASYNC_PRIO_COUNT];
+};
+
+/*
+ * Queues are kept per entry of i2c_ports[], followed by i2c_bitbang_ports[],
+ * rather than per port number: port numbers may be sparse, e.g. a board with
+ * I2C_PORT_COUNT 5 may use MCHP_I2C_PORT6.
+ */
+static struct i2c_async_queue queues[I2C_ASYNC_PORT_COUNT];
+
+/* Task serving each port, plus one; 0 if none */
+static uint8_t port_worker[I2C_ASYNC_PORT_COUNT];
+BUILD_ASSERT(TASK_ID_COUNT < UINT8_MAX);
+
+/**
+ * Find the queue index of a port.
+ *
+ * @return Index into queues[], or -1 if the port is not in any port table.
+ */
+static int port_to_index(int port)
+{
+	int i;
+
+	for (i = 0; i < MIN(i2c_ports_used, I2C_PORT_COUNT); i++) {
+		if (i2c_ports[i].port == port)
+			return i;
+	}
+
+	if (IS_ENABLED(CONFIG_I2C_BITBANG)) {
+		for (i = 0; i < i2c_bitbang_ports_used; i++) {
+			if (i2c_bitbang_ports[i].port == port)
+				return I2C_PORT_COUNT + i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Find the port number of a queue index.
+ *
+ * @return Port number, or -1 if no port uses the index.
+ */
+static int index_to_port(int index)
+{
+	if (index < MIN(i2c_ports_used, I2C_PORT_COUNT))
+		return i2c_ports[index].port;
+
+	index -= I2C_PORT_COUNT;
+	if (IS_ENABLED(CONFIG_I2C_BITBANG) && index >= 0 &&
+	    index < i2c_bitbang_ports_used)
+		return i2c_bitbang_ports[index].port;
+
+	return -1;
+}
+
+static void i2c_async_finish(struct i2c_async_req *req, int rv)
+{
+	req->rv = rv;
+	req->state = I2C_ASYNC_DONE;
+
+	if (req->complete)
+		req->complete(req);
+	if (req->event)
+		task_set_event(req->task, req->event, 0);
+}
+
+static void i2c_async_run(struct i2c_async_req *req)
+{
+	i2c_async_finish(req, i2c_xfer(req->port, req->slave_addr_flags,
+				       req->out, req->out_size,
+				       req->in, req->in_size));
+}
+
+int i2c_xfer_async(struct i2c_async_req *req)
+{
+	struct i2c_async_queue *q;
+	int index = port_to_index(req->port);
+	int worker;
+
+	if (index < 0 || req->prio < 0 || req->prio >= I2C_ASYNC_PRIO_COUNT)
+		return EC_ERROR_INVAL;
+
+	q = &queues[index];
+
+	interrupt_disable();
+	if (req->state == I2C_ASYNC_QUEUED ||
+	    req->state == I2C_ASYNC_RUNNING) {
+		interrupt_enable();
+		return EC_ERROR_BUSY;
+	}
+
+	worker = port_worker[index];
+	if (!worker) {
+		/* Nobody to hand it to; run it now */
+		req->state = I2C_ASYNC_RUNNING;
+		interrupt_enable();
+		i2c_async_run(req);
+		return EC_SUCCESS;
+	}
+
+	req->state = I2C_ASYNC_QUEUED;
+	req->next = NULL;
+	if (q->tail[req->prio])
+		q->tail[req->prio]->next = req;
+	else
+		q->head[req->prio] = req;
+	q->tail[req->prio] = req;
+	interrupt_enable();
+
+	task_set_event(worker - 1, TASK_EVENT_I2C_ASYNC_QUEUED, 0);
+	return EC_SUCCESS;
+}
+
+int i2c_async_cancel(struct i2c_async_req *req)
+{
+	struct i2c_async_queue *q;
+	struct i2c_async_req **p;
+	struct i2c_async_req *prev = NULL;
+	int index = port_to_index(req->port);
+	int rv = EC_SUCCESS;
+
+	if (index < 0 || req->prio < 0 || req->prio >= I2C_ASYNC_PRIO_COUNT)
+		return EC_ERROR_INVAL;
+
+	q = &queues[index];
+
+	interrupt_disable();
+	if (req->state == I2C_ASYNC_RUNNING) {
+		rv = EC_ERROR_BUSY;
+	} else if (req->state == I2C_ASYNC_QUEUED) {
+		for (p = &q->head[req->prio]; *p; prev = *p, p = &(*p)->next) {
+			if (*p != req)
+				continue;
+			*p = req->next;
+			if (q->tail[req->prio] == req)
+				q->tail[req->prio] = prev;
+			break;
+		}
+		req->state = I2C_ASYNC_IDLE;
+	}
+	interrupt_enable();
+
+	return rv;
+}
+
+/**
+ * Take the next request for the calling task off the queues.
+ *
+ * Higher priority classes go first.  Within a class, ports are served round
+ * robin starting after *last_index, so one busy port cannot starve another.
+ *
+ * @return The request, now marked running, or NULL if there is none.
+ */
+static struct i2c_async_req *i2c_async_next(uint8_t worker, int *last_index)
+{
+	struct i2c_async_req *req = NULL;
+	int prio, i, index;
+
+	interrupt_disable();
+	for (prio = 0; prio < I2C_ASYNC_PRIO_COUNT && !req; prio++) {
+		for (i = 1; i <= I2C_ASYNC_PORT_COUNT; i++) {
+			index = (*last_index + i) % I2C_ASYNC_PORT_COUNT;
+			if (port_worker[index] != worker)
+				continue;
+
+			req = queues[index].head[prio];
+			if (!req)
+				continue;
+
+			queues[index].head[prio] = req->next;
+			if (!req->next)
+				queues[index].tail[prio] = NULL;
+			req->state = I2C_ASYNC_RUNNING;
+			*last_index = index;
+			break;
+		}
+	}
+	interrupt_enable();
+
+	return req;
+}
+
+void i2c_async_task(void *u)
+{
+	uint32_t ports = (uintptr_t)u;
+	uint8_t worker = task_get_current() + 1;
+	struct i2c_async_req *req;
+	int last_index = I2C_ASYNC_PORT_COUNT - 1;
+	int index, port;
+
+	/*
+	 * Claim the ports.  A task started with an explicit mask takes its
+	 * ports over from a catch-all task which may have started first.
+	 */
+	interrupt_disable();
+	for (index = 0; index < I2C_ASYNC_PORT_COUNT; index++) {
+		port = index_to_port(index);
+		if (port < 0 || port >= 32)
+			continue;
+		if (ports ? (ports & BIT(port)) : !port_worker[index])
+			port_worker[index] = worker;
+	}
+	interrupt_enable();
+
+	while (1) {
+		req = i2c_async_next(worker, &last_index);
+		if (!req) {
+			task_wait_event_mask(TASK_EVENT_I2C_ASYNC_QUEUED, -1);
+			continue;
+		}
+
+		i2c_async_run(req);
+	}
+}
@@ -6,6 +6,7 @@
 /* I2C cross-platform code for Chrome EC */
 
 #include "battery.h"
+#include "battery_smart.h"
 #include "clock.h"
 #include "charge_state.h"
 #include "console.h"
@@ -17,6 +18,7 @@
 #include "i2c_private.h"
 #include "system.h"
 #include "task.h"
+#include "timer.h"
 #include "usb_pd.h"
 #include "usb_pd_tcpm.h"
 #include "util.h"
@@ -97,10 +99,15 @@ static int chip_i2c_xfer_with_notify(const int port,
 	int ret;
 	uint16_t addr_flags = slave_addr_flags;
 	const struct i2c_port_t *i2c_port = get_i2c_port(port);
+	uint32_t start = 0, elapsed = 0;
 
 	if (IS_ENABLED(CONFIG_I2C_XFER_BOARD_CALLBACK))
 		i2c_start_xfer_notify(port, slave_addr_flags);
 
+	if (IS_ENABLED(CONFIG_I2C_STATS) ||
+	    IS_ENABLED(CONFIG_I2C_TRACE_BUFFER))
+		start = get_time().le.lo;
+
 	if (IS_ENABLED(CONFIG_SMBUS_PEC))
 		/*
 		 * Since we've done PEC processing here,
@@ -114,6 +121,19 @@ static int chip_i2c_xfer_with_notify(const int port,
 		ret = chip_i2c_xfer(port, addr_flags,
 				    out, out_size, in, in_size, flags);
 
+	if (IS_ENABLED(CONFIG_I2C_STATS) ||
+	    IS_ENABLED(CONFIG_I2C_TRACE_BUFFER))
+		elapsed = get_time().le.lo - start;
+
+	if (IS_ENABLED(CONFIG_I2C_STATS))
+		i2c_stats_xfer(port, slave_addr_flags, out_size + in_size, ret,
+			       elapsed);
+
+	if (IS_ENABLED(CONFIG_I2C_TRACE_BUFFER))
+		i2c_trace_buffer_record(port, slave_addr_flags, out, out_size,
+					in, in_size, flags, ret, start,
+					elapsed);
+
 	if (IS_ENABLED(CONFIG_I2C_XFER_BOARD_CALLBACK))
 		i2c_end_xfer_notify(port, slave_addr_flags);
 
@@ -184,6 +204,9 @@ int i2c_xfer_unlocked(const int port,
 #endif /* CONFIG_I2C_XFER_LARGE_READ */
 		if (ret != EC_ERROR_BUSY)
 			break;
+		if (IS_ENABLED(CONFIG_I2C_STATS) &&
+		    i < CONFIG_I2C_NACK_RETRY_COUNT)
+			i2c_stats_retry(port, addr_flags);
 	}
 	return ret;
 }
@@ -1105,6 +1128,9 @@ static enum ec_status i2c_command_passthru(struct host_cmd_handler_args *args)
 	int in_len;
 	int ret, i;
 	int port_is_locked = 0;
+#if defined(CONFIG_BATTERY_SMART_CACHE) && defined(I2C_PORT_BATTERY)
+	int battery_written = 0;
+#endif
 
 #ifdef CONFIG_BATTERY_CUT_OFF
 	/*
@@ -1192,6 +1218,19 @@ static enum ec_status i2c_command_passthru(struct host_cmd_handler_args *args)
 					       xferflags);
 		}
 
+#if defined(CONFIG_BATTERY_SMART_CACHE) && defined(I2C_PORT_BATTERY)
+		/*
+		 * Any write but the command byte of a read may change what
+		 * the battery reports, so drop its cached registers.
+		 */
+		if (write_len && params->port == I2C_PORT_BATTERY &&
+		    I2C_GET_ADDR(addr_flags) ==
+		    I2C_GET_ADDR(BATTERY_ADDR_FLAGS) &&
+		    !(write_len == 1 && !(xferflags & I2C_XFER_STOP) &&
+		      (msg[1].addr_flags & EC_I2C_FLAG_READ)))
+			battery_written = 1;
+#endif
+
 		if (rv) {
 			/* Driver will have sent a stop bit here */
 			if (rv == EC_ERROR_TIMEOUT)
@@ -1210,6 +1249,11 @@ static enum ec_status i2c_command_passthru(struct host_cmd_handler_args *args)
 	if (port_is_locked)
 		i2c_lock(params->port, 0);
 
+#if defined(CONFIG_BATTERY_SMART_CACHE) && defined(I2C_PORT_BATTERY)
+	if (battery_written)
+		sb_cache_invalidate(1);
+#endif
+
 	/*
 	 * Return success even if transfer failed so response is sent.  Host
 	 * will check message status to determine the transfer result.
@@ -0,0 +1,227 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* I2C bus utilization and latency counters */
+
+#include "common.h"
+#include "console.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "task.h"
+#include "timer.h"
+#include "util.h"
+
+struct i2c_stats {
+	uint8_t port;
+	uint8_t addr;
+	uint32_t xfers;
+	uint32_t errors;
+	uint32_t timeouts;
+	uint32_t retries;
+	uint32_t bytes;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint16_t hist[EC_I2C_STATS_BUCKETS];
+};
+
+BUILD_ASSERT(CONFIG_I2C_STATS_DEVICES <= UINT8_MAX);
+
+static struct i2c_stats stats[CONFIG_I2C_STATS_DEVICES];
+static int stats_count;
+static uint32_t dropped;
+static timestamp_t window_start;
+
+/*
+ * Find the entry for a device, adding it if this is the first transfer to it.
+ * Each entry is only updated by the task holding its port lock, so only
+ * adding an entry needs protecting here; readers which clear an entry take
+ * the port lock too.
+ */
+static struct i2c_stats *i2c_stats_find(int port, uint16_t slave_addr_flags)
+{
+	uint8_t addr = I2C_GET_ADDR(slave_addr_flags);
+	struct i2c_stats *s = NULL;
+	int i, count = stats_count;
+
+	for (i = 0; i < count; i++) {
+		if (stats[i].port == port && stats[i].addr == addr)
+			return &stats[i];
+	}
+
+	interrupt_disable();
+	/* Another task may have added entries in the meantime */
+	for (i = count; i < stats_count; i++) {
+		if (stats[i].port == port && stats[i].addr == addr) {
+			s = &stats[i];
+			break;
+		}
+	}
+	if (!s && stats_count < ARRAY_SIZE(stats)) {
+		s = &stats[stats_count];
+		memset(s, 0, sizeof(*s));
+		s->port = port;
+		s->addr = addr;
+		stats_count++;
+	}
+	interrupt_enable();
+
+	return s;
+}
+
+void i2c_stats_xfer(int port, uint16_t slave_addr_flags, int bytes, int rv,
+		    uint32_t us)
+{
+	struct i2c_stats *s = i2c_stats_find(port, slave_addr_flags);
+	int b;
+
+	if (!s) {
+		/* Transfers on different ports may get here at once */
+		interrupt_disable();
+		dropped++;
+		interrupt_enable();
+		return;
+	}
+
+	s->xfers++;
+	s->bytes += bytes;
+	if (rv == EC_ERROR_TIMEOUT)
+		s->timeouts++;
+	else if (rv)
+		s->errors++;
+
+	s->total_us += us;
+	if (us > s->max_us)
+		s->max_us = us;
+
+	b = us < 32 ? 0 : __fls(us) - 4;
+	b = MIN(b, EC_I2C_STATS_BUCKETS - 1);
+	if (s->hist[b] < UINT16_MAX)
+		s->hist[b]++;
+}
+
+void i2c_stats_retry(int port, uint16_t slave_addr_flags)
+{
+	struct i2c_stats *s = i2c_stats_find(port, slave_addr_flags);
+
+	if (s)
+		s->retries++;
+}
+
+/*
+ * Copy an entry into out, if not NULL, and then clear it if asked.  This holds
+ * the port lock, so a transfer cannot be counted between the two.
+ */
+static void i2c_stats_read(struct i2c_stats *s, struct i2c_stats *out,
+			   int clear)
+{
+	i2c_lock(s->port, 1);
+	if (out)
+		*out = *s;
+	if (clear) {
+		uint8_t port = s->port;
+		uint8_t addr = s->addr;
+
+		memset(s, 0, sizeof(*s));
+		s->port = port;
+		s->addr = addr;
+	}
+	i2c_lock(s->port, 0);
+}
+
+static void i2c_stats_clear_dropped(void)
+{
+	interrupt_disable();
+	dropped = 0;
+	interrupt_enable();
+}
+
+static enum ec_status i2c_command_stats(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_i2c_stats *p = args->params;
+	struct ec_response_i2c_stats *r = args->response;
+	struct ec_i2c_stats_entry *e;
+	struct i2c_stats s;
+	int total = stats_count;
+	int max, i;
+
+	if (p->offset > total)
+		return EC_RES_INVALID_PARAM;
+
+	max = (args->response_max - sizeof(*r)) / sizeof(r->entries[0]);
+	r->window_ms = (get_time().val - window_start.val) / MSEC;
+	r->dropped = dropped;
+	r->total = total;
+	r->count = MIN(total - p->offset, max);
+	r->reserved = 0;
+
+	for (i = 0; i < r->count; i++) {
+		i2c_stats_read(&stats[p->offset + i], &s,
+			       p->flags & EC_I2C_STATS_FLAG_CLEAR);
+		e = &r->entries[i];
+		memset(e, 0, sizeof(*e));
+		e->port = s.port;
+		e->addr = s.addr;
+		e->xfers = s.xfers;
+		e->errors = s.errors;
+		e->timeouts = s.timeouts;
+		e->retries = s.retries;
+		e->bytes = s.bytes;
+		e->max_us = s.max_us;
+		e->total_us = s.total_us;
+		memcpy(e->hist, s.hist, sizeof(e->hist));
+	}
+
+	/*
+	 * A clearing read starts a new window at the first page, and clears
+	 * dropped once the last page has reported it.
+	 */
+	if (p->flags & EC_I2C_STATS_FLAG_CLEAR) {
+		if (!p->offset)
+			window_start = get_time();
+		if (p->offset + r->count >= total)
+			i2c_stats_clear_dropped();
+	}
+
+	args->response_size = sizeof(*r) + r->count * sizeof(r->entries[0]);
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_I2C_STATS,
+		     i2c_command_stats,
+		     EC_VER_MASK(0));
+
+static int command_i2cstats(int argc, char **argv)
+{
+	uint64_t window = get_time().val - window_start.val;
+	struct i2c_stats *s;
+	int i;
+
+	if (argc > 1) {
+		if (strcasecmp(argv[1], "clear"))
+			return EC_ERROR_PARAM1;
+		for (i = 0; i < stats_count; i++)
+			i2c_stats_read(&stats[i], NULL, 1);
+		window_start = get_time();
+		i2c_stats_clear_dropped();
+		return EC_SUCCESS;
+	}
+
+	ccprintf("port addr   xfers  errs tmout retry    bytes  max_us"
+		 "  busy\n");
+	for (i = 0; i < stats_count; i++) {
+		s = &stats[i];
+		ccprintf("%4d 0x%02x %7d %5d %5d %5d %8d %7d %3d.%d%%\n",
+			 s->port, s->addr, s->xfers, s->errors, s->timeouts,
+			 s->retries, s->bytes, s->max_us,
+			 (int)(s->total_us * 100 / MAX(window, 1)),
+			 (int)(s->total_us * 1000 / MAX(window, 1) % 10));
+		cflush();
+	}
+	if (dropped)
+		ccprintf("%d transfers to untracked devices\n", dropped);
+
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(i2cstats, command_i2cstats, "[clear]",
+			"Show or clear I2C bus statistics");
@@ -0,0 +1,102 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Binary ring buffer of I2C transfers, read out over host command */
+
+#include "common.h"
+#include "console.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "task.h"
+#include "util.h"
+
+#define TRACE_MASK (CONFIG_I2C_TRACE_BUFFER_SIZE - 1)
+BUILD_ASSERT(POWER_OF_TWO(CONFIG_I2C_TRACE_BUFFER_SIZE));
+BUILD_ASSERT(sizeof(struct ec_i2c_trace_record) == 16);
+
+static struct ec_i2c_trace_record trace[CONFIG_I2C_TRACE_BUFFER_SIZE];
+
+/* Sequence number of the next transfer; its slot is head & TRACE_MASK */
+static uint32_t head;
+
+void i2c_trace_buffer_record(int port, uint16_t slave_addr_flags,
+			     const uint8_t *out_data, int out_size,
+			     const uint8_t *in_data, int in_size,
+			     int flags, int rv, uint32_t start, uint32_t us)
+{
+	struct ec_i2c_trace_record r;
+	int n;
+
+	r.timestamp = start;
+	r.duration_us = MIN(us, UINT16_MAX);
+	r.port = port;
+	r.addr = I2C_GET_ADDR(slave_addr_flags);
+	r.out_size = MIN(out_size, UINT8_MAX);
+	r.in_size = MIN(in_size, UINT8_MAX);
+	r.status = MIN(rv, UINT8_MAX);
+	r.flags = flags;
+
+	n = MIN(out_size, EC_I2C_TRACE_DATA_SIZE);
+	memcpy(r.data, out_data, n);
+	if (rv == EC_SUCCESS && in_size) {
+		memcpy(r.data + n, in_data,
+		       MIN(in_size, EC_I2C_TRACE_DATA_SIZE - n));
+		n += MIN(in_size, EC_I2C_TRACE_DATA_SIZE - n);
+	}
+	memset(r.data + n, 0, EC_I2C_TRACE_DATA_SIZE - n);
+
+	/*
+	 * Store the record and advance head together, so that a reader never
+	 * sees a slot at or before head which has not been filled in.
+	 */
+	interrupt_disable();
+	trace[head++ & TRACE_MASK] = r;
+	interrupt_enable();
+}
+
+static enum ec_status i2c_command_trace(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_i2c_trace *p = args->params;
+	struct ec_response_i2c_trace *r = args->response;
+	uint32_t end = head;
+	uint32_t seq = p->seq;
+	int max, count, i, lost;
+
+	/*
+	 * Start at the oldest record still held if the host fell behind, or
+	 * if it asks for the future, as it does after an EC reboot.
+	 */
+	if (end - seq > CONFIG_I2C_TRACE_BUFFER_SIZE)
+		seq = end - MIN(end, CONFIG_I2C_TRACE_BUFFER_SIZE);
+
+	max = (args->response_max - sizeof(*r)) / sizeof(r->records[0]);
+	max = MIN(max, UINT8_MAX);
+
+	r->seq = seq;
+	r->head = end;
+	count = MIN(end - seq, max);
+	memset(r->reserved, 0, sizeof(r->reserved));
+
+	/*
+	 * Stop at a record which new transfers have overwritten since head
+	 * was sampled; the next call will skip ahead past it.
+	 */
+	for (i = 0; i < count; i++) {
+		interrupt_disable();
+		lost = head - (seq + i) > CONFIG_I2C_TRACE_BUFFER_SIZE;
+		if (!lost)
+			r->records[i] = trace[(seq + i) & TRACE_MASK];
+		interrupt_enable();
+		if (lost)
+			break;
+	}
+	r->count = i;
+
+	args->response_size = sizeof(*r) + r->count * sizeof(r->records[0]);
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_I2C_TRACE,
+		     i2c_command_trace,
+		     EC_VER_MASK(0));
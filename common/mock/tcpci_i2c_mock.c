@@ -68,6 +68,7 @@ static uint8_t tx_buffer[BUFFER_SIZE];
 static int tx_pos = -1;
 static uint8_t rx_buffer[BUFFER_SIZE];
 static int rx_pos = -1;
+static int xfer_count;
 
 static const char * const ctrl_msg_name[] = {
 	[0]                      = "RSVD-C0",
@@ -232,6 +233,7 @@ void mock_tcpci_reset(void)
 
 	for (i = 0; i < ARRAY_SIZE(tcpci_regs); i++)
 		tcpci_regs[i].value = 0;
+	xfer_count = 0;
 }
 
 void mock_tcpci_set_reg(int reg_offset, uint16_t value)
@@ -247,6 +249,11 @@ uint16_t mock_tcpci_get_reg(int reg_offset)
 	return tcpci_regs[reg_offset].value;
 }
 
+int mock_tcpci_get_xfer_count(void)
+{
+	return xfer_count;
+}
+
 int tcpci_i2c_xfer(int port, uint16_t slave_addr_flags,
 		const uint8_t *out, int out_size,
 		uint8_t *in, int in_size, int flags)
@@ -261,6 +268,7 @@ int tcpci_i2c_xfer(int port, uint16_t slave_addr_flags,
 		ccprints("ERROR: wrong I2C address 0x%x", slave_addr_flags);
 		return EC_ERROR_UNKNOWN;
 	}
+	xfer_count++;
 
 	if (rx_pos > 0) {
 		if (rx_pos + in_size > rx_buffer[0] + 1) {
@@ -322,16 +330,25 @@ int tcpci_i2c_xfer(int port, uint16_t slave_addr_flags,
 		memcpy(in, rx_buffer, in_size);
 		rx_pos += in_size;
 	} else if (out_size == 1) {
-		if (in_size != reg->size) {
-			ccprints("ERROR: %s in_size %d != %d", reg->name,
-				 in_size, reg->size);
-			return EC_ERROR_UNKNOWN;
-		}
-		if (reg->size == 1)
-			in[0] = reg->value;
-		else if (reg->size == 2) {
+		/* Reads may run on into the following registers */
+		while (in_size > 0) {
+			if (reg >= tcpci_regs + ARRAY_SIZE(tcpci_regs) ||
+			    reg->size == 0) {
+				ccprints("ERROR: read into unknown reg 0x%x",
+					 (int)(reg - tcpci_regs));
+				return EC_ERROR_UNKNOWN;
+			}
+			if (reg->size > 2 || in_size < reg->size) {
+				ccprints("ERROR: %s in_size %d", reg->name,
+					 in_size);
+				return EC_ERROR_UNKNOWN;
+			}
 			in[0] = reg->value;
-			in[1] = reg->value >> 8;
+			if (reg->size == 2)
+				in[1] = reg->value >> 8;
+			in += reg->size;
+			in_size -= reg->size;
+			reg += reg->size;
 		}
 	} else {
 		uint16_t value = 0;
@@ -58,15 +58,88 @@ static int hexdigit(int c)
 #define PF_64BIT	BIT(3)  /* Number is 64-bit */
 #endif
 
+/* Output sink for vfnprintf() and vfnprintf_str() */
+struct printf_output {
+	int (*addchar)(void *context, int c);
+	int (*addstr)(void *context, const char *str, int len);
+	void *context;
+};
+
+/*
+ * Send a single character to the output.
+ * Returns 0 if the character was accepted, non-zero if it was dropped.
+ */
+static int out_char(const struct printf_output *out, int c)
+{
+	char ch = c;
+
+	if (out->addchar)
+		return out->addchar(out->context, c);
+
+	return out->addstr(out->context, &ch, 1);
+}
+
+/*
+ * Send len characters of str to the output, in a single call if the output
+ * supports it.
+ * Returns 0 if all characters were accepted, non-zero if any were dropped.
+ */
+static int out_str(const struct printf_output *out, const char *str, int len)
+{
+	if (len <= 0)
+		return 0;
+
+	if (out->addstr)
+		return out->addstr(out->context, str, len);
+
+	while (len--) {
+		if (out->addchar(out->context, *str++))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Send len copies of the padding character c to the output.
+ * Returns 0 if all characters were accepted, non-zero if any were dropped.
+ */
+static int out_pad(const struct printf_output *out, int c, int len)
+{
+	static const char spaces[] = "                ";
+	static const char zeros[] = "0000000000000000";
+	const char *pad = c == '0' ? zeros : spaces;
+
+	if (!out->addstr) {
+		while (len-- > 0) {
+			if (out->addchar(out->context, c))
+				return 1;
+		}
+		return 0;
+	}
+
+	while (len > 0) {
+		int n = MIN(len, (int)sizeof(spaces) - 1);
+
+		if (out->addstr(out->context, pad, n))
+			return 1;
+		len -= n;
+	}
+
+	return 0;
+}
+
 /*
  * Print the buffer as a string of bytes in hex.
  * Returns 0 on success or an error on failure.
  */
-static int print_hex_buffer(int (*addchar)(void *context, int c),
-			    void *context, const char *vstr, int precision,
+static int print_hex_buffer(const struct printf_output *out,
+			    const char *vstr, int precision,
 			    int pad_width, int flags)
 
 {
+	char hex[16];
+	int n;
 
 	/*
 	 * Divide pad_width instead of multiplying precision to avoid overflow
@@ -79,29 +152,29 @@ static int print_hex_buffer(int (*addchar)(void *context, int c),
 	else
 		pad_width = 0;
 
-	while (pad_width > 0 && !(flags & PF_LEFT)) {
-		if (addchar(context, flags & PF_PADZERO ? '0' : ' '))
-			return EC_ERROR_OVERFLOW;
-		pad_width--;
-	}
+	if (!(flags & PF_LEFT) &&
+	    out_pad(out, flags & PF_PADZERO ? '0' : ' ', pad_width))
+		return EC_ERROR_OVERFLOW;
 
-	for (; precision; precision--, vstr++) {
-		if (addchar(context, hexdigit(*vstr >> 4)) ||
-		    addchar(context, hexdigit(*vstr)))
+	/* Convert the buffer a chunk at a time */
+	while (precision) {
+		for (n = 0; n < (int)sizeof(hex) && precision;
+		     precision--, vstr++) {
+			hex[n++] = hexdigit(*vstr >> 4);
+			hex[n++] = hexdigit(*vstr);
+		}
+		if (out_str(out, hex, n))
 			return EC_ERROR_OVERFLOW;
 	}
 
-	while (pad_width > 0 && (flags & PF_LEFT)) {
-		if (addchar(context, ' '))
-			return EC_ERROR_OVERFLOW;
-		pad_width--;
-	}
+	if ((flags & PF_LEFT) && out_pad(out, ' ', pad_width))
+		return EC_ERROR_OVERFLOW;
 
 	return EC_SUCCESS;
 }
 
-int vfnprintf(int (*addchar)(void *context, int c), void *context,
-	      const char *format, va_list args)
+static int vfnprintf_common(const struct printf_output *out,
+			    const char *format, va_list args)
 {
 	/*
 	 * Longest uint64 in decimal = 20
@@ -120,9 +193,13 @@ int vfnprintf(int (*addchar)(void *context, int c), void *context,
 		int c = *format++;
 		char sign = 0;
 
-		/* Copy normal characters */
+		/* Copy runs of normal characters in one go */
 		if (c != '%') {
-			if (addchar(context, c))
+			const char *run = format - 1;
+
+			while (*format && *format != '%')
+				format++;
+			if (out_str(out, run, format - run))
 				return EC_ERROR_OVERFLOW;
 			continue;
 		}
@@ -135,7 +212,7 @@ int vfnprintf(int (*addchar)(void *context, int c), void *context,
 
 		/* Send "%" for "%%" input */
 		if (c == '%' || c == '\0') {
-			if (addchar(context, '%'))
+			if (out_char(out, '%'))
 				return EC_ERROR_OVERFLOW;
 
 			if (c == '\0')
@@ -147,7 +224,7 @@ int vfnprintf(int (*addchar)(void *context, int c), void *context,
 		/* Handle %c */
 		if (c == 'c') {
 			c = va_arg(args, int);
-			if (addchar(context, c))
+			if (out_char(out, c))
 				return EC_ERROR_OVERFLOW;
 			continue;
 		}
@@ -296,8 +373,7 @@ int vfnprintf(int (*addchar)(void *context, int c), void *context,
 						ptrval;
 					int rc;
 
-					rc = print_hex_buffer(addchar,
-							      context,
+					rc = print_hex_buffer(out,
 							      hexbuf->buffer,
 							      hexbuf->size,
 							      0,
@@ -442,25 +518,44 @@ int vfnprintf(int (*addchar)(void *context, int c), void *context,
 		}
 
 
-		while (vlen < pad_width && !(flags & PF_LEFT)) {
-			if (addchar(context, flags & PF_PADZERO ? '0' : ' '))
-				return EC_ERROR_OVERFLOW;
-			vlen++;
-		}
-		while (--precision >= 0 && *vstr)
-			if (addchar(context, *vstr++))
-				return EC_ERROR_OVERFLOW;
-		while (vlen < pad_width && flags & PF_LEFT) {
-			if (addchar(context, ' '))
-				return EC_ERROR_OVERFLOW;
-			vlen++;
-		}
+		/* Only the first vlen characters of vstr are printed */
+		pad_width -= vlen;
+
+		if (!(flags & PF_LEFT) &&
+		    out_pad(out, flags & PF_PADZERO ? '0' : ' ', pad_width))
+			return EC_ERROR_OVERFLOW;
+		if (out_str(out, vstr, vlen))
+			return EC_ERROR_OVERFLOW;
+		if ((flags & PF_LEFT) && out_pad(out, ' ', pad_width))
+			return EC_ERROR_OVERFLOW;
 	}
 
 	/* If we're still here, we consumed all output */
 	return EC_SUCCESS;
 }
 
+int vfnprintf(int (*addchar)(void *context, int c), void *context,
+	      const char *format, va_list args)
+{
+	const struct printf_output out = {
+		.addchar = addchar,
+		.context = context,
+	};
+
+	return vfnprintf_common(&out, format, args);
+}
+
+int vfnprintf_str(int (*addstr)(void *context, const char *str, int len),
+		  void *context, const char *format, va_list args)
+{
+	const struct printf_output out = {
+		.addstr = addstr,
+		.context = context,
+	};
+
+	return vfnprintf_common(&out, format, args);
+}
+
 /* Context for snprintf() */
 struct snprintf_context {
 	char *str;
@@ -468,22 +563,23 @@ struct snprintf_context {
 };
 
 /**
- * Add a character to the string context.
+ * Add a string to the string context.
  *
- * @param context	Context receiving character
- * @param c		Character to add
- * @return 0 if character added, 1 if character dropped because no space.
+ * @param context	Context receiving the string
+ * @param str		Characters to add
+ * @param len		Number of characters to add
+ * @return 0 if all characters added, 1 if any were dropped because no space.
  */
-static int snprintf_addchar(void *context, int c)
+static int snprintf_addstr(void *context, const char *str, int len)
 {
 	struct snprintf_context *ctx = (struct snprintf_context *)context;
+	int n = MIN(len, ctx->size);
 
-	if (!ctx->size)
-		return 1;
+	memcpy(ctx->str, str, n);
+	ctx->str += n;
+	ctx->size -= n;
 
-	*(ctx->str++) = c;
-	ctx->size--;
-	return 0;
+	return n != len;
 }
 
 int snprintf(char *str, int size, const char *format, ...)
@@ -509,7 +605,7 @@ int vsnprintf(char *str, int size, const char *format, va_list args)
 	ctx.str = str;
 	ctx.size = size - 1;  /* Reserve space for terminating '\0' */
 
-	rv = vfnprintf(snprintf_addchar, &ctx, format, args);
+	rv = vfnprintf_str(snprintf_addstr, &ctx, format, args);
 
 	/* Terminate string */
 	*ctx.str = '\0';
@@ -104,6 +104,97 @@ struct queue_chunk queue_get_read_chunk(struct queue const *q)
 	});
 }
 
+/*
+ * Describe up to count units starting at the (unwrapped) queue index start,
+ * of which available are usable, as at most two contiguous chunks.
+ */
+static size_t queue_fill_iovec(struct queue const *q, struct queue_iovec *iov,
+			       size_t start, size_t available, size_t count)
+{
+	size_t index = start & q->buffer_units_mask;
+	size_t total = MIN(count, available);
+	size_t first = MIN(total, q->buffer_units - index);
+
+	iov->chunk[0].count = first;
+	iov->chunk[0].buffer = first ? q->buffer + index * q->unit_bytes : NULL;
+	iov->chunk[1].count = total - first;
+	iov->chunk[1].buffer = total > first ? q->buffer : NULL;
+	iov->count = total;
+
+	return total;
+}
+
+size_t queue_get_write_iovec(struct queue const *q, struct queue_iovec *iov,
+			     size_t count)
+{
+	size_t head = q->state->head;
+	size_t tail = q->state->tail;
+
+	return queue_fill_iovec(q, iov, tail,
+				q->buffer_units - (tail - head), count);
+}
+
+size_t queue_get_read_iovec(struct queue const *q, struct queue_iovec *iov,
+			    size_t count)
+{
+	size_t head = q->state->head;
+	size_t tail = q->state->tail;
+
+	return queue_fill_iovec(q, iov, head, tail - head, count);
+}
+
+size_t queue_spsc_add_units(struct queue const *q, const void *src,
+			    size_t count)
+{
+	/* Only the producer moves the tail */
+	size_t tail = q->state->tail;
+	size_t head = __atomic_load_n(&q->state->head, __ATOMIC_ACQUIRE);
+	struct queue_iovec iov;
+	size_t first;
+
+	queue_fill_iovec(q, &iov, tail, q->buffer_units - (tail - head), count);
+	if (!iov.count)
+		return 0;
+
+	first = iov.chunk[0].count * q->unit_bytes;
+	memcpy(iov.chunk[0].buffer, src, first);
+	if (iov.chunk[1].count)
+		memcpy(iov.chunk[1].buffer, (const uint8_t *)src + first,
+		       iov.chunk[1].count * q->unit_bytes);
+
+	__atomic_store_n(&q->state->tail, tail + iov.count, __ATOMIC_RELEASE);
+
+	q->policy->add(q->policy, iov.count);
+
+	return iov.count;
+}
+
+size_t queue_spsc_remove_units(struct queue const *q, void *dest,
+			       size_t count)
+{
+	/* Only the consumer moves the head */
+	size_t head = q->state->head;
+	size_t tail = __atomic_load_n(&q->state->tail, __ATOMIC_ACQUIRE);
+	struct queue_iovec iov;
+	size_t first;
+
+	queue_fill_iovec(q, &iov, head, tail - head, count);
+	if (!iov.count)
+		return 0;
+
+	first = iov.chunk[0].count * q->unit_bytes;
+	memcpy(dest, iov.chunk[0].buffer, first);
+	if (iov.chunk[1].count)
+		memcpy((uint8_t *)dest + first, iov.chunk[1].buffer,
+		       iov.chunk[1].count * q->unit_bytes);
+
+	__atomic_store_n(&q->state->head, head + iov.count, __ATOMIC_RELEASE);
+
+	q->policy->remove(q->policy, iov.count);
+
+	return iov.count;
+}
+
 size_t queue_advance_head(struct queue const *q, size_t count)
 {
 	size_t transfer = MIN(count, queue_count(q));
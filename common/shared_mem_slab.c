@@ -0,0 +1,179 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Size-class slab pools for Chrome EC.
+ *
+ * Hot fixed-size buffers (hash chunks, packet buffers) are served from small
+ * static pools, one per size class, so they never wait on or fragment the
+ * shared memory allocator.  Each class tracks its buffers in a bitmap, which
+ * makes acquiring and releasing a buffer constant time.
+ *
+ * Acquiring takes slab_lock, so it is limited to tasks.  Releasing only clears
+ * bits atomically and takes no lock, so it also works from interrupts; for
+ * that reason acquire sets bits atomically as well.
+ */
+
+#include "atomic.h"
+#include "common.h"
+#include "console.h"
+#include "shared_mem.h"
+#include "task.h"
+#include "util.h"
+
+/* Slab buffers keep word alignment */
+#define SLAB_SIZE(size) (((size) + 3) & ~3)
+
+struct slab_class {
+	uint16_t size;
+	uint8_t count;
+};
+
+#define SHARED_MEM_SLAB(size, count) { SLAB_SIZE(size), count },
+static const struct slab_class slab_class[] = { CONFIG_SHARED_MEM_SLABS };
+#undef SHARED_MEM_SLAB
+
+#define SHARED_MEM_SLAB(size, count) \
+	BUILD_ASSERT((count) > 0 && (count) <= 32);
+CONFIG_SHARED_MEM_SLABS
+#undef SHARED_MEM_SLAB
+
+#define SHARED_MEM_SLAB(size, count) + SLAB_SIZE(size) * (count)
+static uint8_t slab_storage[0 CONFIG_SHARED_MEM_SLABS] __aligned(8);
+#undef SHARED_MEM_SLAB
+
+struct slab_state {
+	uint32_t used;		/* Bitmap of acquired buffers */
+	uint32_t in_use;
+	uint32_t peak;
+	uint32_t acquired;
+	uint32_t fallbacks;
+};
+
+static struct slab_state slab_state[ARRAY_SIZE(slab_class)];
+static struct mutex slab_lock;
+
+/* Return the start of the buffers of a slab class */
+static uint8_t *slab_base(int class)
+{
+	uint8_t *base = slab_storage;
+	int i;
+
+	for (i = 0; i < class; i++)
+		base += slab_class[i].size * slab_class[i].count;
+
+	return base;
+}
+
+int shared_mem_slab_acquire(int size, char **dest_ptr)
+{
+	struct slab_state *st;
+	uint32_t avail;
+	int class, b;
+
+	*dest_ptr = NULL;
+
+	if (in_interrupt_context())
+		return EC_ERROR_INVAL;
+
+	/* Smallest class that fits */
+	for (class = 0; class < ARRAY_SIZE(slab_class); class++)
+		if (size <= slab_class[class].size)
+			break;
+	if (class == ARRAY_SIZE(slab_class))
+		return shared_mem_acquire(size, dest_ptr);
+
+	st = slab_state + class;
+
+	mutex_lock(&slab_lock);
+	avail = ~st->used;
+	if (slab_class[class].count < 32)
+		avail &= BIT(slab_class[class].count) - 1;
+	if (!avail) {
+		st->fallbacks++;
+		mutex_unlock(&slab_lock);
+		return shared_mem_acquire(size, dest_ptr);
+	}
+	b = __fls(avail);
+	deprecated_atomic_or(&st->used, BIT(b));
+	deprecated_atomic_add(&st->in_use, 1);
+	st->acquired++;
+	if (st->in_use > st->peak)
+		st->peak = st->in_use;
+	mutex_unlock(&slab_lock);
+
+	*dest_ptr = (char *)slab_base(class) + b * slab_class[class].size;
+	return EC_SUCCESS;
+}
+
+void shared_mem_slab_release(void *ptr)
+{
+	uint8_t *p = ptr;
+	uint8_t *base = slab_storage;
+	struct slab_state *st;
+	int class, b;
+
+	if (p < slab_storage || p >= slab_storage + sizeof(slab_storage)) {
+		shared_mem_release(ptr);
+		return;
+	}
+
+	for (class = 0; class < ARRAY_SIZE(slab_class) - 1; class++) {
+		uint8_t *end = base + slab_class[class].size *
+			slab_class[class].count;
+
+		if (p < end)
+			break;
+		base = end;
+	}
+
+	st = slab_state + class;
+	b = (p - base) / slab_class[class].size;
+
+	/* Drop the count first so that in_use never exceeds the class size */
+	if (st->used & BIT(b)) {
+		deprecated_atomic_sub(&st->in_use, 1);
+		deprecated_atomic_clear_bits(&st->used, BIT(b));
+	}
+}
+
+int shared_mem_slab_get_stats(int class, struct shared_mem_slab_stats *stats)
+{
+	const struct slab_state *st;
+
+	if (class < 0 || class >= ARRAY_SIZE(slab_class))
+		return EC_ERROR_INVAL;
+
+	st = &slab_state[class];
+	stats->size = slab_class[class].size;
+	stats->count = slab_class[class].count;
+	stats->in_use = st->in_use;
+	stats->peak = st->peak;
+	stats->acquired = st->acquired;
+	stats->fallbacks = st->fallbacks;
+
+	return EC_SUCCESS;
+}
+
+#ifdef CONFIG_CMD_SHMEM
+static int command_shmslab(int argc, char **argv)
+{
+	struct shared_mem_slab_stats stats;
+	int class;
+
+	ccprintf("size count in_use peak   acquired  fallbacks\n");
+	for (class = 0;
+	     shared_mem_slab_get_stats(class, &stats) == EC_SUCCESS;
+	     class++)
+		ccprintf("%4d %5d %6d %4d %10u %10u\n", stats.size,
+			 stats.count, stats.in_use, stats.peak,
+			 stats.acquired, stats.fallbacks);
+
+	return EC_SUCCESS;
+}
+DECLARE_SAFE_CONSOLE_COMMAND(shmslab, command_shmslab,
+			     NULL,
+			     "Print shared memory slab stats");
+#endif
@@ -11,12 +11,18 @@
 #include <stdlib.h>
 #endif
 
+#ifdef EMU_BUILD
+/* Benchmarks read the host clock, see test_get_bench_time(). */
+#include <time.h>
+#endif
+
 #include "console.h"
 #include "hooks.h"
 #include "host_command.h"
 #include "system.h"
 #include "task.h"
 #include "test_util.h"
+#include "timer.h"
 #include "util.h"
 
 struct test_util_tag {
@@ -173,6 +179,18 @@ uint32_t prng_no_seed(void)
 	return seed = prng(seed);
 }
 
+uint64_t test_get_bench_time(void)
+{
+#ifdef EMU_BUILD
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * SECOND + ts.tv_nsec / 1000;
+#else
+	return get_time().val;
+#endif
+}
+
 static void restore_state(void)
 {
 	const struct test_util_tag *tag;
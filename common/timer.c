@@ -14,6 +14,7 @@
 #include "util.h"
 #include "task.h"
 #include "timer.h"
+#include "timer_queue.h"
 #include "watchdog.h"
 
 #ifdef CONFIG_ZEPHYR
@@ -31,10 +32,21 @@ STATIC_IF_NOT(CONFIG_HWTIMER_64BIT) uint32_t clksrc_high;
 /* Bitmap of currently running timers */
 static uint32_t timer_running;
 
+/* Bitmap of timers armed since process_timers() last ran */
+static uint32_t timer_armed;
+
 /* Deadlines of all timers */
 static timestamp_t timer_deadline[TASK_ID_COUNT];
 static uint32_t next_deadline = 0xffffffff;
 
+/*
+ * Timers sorted by deadline.  Only process_timers() touches the queue, so it
+ * needs no locking: timer_arm() just flags the timer in timer_armed and
+ * timer_cancel() just clears its running bit, and the queue catches up the
+ * next time the timer interrupt fires.
+ */
+static struct timer_queue timer_queue;
+
 /* Hardware timer routine IRQ number */
 static int timer_irq;
 
@@ -60,46 +72,40 @@ int timestamp_expired(timestamp_t deadline, const timestamp_t *now)
 
 void process_timers(int overflow)
 {
-	uint32_t check_timer, running_t0;
+	uint32_t armed;
 	timestamp_t next;
 	timestamp_t now;
+	int tskid;
 
 	if (!IS_ENABLED(CONFIG_HWTIMER_64BIT) && overflow)
 		clksrc_high++;
 
 	do {
-		next.val = -1ull;
 		now = get_time();
-		do {
-			/* read atomically the current state of timer running */
-			check_timer = running_t0 = timer_running;
-			while (check_timer) {
-
-				int tskid = __fls(check_timer);
-				/* timer has expired ? */
-				if (timer_deadline[tskid].val <= now.val)
-					expire_timer(tskid);
-				else if ((timer_deadline[tskid].le.hi ==
-					  now.le.hi) &&
-					 (timer_deadline[tskid].le.lo <
-					  next.le.lo))
-					next.val = timer_deadline[tskid].val;
-
-				check_timer &= ~BIT(tskid);
-			}
-		/* if there is a new timer, let's retry */
-		} while (timer_running & ~running_t0);
-
-		if (next.le.hi == 0xffffffff) {
+
+		/* Requeue timers armed since the last pass */
+		while ((armed = deprecated_atomic_read_clear(&timer_armed)))
+			timer_queue_update(&timer_queue, armed, timer_running,
+					   timer_deadline);
+
+		/* Expire timers from the front of the queue */
+		while ((tskid = timer_queue_pop_expired(
+				&timer_queue, timer_running, timer_deadline,
+				now)) >= 0)
+			expire_timer(tskid);
+
+		if (timer_queue_next(&timer_queue, timer_deadline, now,
+				     &next)) {
+			__hw_clock_event_set(next.le.lo);
+			next_deadline = next.le.lo;
+		} else {
 			/* no deadline to set */
 			__hw_clock_event_clear();
 			next_deadline = 0xffffffff;
-			return;
+			next.val = -1ull;
 		}
-
-		__hw_clock_event_set(next.le.lo);
-		next_deadline = next.le.lo;
-	} while (next.val <= get_time().val);
+	/* if there is a new timer or the deadline has passed, let's retry */
+	} while (timer_armed || next.val <= get_time().val);
 }
 
 #ifndef CONFIG_HW_SPECIFIC_UDELAY
@@ -133,6 +139,7 @@ int timer_arm(timestamp_t event, task_id_t tskid)
 
 	timer_deadline[tskid] = event;
 	deprecated_atomic_or(&timer_running, BIT(tskid));
+	deprecated_atomic_or(&timer_armed, BIT(tskid));
 
 	/* Modify the next event if needed */
 	if ((event.le.hi < now.le.hi) ||
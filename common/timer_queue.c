@@ -0,0 +1,81 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Deadline-sorted queue of armed timers */
+
+#include "common.h"
+#include "timer_queue.h"
+#include "util.h"
+
+/* Remove a timer from the queue, if it is there */
+static void timer_queue_remove(struct timer_queue *q, int tskid)
+{
+	int i;
+
+	for (i = 0; i < q->len; i++) {
+		if (q->tskid[i] == tskid) {
+			q->len--;
+			memmove(q->tskid + i, q->tskid + i + 1, q->len - i);
+			return;
+		}
+	}
+}
+
+/* Insert a timer into the queue after any with the same deadline */
+static void timer_queue_insert(struct timer_queue *q, int tskid,
+			       const timestamp_t *deadline)
+{
+	uint64_t val = deadline[tskid].val;
+	int i = q->len;
+
+	while (i > 0 && deadline[q->tskid[i - 1]].val > val) {
+		q->tskid[i] = q->tskid[i - 1];
+		i--;
+	}
+	q->tskid[i] = tskid;
+	q->len++;
+}
+
+void timer_queue_update(struct timer_queue *q, uint32_t armed,
+			uint32_t running, const timestamp_t *deadline)
+{
+	int tskid;
+
+	while (armed) {
+		tskid = __fls(armed);
+		armed &= ~BIT(tskid);
+		timer_queue_remove(q, tskid);
+		if (running & BIT(tskid))
+			timer_queue_insert(q, tskid, deadline);
+	}
+}
+
+int timer_queue_pop_expired(struct timer_queue *q, uint32_t running,
+			    const timestamp_t *deadline, timestamp_t now)
+{
+	int tskid;
+
+	while (q->len) {
+		tskid = q->tskid[0];
+		if ((running & BIT(tskid)) && deadline[tskid].val > now.val)
+			return -1;
+
+		q->len--;
+		memmove(q->tskid, q->tskid + 1, q->len);
+		if (running & BIT(tskid))
+			return tskid;
+	}
+	return -1;
+}
+
+int timer_queue_next(const struct timer_queue *q, const timestamp_t *deadline,
+		     timestamp_t now, timestamp_t *next)
+{
+	if (!q->len || deadline[q->tskid[0]].le.hi != now.le.hi)
+		return 0;
+
+	*next = deadline[q->tskid[0]];
+	return 1;
+}
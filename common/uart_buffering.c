@@ -71,25 +71,20 @@ void uart_init_buffer(void)
 	}
 }
 
+#ifndef CONFIG_POLLING_UART
 /**
  * Put a single character into the transmit buffer.
  *
- * Does not enable the transmit interrupt; assumes that happens elsewhere.
+ * The shared head is advanced for each character, so output from an
+ * interrupt or a higher priority task in the middle of a string is kept.
  *
- * @param context	Context; ignored.
  * @param c		Character to write.
- * @return 0 if the character was transmitted, 1 if it was dropped.
+ * @return 0 if the character was stored, 1 if the buffer is full.
  */
-static int __tx_char_raw(void *context, int c)
+static inline int tx_buf_put(int c)
 {
 	int tx_buf_next, tx_buf_new_tail;
 
-#if defined CONFIG_POLLING_UART
-	(void) tx_buf_next;
-	(void) tx_buf_new_tail;
-	uart_write_char(c);
-#else
-
 	tx_buf_next = TX_BUF_NEXT(tx_buf_head);
 	if (tx_buf_next == tx_buf_tail)
 		return 1;
@@ -112,18 +107,61 @@ static int __tx_char_raw(void *context, int c)
 	tx_buf[tx_buf_head] = c;
 	tx_buf_head = tx_buf_next;
 
+	return 0;
+}
+#endif
+
+/**
+ * Put a string into the transmit buffer.
+ *
+ * Does not enable the transmit interrupt; assumes that happens elsewhere.
+ *
+ * @param context	Context; ignored.
+ * @param str		Characters to write.
+ * @param len		Number of characters to write.
+ * @param crlf		Translate '\n' to '\r\n' if non-zero.
+ * @return 0 if all characters were transmitted, 1 if any were dropped.
+ */
+static int __tx_str(void *context, const char *str, int len, int crlf)
+{
+#if defined CONFIG_POLLING_UART
+	while (len-- > 0) {
+		if (crlf && *str == '\n')
+			uart_write_char('\r');
+		uart_write_char(*str++);
+	}
+	return 0;
+#else
+	int rv = 0;
+
+	while (len-- > 0) {
+		int c = *str++;
+
+		if ((crlf && c == '\n' && tx_buf_put('\r')) ||
+		    tx_buf_put(c)) {
+			rv = 1;
+			break;
+		}
+	}
+
 	if (IS_ENABLED(CONFIG_PRESERVE_LOGS))
 		tx_checksum = uart_buffer_calc_checksum();
+
+	return rv;
 #endif
-	return 0;
 }
 
 static int __tx_char(void *context, int c)
 {
-	/* Translate '\n' to '\r\n' */
-	if (c == '\n' && __tx_char_raw(NULL, '\r'))
-		return 1;
-	return __tx_char_raw(context, c);
+	char ch = c;
+
+	return __tx_str(context, &ch, 1, 1);
+}
+
+/* Output function for vfnprintf_str() */
+static int __tx_printf_str(void *context, const char *str, int len)
+{
+	return __tx_str(context, str, len, 1);
 }
 
 #ifdef CONFIG_UART_TX_DMA
@@ -174,12 +212,33 @@ void uart_process_output(void)
 
 #else /* !CONFIG_UART_TX_DMA */
 
+__overridable int uart_write_buf(const char *src, int len)
+{
+	int sent = 0;
+
+	while (sent < len && uart_tx_ready())
+		uart_write_char(src[sent++]);
+
+	return sent;
+}
+
 void uart_process_output(void)
 {
-	/* Copy output from buffer until TX fifo full or output buffer empty */
-	while (uart_tx_ready() && (tx_buf_head != tx_buf_tail)) {
-		uart_write_char(tx_buf[tx_buf_tail]);
-		tx_buf_tail = TX_BUF_NEXT(tx_buf_tail);
+	/*
+	 * Hand the largest contiguous block of output to the chip until the
+	 * transmitter is full or the output buffer is empty.
+	 */
+	while (tx_buf_head != tx_buf_tail) {
+		int head = tx_buf_head;
+		int len = (head > tx_buf_tail ? head :
+			   CONFIG_UART_TX_BUF_SIZE) - tx_buf_tail;
+		int sent = uart_write_buf((char *)(tx_buf + tx_buf_tail), len);
+
+		if (!sent)
+			break;
+
+		tx_buf_tail = (tx_buf_tail + sent) &
+			(CONFIG_UART_TX_BUF_SIZE - 1);
 
 		if (IS_ENABLED(CONFIG_PRESERVE_LOGS))
 			tx_checksum = uart_buffer_calc_checksum();
@@ -277,48 +336,39 @@ int uart_putc(int c)
 int uart_puts(const char *outstr)
 {
 	/* Put all characters in the output buffer */
-	while (*outstr) {
-		if (__tx_char(NULL, *outstr++) != 0)
-			break;
-	}
+	int rv = __tx_str(NULL, outstr, strlen(outstr), 1);
 
 	uart_tx_start();
 
 	/* Successful if we consumed all output */
-	return *outstr ? EC_ERROR_OVERFLOW : EC_SUCCESS;
+	return rv ? EC_ERROR_OVERFLOW : EC_SUCCESS;
 }
 
 int uart_put(const char *out, int len)
 {
 	/* Put all characters in the output buffer */
-	while (len--) {
-		if (__tx_char(NULL, *out++) != 0)
-			break;
-	}
+	int rv = __tx_str(NULL, out, len, 1);
 
 	uart_tx_start();
 
 	/* Successful if we consumed all output */
-	return len ? EC_ERROR_OVERFLOW : EC_SUCCESS;
+	return rv ? EC_ERROR_OVERFLOW : EC_SUCCESS;
 }
 
 int uart_put_raw(const char *out, int len)
 {
 	/* Put all characters in the output buffer */
-	while (len--) {
-		if (__tx_char_raw(NULL, *out++) != 0)
-			break;
-	}
+	int rv = __tx_str(NULL, out, len, 0);
 
 	uart_tx_start();
 
 	/* Successful if we consumed all output */
-	return len ? EC_ERROR_OVERFLOW : EC_SUCCESS;
+	return rv ? EC_ERROR_OVERFLOW : EC_SUCCESS;
 }
 
 int uart_vprintf(const char *format, va_list args)
 {
-	int rv = vfnprintf(__tx_char, NULL, format, args);
+	int rv = vfnprintf_str(__tx_printf_str, NULL, format, args);
 
 	uart_tx_start();
 
@@ -162,6 +162,52 @@ static int __tx_char(void *context, int c)
 #endif
 }
 
+/*
+ * Copy a string into the Tx queue, expanding '\n' to "\r\n".  The string is
+ * written straight into the free space of the queue and committed once per
+ * pass, rather than one character at a time.
+ */
+static int __tx_str(const char *outstr)
+{
+	struct queue_iovec iov;
+	size_t n, i;
+	uint8_t *dst;
+	int cr_sent = 0;
+
+	while (*outstr) {
+		n = queue_get_write_iovec(&tx_q, &iov, queue_space(&tx_q));
+		if (!n) {
+#ifdef CONFIG_USB_CONSOLE_CRC
+			usleep(500);
+			continue;
+#else
+			return EC_ERROR_OVERFLOW;
+#endif
+		}
+
+		for (i = 0; i < n && *outstr; i++) {
+			dst = i < iov.chunk[0].count ?
+			      (uint8_t *)iov.chunk[0].buffer + i :
+			      (uint8_t *)iov.chunk[1].buffer + i -
+			      iov.chunk[0].count;
+
+			if (*outstr == '\n' && !cr_sent) {
+				*dst = '\r';
+				cr_sent = 1;
+			} else {
+				*dst = *outstr++;
+				cr_sent = 0;
+			}
+#ifdef CONFIG_USB_CONSOLE_CRC
+			crc32_ctx_hash8(&usb_tx_crc_ctx, *dst);
+#endif
+		}
+		queue_advance_tail(&tx_q, i);
+	}
+
+	return EC_SUCCESS;
+}
+
 /*
  * Public USB console implementation below.
  */
@@ -189,11 +235,7 @@ int usb_puts(const char *outstr)
 	if (ret)
 		return ret;
 
-	while (*outstr) {
-		ret = __tx_char(NULL, *outstr++);
-		if (ret)
-			break;
-	}
+	ret = __tx_str(outstr);
 	handle_output();
 
 	return ret;
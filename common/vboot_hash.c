@@ -33,11 +33,18 @@ struct vboot_hash_tag {
 #define VBOOT_HASH_SYSJUMP_TAG 0x5648 /* "VH" */
 #define VBOOT_HASH_SYSJUMP_VERSION 1
 
-#define CHUNK_SIZE 1024       /* Bytes to hash per deferred call */
-#define WORK_INTERVAL_US 100  /* Delay between deferred calls */
+#define CHUNK_SIZE CONFIG_VBOOT_HASH_CHUNK_SIZE /* Bytes per flash read */
+#define STEP_SIZE (CHUNK_SIZE * CONFIG_VBOOT_HASH_CHUNKS_PER_STEP)
+#define WORK_INTERVAL_US CONFIG_VBOOT_HASH_STEP_INTERVAL_US
 
-/* Check that CHUNK_SIZE fits in shared memory. */
-SHARED_MEM_CHECK_SIZE(CHUNK_SIZE);
+#ifdef CONFIG_VBOOT_HASH_PIPELINE
+#define CHUNK_BUFFERS 2
+#else
+#define CHUNK_BUFFERS 1
+#endif
+
+/* Check that the chunk buffers fit in shared memory. */
+SHARED_MEM_CHECK_SIZE(CHUNK_SIZE * CHUNK_BUFFERS);
 
 static uint32_t data_offset;
 static uint32_t data_size;
@@ -50,6 +57,40 @@ static int in_progress;
 
 static struct sha256_ctx ctx;
 
+/* Time taken by the last hash, and how much of it was spent on flash reads */
+static timestamp_t hash_start_time;
+static uint32_t hash_time_us;
+static uint32_t flash_wait_us;
+
+#ifdef CONFIG_VBOOT_HASH_CACHE
+#define CACHE_BLOCK_SIZE CONFIG_VBOOT_HASH_CACHE_BLOCK_SIZE
+#define CACHE_BLOCKS (CONFIG_RW_SIZE / CACHE_BLOCK_SIZE)
+
+/* States are only saved with no partial SHA-256 block pending */
+BUILD_ASSERT(CACHE_BLOCK_SIZE % SHA256_BLOCK_SIZE == 0);
+
+/*
+ * SHA-256 state at the block boundaries of the last region hashed without a
+ * nonce.  state[i] is the state after the first i + 1 blocks, and the first
+ * valid entries are usable.  A flash write only drops the entries from the
+ * first block it touches, so the next hash of the region resumes there.
+ */
+static struct {
+	uint32_t offset;
+	uint32_t size;
+	int valid;
+	uint32_t state[CACHE_BLOCKS][8];
+} cache;
+
+/* Bumped by every write to the cached region */
+static int cache_gen;
+/* cache_gen when the current hash started, and whether it saves states */
+static int hash_gen;
+static bool hash_caching;
+/* Bytes of the region fed to the hash so far */
+static uint32_t hash_pos;
+#endif
+
 int vboot_hash_in_progress(void)
 {
 	return in_progress;
@@ -73,34 +114,172 @@ void vboot_hash_abort(void)
 static void vboot_hash_next_chunk(void);
 DECLARE_DEFERRED(vboot_hash_next_chunk);
 
+#ifdef CONFIG_VBOOT_HASH_CACHE
+static void cache_save(int block)
+{
+	interrupt_disable();
+	if (hash_gen == cache_gen && block < CACHE_BLOCKS &&
+	    block <= cache.valid) {
+		memcpy(cache.state[block], ctx.h, sizeof(ctx.h));
+		if (block == cache.valid)
+			cache.valid++;
+	}
+	interrupt_enable();
+}
+
+void vboot_hash_cache_invalidate(int offset, int size)
+{
+	int block;
+
+	if (!cache.size || offset + size <= cache.offset ||
+	    offset >= cache.offset + cache.size)
+		return;
+
+	block = offset <= cache.offset ? 0 :
+		(offset - cache.offset) / CACHE_BLOCK_SIZE;
+
+	interrupt_disable();
+	cache.valid = MIN(cache.valid, block);
+	cache_gen++;
+	interrupt_enable();
+}
+
+/*
+ * Set up caching for a new hash of offset/size, resuming from the last valid
+ * state if the region was hashed before.
+ */
+static void cache_start(uint32_t offset, uint32_t size, int nonce_size)
+{
+	int resume;
+
+	hash_pos = 0;
+	hash_gen = cache_gen;
+	hash_caching = !nonce_size;
+	if (!hash_caching)
+		return;
+
+	if (cache.offset != offset || cache.size != size) {
+		cache.offset = offset;
+		cache.size = size;
+		cache.valid = 0;
+	}
+
+	resume = cache.valid;
+	if (!resume)
+		return;
+
+	memcpy(ctx.h, cache.state[resume - 1], sizeof(ctx.h));
+	ctx.tot_len = resume * CACHE_BLOCK_SIZE;
+	ctx.len = 0;
+	hash_pos = curr_pos = resume * CACHE_BLOCK_SIZE;
+	CPRINTS("hash resume at 0x%08x", offset + curr_pos);
+}
+#endif
+
+/* Feed the next data of the region to the hash. */
+static void hash_update(const uint8_t *data, int len)
+{
+#ifdef CONFIG_VBOOT_HASH_CACHE
+	while (len) {
+		int n = MIN(len,
+			    CACHE_BLOCK_SIZE - hash_pos % CACHE_BLOCK_SIZE);
+
+		SHA256_update(&ctx, data, n);
+		data += n;
+		len -= n;
+		hash_pos += n;
+		if (hash_caching && !(hash_pos % CACHE_BLOCK_SIZE))
+			cache_save(hash_pos / CACHE_BLOCK_SIZE - 1);
+	}
+#else
+	SHA256_update(&ctx, data, len);
+#endif
+}
+
 #ifndef CONFIG_MAPPED_STORAGE
 
-static int read_and_hash_chunk(int offset, int size)
+#ifdef CONFIG_VBOOT_HASH_PIPELINE
+/* Wait for the chunk being read, accounting the time spent blocked. */
+static int wait_for_chunk(void)
+{
+	timestamp_t t0 = get_time();
+	int rv = flash_read_wait();
+
+	flash_wait_us += time_since32(t0);
+	return rv;
+}
+#endif
+
+/*
+ * Read and hash size bytes at offset, one chunk at a time.  With
+ * CONFIG_VBOOT_HASH_PIPELINE the read of the next chunk is started before the
+ * current one is hashed, alternating between two buffers.
+ */
+static int read_and_hash_chunks(int offset, int size)
 {
+	const int stride = MIN(size, CHUNK_SIZE);
 	char *buf;
-	int rv;
+	int rv, len;
 
 	if (size == 0)
 		return EC_SUCCESS;
 
-	rv = shared_mem_acquire(size, &buf);
+	rv = shared_mem_slab_acquire(stride * CHUNK_BUFFERS, &buf);
 	if (rv == EC_ERROR_BUSY) {
 		/* Couldn't update hash right now; try again later */
-		hook_call_deferred(&vboot_hash_next_chunk_data,
-				   WORK_INTERVAL_US);
 		return rv;
 	} else if (rv != EC_SUCCESS) {
 		vboot_hash_abort();
 		return rv;
 	}
 
-	rv = flash_read(offset, size, buf);
-	if (rv == EC_SUCCESS)
-		SHA256_update(&ctx, (const uint8_t *)buf, size);
-	else
+#ifdef CONFIG_VBOOT_HASH_PIPELINE
+	{
+		int cur = 0;
+
+		len = stride;
+		rv = flash_read_async(offset, len, buf);
+		while (rv == EC_SUCCESS) {
+			const uint8_t *data = (const uint8_t *)buf +
+					      cur * stride;
+			int next_len;
+
+			rv = wait_for_chunk();
+			if (rv != EC_SUCCESS)
+				break;
+
+			offset += len;
+			size -= len;
+			next_len = MIN(size, CHUNK_SIZE);
+			cur ^= 1;
+
+			/* Fetch the next chunk while hashing this one */
+			if (next_len)
+				rv = flash_read_async(offset, next_len,
+						      buf + cur * stride);
+			hash_update(data, len);
+
+			if (!next_len)
+				break;
+			len = next_len;
+		}
+	}
+#else
+	for (; size > 0 && rv == EC_SUCCESS; offset += len, size -= len) {
+		timestamp_t t0 = get_time();
+
+		len = MIN(size, CHUNK_SIZE);
+		rv = flash_read(offset, len, buf);
+		flash_wait_us += time_since32(t0);
+		if (rv == EC_SUCCESS)
+			hash_update((const uint8_t *)buf, len);
+	}
+#endif
+
+	if (rv != EC_SUCCESS)
 		vboot_hash_abort();
 
-	shared_mem_release(buf);
+	shared_mem_slab_release(buf);
 	return rv;
 }
 
@@ -112,33 +291,49 @@ static int read_and_hash_chunk(int offset, int size)
 #define SHA256_PRINT_SIZE 4
 #endif
 
-static void hash_next_chunk(size_t size)
+static int hash_next_step(size_t size)
 {
 #ifdef CONFIG_MAPPED_STORAGE
 	flash_lock_mapped_storage(1);
-	SHA256_update(&ctx, (const uint8_t *)(CONFIG_MAPPED_STORAGE_BASE +
-					      data_offset + curr_pos), size);
+	hash_update((const uint8_t *)(CONFIG_MAPPED_STORAGE_BASE +
+				      data_offset + curr_pos), size);
 	flash_lock_mapped_storage(0);
+	return EC_SUCCESS;
 #else
-	if (read_and_hash_chunk(data_offset + curr_pos, size) != EC_SUCCESS)
-		return;
+	return read_and_hash_chunks(data_offset + curr_pos, size);
 #endif
 }
 
+/**
+ * Store the final hash and leave the in-progress state.
+ */
+static void vboot_hash_done(void)
+{
+	hash = SHA256_final(&ctx);
+	hash_time_us = time_since32(hash_start_time);
+	CPRINTS("hash done %ph in %u us (flash wait %u us)",
+		HEX_BUF(hash, SHA256_PRINT_SIZE), hash_time_us, flash_wait_us);
+
+	in_progress = 0;
+
+	clock_enable_module(MODULE_FAST_CPU, 0);
+}
+
 static void vboot_hash_all_chunks(void)
 {
 	do {
-		size_t size = MIN(CHUNK_SIZE, data_size - curr_pos);
-		hash_next_chunk(size);
+		size_t size = MIN(STEP_SIZE, data_size - curr_pos);
+
+		if (hash_next_step(size) != EC_SUCCESS) {
+			in_progress = 0;
+			clock_enable_module(MODULE_FAST_CPU, 0);
+			vboot_hash_abort();
+			return;
+		}
 		curr_pos += size;
 	} while (curr_pos < data_size);
 
-	hash = SHA256_final(&ctx);
-	CPRINTS("hash done %ph", HEX_BUF(hash, SHA256_PRINT_SIZE));
-	in_progress = 0;
-	clock_enable_module(MODULE_FAST_CPU, 0);
-
-	return;
+	vboot_hash_done();
 }
 
 /**
@@ -156,24 +351,16 @@ static void vboot_hash_next_chunk(void)
 		return;
 	}
 
-	/* Compute the next chunk of hash */
-	size = MIN(CHUNK_SIZE, data_size - curr_pos);
-	hash_next_chunk(size);
-
-	curr_pos += size;
-	if (curr_pos >= data_size) {
-		/* Store the final hash */
-		hash = SHA256_final(&ctx);
-		CPRINTS("hash done %ph", HEX_BUF(hash, SHA256_PRINT_SIZE));
-
-		in_progress = 0;
-
-		clock_enable_module(MODULE_FAST_CPU, 0);
-
-		/* Handle receiving abort during finalize */
-		if (want_abort)
-			vboot_hash_abort();
+	/*
+	 * Compute the next step of hash.  On failure the step is retried, or
+	 * the abort it requested is handled, on the next call.
+	 */
+	size = MIN(STEP_SIZE, data_size - curr_pos);
+	if (hash_next_step(size) == EC_SUCCESS)
+		curr_pos += size;
 
+	if (curr_pos >= data_size && !want_abort) {
+		vboot_hash_done();
 		return;
 	}
 
@@ -221,12 +408,17 @@ static int vboot_hash_start(uint32_t offset, uint32_t size,
 	hash = NULL;
 	want_abort = 0;
 	in_progress = 1;
+	hash_start_time = get_time();
+	flash_wait_us = 0;
 
 	/* Restart the hash computation */
 	CPRINTS("hash start 0x%08x 0x%08x", offset, size);
 	SHA256_init(&ctx);
 	if (nonce_size)
 		SHA256_update(&ctx, nonce, nonce_size);
+#ifdef CONFIG_VBOOT_HASH_CACHE
+	cache_start(offset, size, nonce_size);
+#endif
 
 	if (deferred)
 		hook_call_deferred(&vboot_hash_next_chunk_data, 0);
@@ -380,6 +572,9 @@ static int command_hash(int argc, char **argv)
 			ccprintf("%ph\n", HEX_BUF(hash, SHA256_DIGEST_SIZE));
 		else
 			ccprintf("(invalid)\n");
+		if (hash)
+			ccprintf("Time:   %u us (flash wait %u us)\n",
+				 hash_time_us, flash_wait_us);
 
 		return EC_SUCCESS;
 	}
@@ -9,7 +9,9 @@
 #include "battery_smart.h"
 #include "console.h"
 #include "host_command.h"
+#include "hooks.h"
 #include "i2c.h"
+#include "task.h"
 #include "timer.h"
 #include "util.h"
 
@@ -44,9 +46,316 @@ static int battery_supports_pec(void)
 	return supports_pec;
 }
 
+#ifdef CONFIG_BATTERY_SMART_CACHE
+/*
+ * Word register cache.
+ *
+ * Each cached register has a time to live in ms.  Registers which the gauge
+ * only updates occasionally use an adaptive TTL: it doubles from min to max
+ * each time a refresh finds the value unchanged, and drops back to min when
+ * the value moves.  Voltage, current, status and the charging voltage and
+ * current the battery asks for are never cached, so the charger always acts
+ * on fresh readings, and a change in status flushes everything else.
+ * BatteryMode is cached for a while only, since the gauge sets some of its
+ * bits itself.
+ */
+#define SB_CACHE_FOREVER 0xffff
+
+static const struct {
+	uint16_t min_ttl;
+	uint16_t max_ttl;
+} sb_cache_ttl[SB_SERIAL_NUMBER + 1] = {
+	[SB_BATTERY_MODE]		= {1000, 8000},
+	[SB_TEMPERATURE]		= {1000, 8000},
+	[SB_AVERAGE_CURRENT]		= {1000, 1000},
+	[SB_RELATIVE_STATE_OF_CHARGE]	= {1000, 8000},
+	[SB_ABSOLUTE_STATE_OF_CHARGE]	= {1000, 8000},
+	[SB_REMAINING_CAPACITY]		= {1000, 4000},
+	[SB_FULL_CHARGE_CAPACITY]	= {10000, 60000},
+	[SB_RUN_TIME_TO_EMPTY]		= {1000, 8000},
+	[SB_AVERAGE_TIME_TO_EMPTY]	= {1000, 8000},
+	[SB_AVERAGE_TIME_TO_FULL]	= {1000, 8000},
+	[SB_CYCLE_COUNT]		= {60000, 60000},
+	[SB_DESIGN_CAPACITY]		= {SB_CACHE_FOREVER, SB_CACHE_FOREVER},
+	[SB_DESIGN_VOLTAGE]		= {SB_CACHE_FOREVER, SB_CACHE_FOREVER},
+	[SB_SPECIFICATION_INFO]		= {SB_CACHE_FOREVER, SB_CACHE_FOREVER},
+	[SB_MANUFACTURE_DATE]		= {SB_CACHE_FOREVER, SB_CACHE_FOREVER},
+	[SB_SERIAL_NUMBER]		= {SB_CACHE_FOREVER, SB_CACHE_FOREVER},
+};
+
+static struct {
+	uint32_t expires;	/* get_time().le.lo */
+	uint16_t value;
+	uint16_t ttl;		/* Current TTL in ms; 0 if not valid */
+} sb_cache[ARRAY_SIZE(sb_cache_ttl)];
+
+/* Static strings, which only change when the battery does */
+#define SB_CACHE_STRING_SIZE 32
+static const uint8_t sb_cache_string_reg[] = {
+	SB_MANUFACTURER_NAME, SB_DEVICE_NAME, SB_DEVICE_CHEMISTRY,
+};
+static uint8_t sb_cache_string[ARRAY_SIZE(sb_cache_string_reg)]
+	[SB_CACHE_STRING_SIZE];
+static uint8_t sb_cache_string_valid;
+
+static struct sb_cache_stats sb_cache_stats;
+static struct mutex sb_cache_lock;
+
+static int sb_cache_is_static(int cmd)
+{
+	return sb_cache_ttl[cmd].min_ttl == SB_CACHE_FOREVER;
+}
+
+/* Drop cached registers; the caller holds sb_cache_lock */
+static void sb_cache_flush(int flush_static)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sb_cache); i++) {
+		if (flush_static || !sb_cache_is_static(i))
+			sb_cache[i].ttl = 0;
+	}
+	if (flush_static)
+		sb_cache_string_valid = 0;
+}
+
+void sb_cache_invalidate(int flush_static)
+{
+	mutex_lock(&sb_cache_lock);
+	sb_cache_flush(flush_static);
+	mutex_unlock(&sb_cache_lock);
+}
+
+/* Current, and the current the battery asks for, jump with AC */
+static void sb_cache_ac_change(void)
+{
+	sb_cache_invalidate(0);
+}
+DECLARE_HOOK(HOOK_AC_CHANGE, sb_cache_ac_change, HOOK_PRIO_DEFAULT);
+
+/**
+ * Look up a register in the cache.
+ *
+ * @return 1 if *param was filled in from the cache, 0 if the register must be
+ *         read from the battery.
+ */
+static int sb_cache_lookup(int cmd, int *param)
+{
+	int hit = 0;
+
+	if (cmd < 0 || cmd >= ARRAY_SIZE(sb_cache) ||
+	    !sb_cache_ttl[cmd].min_ttl)
+		return 0;
+
+	mutex_lock(&sb_cache_lock);
+	if (sb_cache[cmd].ttl &&
+	    (sb_cache[cmd].ttl == SB_CACHE_FOREVER ||
+	     (int32_t)(get_time().le.lo - sb_cache[cmd].expires) < 0)) {
+		*param = sb_cache[cmd].value;
+		sb_cache_stats.hits++;
+		hit = 1;
+	} else {
+		sb_cache_stats.misses++;
+	}
+	mutex_unlock(&sb_cache_lock);
+
+	return hit;
+}
+
+/* Record the result of reading a register from the battery */
+static void sb_cache_update(int cmd, int rv, int value)
+{
+	static int last_status = -1;
+	uint16_t ttl;
+
+	if (rv) {
+		/* The battery may have gone away; trust nothing we have */
+		mutex_lock(&sb_cache_lock);
+		sb_cache_flush(1);
+		last_status = -1;
+		mutex_unlock(&sb_cache_lock);
+		return;
+	}
+
+	/*
+	 * BatteryStatus is read from several tasks, so compare and update it
+	 * under the lock, or a change seen by two readers at once is missed.
+	 */
+	if (cmd == SB_BATTERY_STATUS) {
+		mutex_lock(&sb_cache_lock);
+		if (last_status >= 0 && value != last_status)
+			sb_cache_flush(0);
+		last_status = value;
+		mutex_unlock(&sb_cache_lock);
+		return;
+	}
+
+	if (cmd < 0 || cmd >= ARRAY_SIZE(sb_cache) ||
+	    !sb_cache_ttl[cmd].min_ttl)
+		return;
+
+	mutex_lock(&sb_cache_lock);
+	ttl = sb_cache[cmd].ttl;
+	if (!ttl || sb_cache[cmd].value != value)
+		ttl = sb_cache_ttl[cmd].min_ttl;
+	else if (ttl < sb_cache_ttl[cmd].max_ttl)
+		ttl = MIN(ttl * 2, sb_cache_ttl[cmd].max_ttl);
+
+	sb_cache[cmd].value = value;
+	sb_cache[cmd].ttl = ttl;
+	sb_cache[cmd].expires = get_time().le.lo + ttl * MSEC;
+	mutex_unlock(&sb_cache_lock);
+}
+
+void sb_cache_fill(int cmd, int value)
+{
+	if (cmd < 0 || cmd >= ARRAY_SIZE(sb_cache) ||
+	    !sb_cache_ttl[cmd].min_ttl)
+		return;
+
+	sb_cache_update(cmd, EC_SUCCESS, value);
+}
+
+/* Flush after a write, which may change what the battery reports */
+static void sb_cache_written(int cmd)
+{
+	/* Capacity registers change units with the mode */
+	sb_cache_invalidate(cmd == SB_BATTERY_MODE);
+}
+
+/**
+ * Read one of the static strings through the cache.
+ *
+ * @return 1 if the string is cached and *rv holds the result of the read, or
+ *         0 if the caller must read it from the battery.
+ */
+static int sb_cache_read_string(uint16_t addr_flags, int offset,
+				uint8_t *data, int len, int *rv)
+{
+	int i;
+
+	if (len > SB_CACHE_STRING_SIZE)
+		return 0;
+
+	for (i = 0; i < ARRAY_SIZE(sb_cache_string_reg); i++) {
+		if (sb_cache_string_reg[i] == offset)
+			break;
+	}
+	if (i == ARRAY_SIZE(sb_cache_string_reg))
+		return 0;
+
+	mutex_lock(&sb_cache_lock);
+	if (sb_cache_string_valid & BIT(i)) {
+		*rv = EC_SUCCESS;
+		sb_cache_stats.hits++;
+	} else {
+		*rv = i2c_read_string(I2C_PORT_BATTERY, addr_flags, offset,
+				      sb_cache_string[i],
+				      SB_CACHE_STRING_SIZE);
+		if (!*rv)
+			sb_cache_string_valid |= BIT(i);
+		sb_cache_stats.misses++;
+	}
+	if (!*rv)
+		strzcpy((char *)data, (const char *)sb_cache_string[i], len);
+	mutex_unlock(&sb_cache_lock);
+
+	return 1;
+}
+
+void sb_cache_get_stats(struct sb_cache_stats *stats)
+{
+	mutex_lock(&sb_cache_lock);
+	*stats = sb_cache_stats;
+	mutex_unlock(&sb_cache_lock);
+}
+
+__overridable int board_battery_snapshot(void)
+{
+	return EC_ERROR_UNIMPLEMENTED;
+}
+
+/* Take a snapshot if any register battery_get_params() wants has expired */
+static void sb_cache_snapshot(void)
+{
+	static const uint8_t regs[] = {
+		SB_TEMPERATURE, SB_RELATIVE_STATE_OF_CHARGE,
+		SB_REMAINING_CAPACITY, SB_FULL_CHARGE_CAPACITY,
+	};
+	static int unsupported;
+	uint32_t now = get_time().le.lo;
+	int i, stale = 0;
+
+	if (unsupported)
+		return;
+
+	mutex_lock(&sb_cache_lock);
+	for (i = 0; i < ARRAY_SIZE(regs); i++) {
+		if (!sb_cache[regs[i]].ttl ||
+		    (int32_t)(now - sb_cache[regs[i]].expires) >= 0)
+			stale = 1;
+	}
+	mutex_unlock(&sb_cache_lock);
+
+	if (!stale)
+		return;
+
+	if (board_battery_snapshot() == EC_ERROR_UNIMPLEMENTED) {
+		unsupported = 1;
+		return;
+	}
+
+	mutex_lock(&sb_cache_lock);
+	sb_cache_stats.snapshots++;
+	mutex_unlock(&sb_cache_lock);
+}
+
+static int command_sbcache(int argc, char **argv)
+{
+	uint32_t now = get_time().le.lo;
+	int i;
+
+	if (argc > 1) {
+		if (strcasecmp(argv[1], "flush"))
+			return EC_ERROR_PARAM1;
+		sb_cache_invalidate(1);
+		return EC_SUCCESS;
+	}
+
+	ccprintf("hits %d misses %d snapshots %d\n", sb_cache_stats.hits,
+		 sb_cache_stats.misses, sb_cache_stats.snapshots);
+	for (i = 0; i < ARRAY_SIZE(sb_cache); i++) {
+		if (!sb_cache[i].ttl)
+			continue;
+		ccprintf("  0x%02x: 0x%04x ", i, sb_cache[i].value);
+		if (sb_cache[i].ttl == SB_CACHE_FOREVER)
+			ccprintf("static\n");
+		else
+			ccprintf("ttl %d ms, expires in %d ms\n",
+				 sb_cache[i].ttl,
+				 (int32_t)(sb_cache[i].expires - now) / MSEC);
+	}
+
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(sbcache, command_sbcache, "[flush]",
+			"Show or flush the smart battery register cache");
+#else
+static inline int sb_cache_lookup(int cmd, int *param) { return 0; }
+static inline void sb_cache_update(int cmd, int rv, int value) { }
+static inline void sb_cache_written(int cmd) { }
+static inline int sb_cache_read_string(uint16_t addr_flags, int offset,
+				       uint8_t *data, int len, int *rv)
+{
+	return 0;
+}
+static inline void sb_cache_snapshot(void) { }
+#endif /* CONFIG_BATTERY_SMART_CACHE */
+
 test_mockable int sb_read(int cmd, int *param)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	int rv;
 
 #ifdef CONFIG_BATTERY_CUT_OFF
 	/*
@@ -55,15 +364,21 @@ test_mockable int sb_read(int cmd, int *param)
 	if (battery_is_cut_off())
 		return EC_RES_ACCESS_DENIED;
 #endif
+	if (sb_cache_lookup(cmd, param))
+		return EC_SUCCESS;
+
 	if (battery_supports_pec())
 		addr_flags |= I2C_FLAG_PEC;
 
-	return i2c_read16(I2C_PORT_BATTERY, addr_flags, cmd, param);
+	rv = i2c_read16(I2C_PORT_BATTERY, addr_flags, cmd, param);
+	sb_cache_update(cmd, rv, *param);
+	return rv;
 }
 
 test_mockable int sb_write(int cmd, int param)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	int rv;
 
 #ifdef CONFIG_BATTERY_CUT_OFF
 	/*
@@ -75,12 +390,15 @@ test_mockable int sb_write(int cmd, int param)
 	if (battery_supports_pec())
 		addr_flags |= I2C_FLAG_PEC;
 
-	return i2c_write16(I2C_PORT_BATTERY, addr_flags, cmd, param);
+	rv = i2c_write16(I2C_PORT_BATTERY, addr_flags, cmd, param);
+	sb_cache_written(cmd);
+	return rv;
 }
 
 int sb_read_string(int offset, uint8_t *data, int len)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	int rv;
 
 #ifdef CONFIG_BATTERY_CUT_OFF
 	/*
@@ -92,6 +410,9 @@ int sb_read_string(int offset, uint8_t *data, int len)
 	if (battery_supports_pec())
 		addr_flags |= I2C_FLAG_PEC;
 
+	if (sb_cache_read_string(addr_flags, offset, data, len, &rv))
+		return rv;
+
 	return i2c_read_string(I2C_PORT_BATTERY, addr_flags, offset, data, len);
 }
 
@@ -128,6 +449,7 @@ int sb_read_mfgacc(int cmd, int block, uint8_t *data, int len)
 int sb_write_block(int reg, const uint8_t *val, int len)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	int rv;
 
 #ifdef CONFIG_BATTERY_CUT_OFF
 	/*
@@ -141,7 +463,9 @@ int sb_write_block(int reg, const uint8_t *val, int len)
 		addr_flags |= I2C_FLAG_PEC;
 
 	/* TODO: implement smbus_write_block. */
-	return i2c_write_block(I2C_PORT_BATTERY, addr_flags, reg, val, len);
+	rv = i2c_write_block(I2C_PORT_BATTERY, addr_flags, reg, val, len);
+	sb_cache_written(reg);
+	return rv;
 }
 
 int battery_get_mode(int *mode)
@@ -365,6 +689,8 @@ void battery_get_params(struct batt_params *batt)
 	struct batt_params batt_new = {0};
 	int v;
 
+	sb_cache_snapshot();
+
 	if (sb_read(SB_TEMPERATURE, &batt_new.temperature)
 			&& fake_temperature < 0)
 		batt_new.flags |= BATT_FLAG_BAD_TEMPERATURE;
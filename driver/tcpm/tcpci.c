@@ -114,6 +114,24 @@ static int tcpc_vbus[CONFIG_USB_PD_PORT_MAX_COUNT];
 /* Cached RP role values */
 static int cached_rp[CONFIG_USB_PD_PORT_MAX_COUNT];
 
+/*
+ * Shadow of the alert and status registers, ALERT through ALERT_EXT, for
+ * TCPCs flagged with TCPC_FLAGS_ALERT_BURST_READ.  tcpci_tcpc_alert() fills
+ * it with one I2C read, and the reads made while handling that alert are
+ * served from it instead of going to the TCPC one register at a time.  It is
+ * only used by the task handling the alert, and is dropped when it is done.
+ */
+#define TCPCI_SHADOW_FIRST	TCPC_REG_ALERT
+#define TCPCI_SHADOW_SIZE	(TCPC_REG_ALERT_EXT - TCPCI_SHADOW_FIRST + 1)
+
+struct tcpci_shadow {
+	uint8_t regs[TCPCI_SHADOW_SIZE];
+	/* Valid registers, as bits counted from TCPCI_SHADOW_FIRST */
+	uint32_t valid;
+	task_id_t task;
+};
+static struct tcpci_shadow shadow[CONFIG_USB_PD_PORT_MAX_COUNT];
+
 #ifdef CONFIG_USB_PD_TCPC_LOW_POWER
 int tcpc_addr_write(int port, int i2c_addr, int reg, int val)
 {
@@ -284,6 +302,60 @@ int tcpc_update16(int port, int reg,
 
 #endif /* CONFIG_USB_PD_TCPC_LOW_POWER */
 
+/*
+ * Fill the shadow from reg to the last status register the TCPC has, in one
+ * transfer.  Does nothing unless the TCPC supports burst reads.
+ */
+static int tcpci_shadow_fill(int port, int reg)
+{
+	struct tcpci_shadow *s = &shadow[port];
+	const int last = tcpc_config[port].flags & TCPC_FLAGS_TCPCI_REV2_0 ?
+			 TCPC_REG_ALERT_EXT : TCPC_REG_FAULT_STATUS;
+	const int off = reg - TCPCI_SHADOW_FIRST;
+	int rv;
+
+	if (!(tcpc_config[port].flags & TCPC_FLAGS_ALERT_BURST_READ))
+		return EC_ERROR_UNIMPLEMENTED;
+
+	s->valid &= ~GENMASK(last - TCPCI_SHADOW_FIRST, off);
+	rv = tcpc_read_block(port, reg, s->regs + off, last - reg + 1);
+	if (rv)
+		return rv;
+
+	s->task = task_get_current();
+	s->valid |= GENMASK(last - TCPCI_SHADOW_FIRST, off);
+	return EC_SUCCESS;
+}
+
+static void tcpci_shadow_drop(int port)
+{
+	shadow[port].valid = 0;
+}
+
+/*
+ * Read an 8 or 16 bit register from the shadow if it holds it, else from the
+ * TCPC.
+ */
+static int tcpci_shadow_read(int port, int reg, int size, int *val)
+{
+	const struct tcpci_shadow *s = &shadow[port];
+	const int off = reg - TCPCI_SHADOW_FIRST;
+
+	if (s->valid && off >= 0 && off + size <= TCPCI_SHADOW_SIZE &&
+	    (s->valid & GENMASK(off + size - 1, off)) ==
+		GENMASK(off + size - 1, off) &&
+	    s->task == task_get_current()) {
+		*val = s->regs[off];
+		if (size == 2)
+			*val |= s->regs[off + 1] << 8;
+		return EC_SUCCESS;
+	}
+
+	if (size == 2)
+		return tcpc_read16(port, reg, val);
+	return tcpc_read(port, reg, val);
+}
+
 /*
  * TCPCI maintains and uses cached values for the RP and
  * last used PULL values.  Since TCPC drivers are allowed
@@ -366,7 +438,7 @@ static int clear_power_status_mask(int port)
 
 static int tcpci_tcpm_get_power_status(int port, int *status)
 {
-	return tcpc_read(port, TCPC_REG_POWER_STATUS, status);
+	return tcpci_shadow_read(port, TCPC_REG_POWER_STATUS, 1, status);
 }
 
 int tcpci_tcpm_select_rp_value(int port, int rp)
@@ -426,11 +498,11 @@ int tcpci_tcpm_get_cc(int port, enum tcpc_cc_voltage_status *cc1,
 	*cc2 = TYPEC_CC_VOLT_OPEN;
 
 	/* Get the ROLE CONTROL and CC STATUS values */
-	rv = tcpc_read(port, TCPC_REG_ROLE_CTRL, &role);
+	rv = tcpci_shadow_read(port, TCPC_REG_ROLE_CTRL, 1, &role);
 	if (rv)
 		return rv;
 
-	rv = tcpc_read(port, TCPC_REG_CC_STATUS, &status);
+	rv = tcpci_shadow_read(port, TCPC_REG_CC_STATUS, 1, &status);
 	if (rv)
 		return rv;
 
@@ -673,13 +745,13 @@ static int tcpm_alert_status(int port, int *alert)
 static int tcpm_alert_ext_status(int port, int *alert_ext)
 {
 	/* Read TCPC Extended Alert register */
-	return tcpc_read(port, TCPC_REG_ALERT_EXT, alert_ext);
+	return tcpci_shadow_read(port, TCPC_REG_ALERT_EXT, 1, alert_ext);
 }
 
 static int tcpm_ext_status(int port, int *ext_status)
 {
 	/* Read TCPC Extended Status register */
-	return tcpc_read(port, TCPC_REG_EXT_STATUS, ext_status);
+	return tcpci_shadow_read(port, TCPC_REG_EXT_STATUS, 1, ext_status);
 }
 
 int tcpci_tcpm_set_rx_enable(int port, int enable)
@@ -1019,12 +1091,12 @@ static int register_mask_reset(int port)
 	int mask;
 
 	mask = 0;
-	tcpc_read16(port, TCPC_REG_ALERT_MASK, &mask);
+	tcpci_shadow_read(port, TCPC_REG_ALERT_MASK, 2, &mask);
 	if (mask == TCPC_REG_ALERT_MASK_ALL)
 		return 1;
 
 	mask = 0;
-	tcpc_read(port, TCPC_REG_POWER_STATUS_MASK, &mask);
+	tcpci_shadow_read(port, TCPC_REG_POWER_STATUS_MASK, 1, &mask);
 	if (mask == TCPC_REG_POWER_STATUS_MASK_ALL)
 		return 1;
 
@@ -1033,7 +1105,7 @@ static int register_mask_reset(int port)
 
 static int tcpci_get_fault(int port, int *fault)
 {
-	return tcpc_read(port, TCPC_REG_FAULT_STATUS, fault);
+	return tcpci_shadow_read(port, TCPC_REG_FAULT_STATUS, 1, fault);
 }
 
 static int tcpci_handle_fault(int port, int fault)
@@ -1059,8 +1131,11 @@ static int tcpci_handle_fault(int port, int fault)
 				last_write_op[port].mask & 0xFFFF);
 	}
 
-	if (tcpc_config[port].drv->handle_fault)
+	if (tcpc_config[port].drv->handle_fault) {
+		/* The driver may rewrite anything the shadow holds */
+		tcpci_shadow_drop(port);
 		rv = tcpc_config[port].drv->handle_fault(port, fault);
+	}
 
 	return rv;
 }
@@ -1142,8 +1217,12 @@ void tcpci_tcpc_alert(int port)
 	int failed_attempts;
 	uint32_t pd_event = 0;
 
-	/* Read the Alert register from the TCPC */
-	if (tcpm_alert_status(port, &alert)) {
+	/*
+	 * Read the Alert register from the TCPC, along with the status
+	 * registers after it if the TCPC can do that in one read.
+	 */
+	tcpci_shadow_fill(port, TCPC_REG_ALERT);
+	if (tcpci_shadow_read(port, TCPC_REG_ALERT, 2, &alert)) {
 		CPRINTS("C%d: Failed to read alert register", port);
 		return;
 	}
@@ -1190,6 +1269,7 @@ void tcpci_tcpc_alert(int port)
 			 * all EC resources so suspend the port for a little
 			 * while.
 			 */
+			tcpci_shadow_drop(port);
 			pd_set_suspend(port, 1);
 			pd_deferred_resume(port);
 			return;
@@ -1205,6 +1285,17 @@ void tcpci_tcpc_alert(int port)
 	if (alert)
 		tcpc_write16(port, TCPC_REG_ALERT, alert);
 
+	/*
+	 * A status change between the first read and clearing its alert bit
+	 * would be lost, so read the status registers again now.  This is one
+	 * transfer for all of them.  Start at ROLE_CTRL, which CC_STATUS is
+	 * decoded against, in case the PD task has written it since.
+	 */
+	if (alert & (TCPC_REG_ALERT_CC_STATUS | TCPC_REG_ALERT_POWER_STATUS |
+		     TCPC_REG_ALERT_EXT_STATUS) &&
+	    tcpci_shadow_fill(port, TCPC_REG_ROLE_CTRL))
+		tcpci_shadow_drop(port);
+
 	if (alert & TCPC_REG_ALERT_CC_STATUS) {
 		if (IS_ENABLED(CONFIG_USB_PD_DUAL_ROLE_AUTO_TOGGLE)) {
 			enum tcpc_cc_voltage_status cc1;
@@ -1258,6 +1349,8 @@ void tcpci_tcpc_alert(int port)
 	if (register_mask_reset(port))
 		pd_event |= PD_EVENT_TCPC_RESET;
 
+	tcpci_shadow_drop(port);
+
 	/*
 	 * Wait until all possible TCPC accesses in this function are complete
 	 * prior to setting events and/or waking the pd task. When the PD
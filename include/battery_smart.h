@@ -167,5 +167,44 @@ int sb_write_block(int reg, const uint8_t *val, int len);
 /* Read manufactures access data from the battery */
 int sb_read_mfgacc(int cmd, int block, uint8_t *data, int len);
 
+/* Smart battery register cache statistics */
+struct sb_cache_stats {
+	uint32_t hits;		/* Reads answered from the cache */
+	uint32_t misses;	/* Reads which went to the battery */
+	uint32_t snapshots;	/* Successful board_battery_snapshot() calls */
+};
+
+/**
+ * Drop cached battery registers.
+ *
+ * Registers are flushed automatically on writes, read errors, AC changes and
+ * changes in BatteryStatus(); this is for anything else which is known to
+ * change what the battery reports.
+ *
+ * @param flush_static	Non-zero to also drop the static registers and
+ *			strings (design values, serial number, names).
+ */
+void sb_cache_invalidate(int flush_static);
+
+/**
+ * Store a register value read by other means, e.g. from a gauge-specific
+ * block read in board_battery_snapshot().  Ignored for registers which are
+ * not cached.
+ */
+void sb_cache_fill(int cmd, int value);
+
+/* Get the cache hit and miss counters */
+void sb_cache_get_stats(struct sb_cache_stats *stats);
+
+/**
+ * Read several registers from the gauge in one transaction, and store them
+ * with sb_cache_fill().  Called from battery_get_params() when the cached
+ * values it needs have expired.
+ *
+ * @return EC_SUCCESS, or EC_ERROR_UNIMPLEMENTED if the gauge has no such
+ *         read, in which case it is not called again.
+ */
+__override_proto int board_battery_snapshot(void);
+
 #endif /* __CROS_EC_BATTERY_SMART_H */
 
@@ -514,6 +514,13 @@
  */
 #undef CONFIG_BATTERY_SMART
 
+/*
+ * Cache smart battery word registers and static strings, so that repeated
+ * reads within a register's time to live do not go out on the bus.  Use the
+ * sbcache console command to see hit and miss counts.
+ */
+#undef CONFIG_BATTERY_SMART_CACHE
+
 /* Chemistry of the battery device */
 #undef CONFIG_BATTERY_DEVICE_CHEMISTRY
 
@@ -1463,6 +1470,12 @@
 /* Provide common core code to handle the operating system timers. */
 #define CONFIG_COMMON_TIMER
 
+/*
+ * Deadline-sorted queue of armed timers.  Selected by CONFIG_COMMON_TIMER;
+ * tests may define it alone to exercise the queue.
+ */
+#undef CONFIG_TIMER_QUEUE
+
 /*****************************************************************************/
 
 /*
@@ -1520,6 +1533,14 @@
 /* Enable verbose output to UART console and extra timestamp print precision. */
 #define CONFIG_CONSOLE_VERBOSE
 
+/*
+ * Log cprints() output as compact binary records instead of formatted text.
+ * A record holds the address of the format string and the raw arguments, and
+ * host tools expand it later using the strings in the EC ELF image (see
+ * include/console_binlog.h and util/ec3po/binlog.py).
+ */
+#undef CONFIG_CONSOLE_BINARY_LOG
+
 /*****************************************************************************/
 /* Support for EC-EC communication */
 
@@ -1546,6 +1567,9 @@
 /* Include CRC-8 utility function */
 #undef CONFIG_CRC8
 
+/* Compute CRC-8 with a 256-byte table instead of bit by bit */
+#undef CONFIG_CRC8_TABLE
+
 /*****************************************************************************/
 /*
  * Debugging config
@@ -1792,6 +1816,13 @@
  */
 #undef CONFIG_FLASH_PSTATE_LOCKED
 
+/*
+ * Start flash reads and return before the data has arrived, through
+ * flash_physical_read_async() and flash_physical_read_wait().  Only chip/mchp
+ * implements them, by QMSPI DMA; a board opts in by defining this.
+ */
+#undef CONFIG_FLASH_READ_ASYNC
+
 /*
  * Enable readout protection.
  */
@@ -2105,6 +2136,26 @@
  */
 #undef CONFIG_HOSTCMD_SECTION_SORTED
 
+/*
+ * Dispatch host commands through a two-level table indexed by command number
+ * instead of searching .rodata.hcmds.  The table is built when the host
+ * command task starts: each 256-command page holding handlers gets a dense
+ * 256-byte index, for up to CONFIG_HOSTCMD_DISPATCH_PAGES pages.  Commands in
+ * any further pages fall back to the search.  The table takes
+ * CONFIG_HOSTCMD_DISPATCH_PAGES * 256 + 64 bytes of RAM.
+ */
+#undef CONFIG_HOSTCMD_DISPATCH_TABLE
+#define CONFIG_HOSTCMD_DISPATCH_PAGES 4
+
+/* Support EC_CMD_BATCH, which runs several host commands in one packet */
+#undef CONFIG_HOSTCMD_BATCH
+
+/*
+ * Keep per-command call, error and handler time statistics, reported by
+ * EC_CMD_HOST_STATS.  Costs 60 bytes of RAM per host command.
+ */
+#undef CONFIG_HOSTCMD_STATS
+
 /*
  * Host command parameters and response are 32-bit aligned.  This generates
  * much more efficient code on ARM.
@@ -2229,6 +2280,19 @@
 /* Enable the software routine for CRC computation */
 #undef CONFIG_SW_CRC
 
+/*
+ * Software CRC-32 engine, at most one of these.  The default folds one byte
+ * per lookup in a 1 KiB table.
+ *
+ * CONFIG_SW_CRC_NIBBLE: 64-byte table, two lookups per byte, for parts short
+ * on flash.
+ * CONFIG_SW_CRC_SLICE_BY_4: 4 KiB of tables, four bytes per step.
+ * CONFIG_SW_CRC_SLICE_BY_8: 8 KiB of tables, eight bytes per step.
+ */
+#undef CONFIG_SW_CRC_NIBBLE
+#undef CONFIG_SW_CRC_SLICE_BY_4
+#undef CONFIG_SW_CRC_SLICE_BY_8
+
 /*****************************************************************************/
 
 /* Enable system hibernate */
@@ -2336,6 +2400,30 @@
  */
 #undef CONFIG_I2C_MASTER
 
+/*
+ * Queue I2C transfers with i2c_xfer_async() and run them from
+ * i2c_async_task().  The board must add one or more I2C_ASYNC tasks to its
+ * tasklist; see include/i2c.h.
+ */
+#undef CONFIG_I2C_ASYNC
+
+/*
+ * Keep per-device I2C transfer counters and a transfer time histogram, read
+ * with EC_CMD_I2C_STATS.  CONFIG_I2C_STATS_DEVICES is the number of
+ * (port, address) pairs tracked; transfers to any more are only counted as
+ * dropped.
+ */
+#undef CONFIG_I2C_STATS
+#define CONFIG_I2C_STATS_DEVICES 16
+
+/*
+ * Record every I2C transfer in a ring buffer of CONFIG_I2C_TRACE_BUFFER_SIZE
+ * binary records, read with EC_CMD_I2C_TRACE and decoded on the host by
+ * util/i2c_trace.py.  The size must be a power of two.
+ */
+#undef CONFIG_I2C_TRACE_BUFFER
+#define CONFIG_I2C_TRACE_BUFFER_SIZE 128
+
 /* EC uses an I2C slave interface */
 #undef CONFIG_I2C_SLAVE
 
@@ -3371,6 +3459,24 @@
 /* Unroll some loops in SHA256_transform for better performance. */
 #undef CONFIG_SHA256_UNROLLED
 
+/*
+ * Hand whole SHA-256 blocks to the chip hash engine through
+ * chip_sha256_transform(), falling back to software when it declines.
+ */
+#undef CONFIG_SHA256_HW_ACCELERATE
+
+/*
+ * Size-class slab pools for hot fixed-size buffers, served in constant time by
+ * shared_mem_slab_acquire() before falling back to shared memory.  Define as a
+ * list of SHARED_MEM_SLAB(size, count) entries, smallest size first, e.g.
+ *
+ *   #define CONFIG_SHARED_MEM_SLABS \
+ *	SHARED_MEM_SLAB(64, 8) SHARED_MEM_SLAB(1024, 2)
+ *
+ * Each entry reserves count (at most 32) buffers of size bytes in .bss.
+ */
+#undef CONFIG_SHARED_MEM_SLABS
+
 /* Emulate the CLZ (Count Leading Zeros) in software for CPU lacking support */
 #undef CONFIG_SOFTWARE_CLZ
 
@@ -4702,6 +4808,34 @@
 /* Support computing hash of code for verified boot */
 #undef CONFIG_VBOOT_HASH
 
+/*
+ * Work done by each deferred vboot hash step: the flash is read and hashed in
+ * chunks of CONFIG_VBOOT_HASH_CHUNK_SIZE bytes, up to
+ * CONFIG_VBOOT_HASH_CHUNKS_PER_STEP chunks per step, with
+ * CONFIG_VBOOT_HASH_STEP_INTERVAL_US between steps to let other work run.
+ */
+#define CONFIG_VBOOT_HASH_CHUNK_SIZE 1024
+#define CONFIG_VBOOT_HASH_CHUNKS_PER_STEP 1
+#define CONFIG_VBOOT_HASH_STEP_INTERVAL_US 100
+
+/*
+ * Double-buffer the vboot hash on non-mapped storage: start reading the next
+ * chunk with flash_read_async() before hashing the current one, so the flash
+ * transfer overlaps SHA-256 when the board enables CONFIG_FLASH_READ_ASYNC.
+ * The two chunk buffers must fit in CONFIG_SHAREDMEM_MINIMUM_SIZE.  Most useful
+ * with more than one chunk per step, as reads never span two steps.
+ */
+#undef CONFIG_VBOOT_HASH_PIPELINE
+
+/*
+ * Keep the SHA-256 state at every CONFIG_VBOOT_HASH_CACHE_BLOCK_SIZE bytes of
+ * the last region hashed without a nonce.  After a partial flash write, the
+ * next hash of that region resumes from the block before the first modified
+ * one instead of starting over.  Costs 32 bytes of RAM per block of RW.
+ */
+#undef CONFIG_VBOOT_HASH_CACHE
+#define CONFIG_VBOOT_HASH_CACHE_BLOCK_SIZE 4096
+
 /* Support for secure temporary storage for verified boot */
 #undef CONFIG_VSTORE
 
@@ -5281,6 +5415,10 @@
 #define CONFIG_LED_PWM_CHARGE_STATE_ONLY
 #endif
 
+#ifdef CONFIG_COMMON_TIMER
+#define CONFIG_TIMER_QUEUE
+#endif
+
 /*****************************************************************************/
 /*
  * Define derived configuration options for EC-EC communication
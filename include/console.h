@@ -50,7 +50,10 @@ struct binary_print_params {
 
 /* Console command; used by DECLARE_CONSOLE_COMMAND macro. */
 struct console_command {
-	/* Command name.  Case-insensitive. */
+	/*
+	 * Command name.  Case-insensitive, but must be lower case since the
+	 * linker sorts commands by name for lookup.
+	 */
 	const char *name;
 	/* Handler for the command.  argv[0] will be the command name. */
 	int (*handler)(int argc, char **argv);
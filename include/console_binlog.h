@@ -0,0 +1,68 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Binary (deferred-formatting) console log records */
+
+#ifndef __CROS_EC_CONSOLE_BINLOG_H
+#define __CROS_EC_CONSOLE_BINLOG_H
+
+#include <stdarg.h>
+
+#include "common.h"
+#include "console.h"
+
+/*
+ * With CONFIG_CONSOLE_BINARY_LOG, cprints() does not format its output on the
+ * EC.  Instead it writes one record line to the console:
+ *
+ *   BINLOG_MARKER <base64 of record, unpadded> '\n'
+ *
+ * The record is kept printable so that it passes unchanged through the UART,
+ * EC_CMD_CONSOLE_READ and servo.  Decoded, it contains:
+ *
+ *   uint32_t  format string address, little-endian
+ *   uint8_t   console channel, ORed with BINLOG_TIMESTAMP_MSEC if the EC
+ *             was built without CONFIG_CONSOLE_VERBOSE
+ *   varint    timestamp in microseconds
+ *   ...       one entry per conversion in the format string
+ *
+ * Each conversion is stored as:
+ *   '*' width or precision   zigzag varint
+ *   %c                       varint
+ *   %d %i                    zigzag varint
+ *   %u %x %X %pP             varint
+ *   %s                       varint length, then the characters
+ *   %pT                      varint timestamp in microseconds
+ *   %ph                      varint (length + 1), then the bytes; 0 if NULL
+ *   %pb                      varint (bit count + 1), then varint value;
+ *                            0 if NULL
+ *
+ * Varints are unsigned LEB128; zigzag maps n to (n << 1) ^ (n >> 63).
+ *
+ * Timestamps are always stored in microseconds.  The host prints them with
+ * the same precision as %pT does on the EC: to the microsecond with
+ * CONFIG_CONSOLE_VERBOSE, else to the millisecond.
+ *
+ * A record which would not fit in BINLOG_MAX_RECORD bytes, or whose format
+ * string contains a conversion the encoder does not know, is printed as text
+ * instead.
+ */
+#define BINLOG_MARKER		'$'
+#define BINLOG_MAX_RECORD	96
+#define BINLOG_TIMESTAMP_MSEC	BIT(7)
+
+/**
+ * Write a cprints() record to the console.
+ *
+ * @param channel	Output channel
+ * @param format	Format string
+ * @param args		Parameters
+ * @return EC_SUCCESS, EC_ERROR_OVERFLOW if the output was truncated, or
+ *         EC_ERROR_UNIMPLEMENTED if the caller must print the text instead.
+ */
+int console_binlog_vprints(enum console_channel channel, const char *format,
+			   va_list args);
+
+#endif  /* __CROS_EC_CONSOLE_BINLOG_H */
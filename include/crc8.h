@@ -9,9 +9,8 @@
 
 /**
  * crc8
- * Return CRC-8 of the data, using x^8 + x^2 + x + 1 polynomial.  A table-based
- * algorithm would be faster, but for only a few bytes it isn't worth the code
- * size.
+ * Return CRC-8 of the data, using x^8 + x^2 + x + 1 polynomial.  Computed bit
+ * by bit unless CONFIG_CRC8_TABLE trades 256 bytes of flash for speed.
  * @param data uint8_t *, input, a pointer to input data
  * @param len int, input, size of input data in bytes
  * @return the crc-8 of the input data.
@@ -6523,6 +6523,249 @@ struct ec_response_typec_status {
 	/* TODO(b/167700356): Add revisions and source cap PDOs */
 } __ec_align1;
 
+/*****************************************************************************/
+/*
+ * The commands below are not in upstream, so they take numbers from the top
+ * of the Framework-private page (see EC_CMD_BOARD_SPECIFIC_BASE), clear of
+ * the board commands which count up from 0x3E01.
+ */
+
+/*
+ * Per-routine profile of hooks and deferred functions, kept by ECs built with
+ * CONFIG_HOOK_DEBUG.  Routines are returned a page at a time, starting at
+ * the given offset into the hook or deferred function table.
+ */
+#define EC_CMD_HOOK_STATS 0x3EF0
+
+enum ec_hook_stats_kind {
+	EC_HOOK_STATS_HOOKS = 0,	/* DECLARE_HOOK() routines */
+	EC_HOOK_STATS_DEFERRED = 1,	/* DECLARE_DEFERRED() routines */
+};
+
+/* Clear the counters of the returned routines after reading them */
+#define EC_HOOK_STATS_FLAG_CLEAR BIT(0)
+
+/*
+ * Late-start histogram.  Bucket n counts calls started less than
+ * (64 << 2n) us late, and the last bucket counts everything later.  Hooks are
+ * late from the start of hook_notify(), deferred functions from the time
+ * they were due.
+ */
+#define EC_HOOK_STATS_LATE_BUCKETS 8
+
+/* Type of deferred functions in ec_hook_stats_entry */
+#define EC_HOOK_STATS_TYPE_DEFERRED 0xff
+
+struct ec_params_hook_stats {
+	uint8_t kind;		/* enum ec_hook_stats_kind */
+	uint8_t flags;		/* EC_HOOK_STATS_FLAG_* */
+	uint16_t offset;	/* Index of the first routine to return */
+} __ec_align2;
+
+struct ec_hook_stats_entry {
+	uint32_t routine;	/* Routine address, for symbol lookup */
+	uint16_t priority;	/* Hook priority, 0 for deferred functions */
+	uint8_t type;		/* enum hook_type, or
+				 * EC_HOOK_STATS_TYPE_DEFERRED */
+	uint8_t reserved;
+	uint32_t calls;		/* Number of calls */
+	uint32_t max_us;	/* Longest run time */
+	uint64_t total_us;	/* Cumulative run time */
+	uint16_t late[EC_HOOK_STATS_LATE_BUCKETS];
+} __ec_align4;
+
+struct ec_response_hook_stats {
+	uint16_t total;		/* Number of routines of the requested kind */
+	uint8_t count;		/* Number of entries that follow */
+	uint8_t reserved;
+	struct ec_hook_stats_entry entries[];
+} __ec_align4;
+
+/*****************************************************************************/
+/*
+ * Run several host commands in one transaction, for ECs built with
+ * CONFIG_HOSTCMD_BATCH.
+ *
+ * The request is an ec_params_batch header followed by count sub-requests.
+ * Each one is an ec_params_batch_entry followed by its parameters, padded
+ * to a multiple of 4 bytes.  The response is an ec_response_batch header
+ * followed by one ec_response_batch_entry and its padded response data for
+ * each sub-request that was run.
+ *
+ * Sub-commands are dispatched and version-checked exactly as if they had
+ * been sent on their own.  They may not return EC_RES_IN_PROGRESS.
+ * EC_CMD_BATCH cannot be nested, and commands which respond early or do not
+ * return (EC_CMD_FLASH_ERASE, EC_CMD_REBOOT, EC_CMD_REBOOT_EC) are refused.
+ * The batch itself fails only when the request is malformed or contains one
+ * of those; a sub-command error is reported in its entry.
+ */
+#define EC_CMD_BATCH 0x3EF1
+
+/* Stop at the first sub-command which does not return EC_RES_SUCCESS */
+#define EC_BATCH_FLAG_STOP_ON_ERROR BIT(0)
+
+/* Sub-request and sub-response data is padded to this many bytes */
+#define EC_BATCH_ALIGN 4
+
+struct ec_params_batch {
+	uint8_t count;		/* Number of sub-requests that follow */
+	uint8_t flags;		/* EC_BATCH_FLAG_* */
+	uint16_t reserved;
+} __ec_align4;
+
+struct ec_params_batch_entry {
+	uint16_t command;	/* Command code */
+	uint8_t version;	/* Command version */
+	uint8_t reserved;
+	uint16_t size;		/* Size of parameters, excluding padding */
+	uint16_t reserved1;
+	/* Followed by the parameters */
+} __ec_align4;
+
+struct ec_response_batch {
+	uint8_t count;		/* Number of sub-responses that follow */
+	uint8_t reserved[3];
+} __ec_align4;
+
+struct ec_response_batch_entry {
+	uint16_t result;	/* enum ec_status of the sub-command */
+	uint16_t size;		/* Size of response data, excluding padding */
+	/* Followed by the response data */
+} __ec_align4;
+
+/*****************************************************************************/
+/*
+ * Per-command profile of host command handlers, kept by ECs built with
+ * CONFIG_HOSTCMD_STATS.  Commands are returned a page at a time, starting at
+ * the given offset into the EC's host command table.
+ */
+#define EC_CMD_HOST_STATS 0x3EF2
+
+/* Clear the counters of the returned commands after reading them */
+#define EC_HOST_STATS_FLAG_CLEAR BIT(0)
+
+/*
+ * Handler time histogram.  Bucket n counts calls which took less than
+ * (16 << n) us, and the last bucket counts everything slower.
+ */
+#define EC_HOST_STATS_BUCKETS 12
+
+struct ec_params_host_stats {
+	uint8_t flags;		/* EC_HOST_STATS_FLAG_* */
+	uint8_t reserved;
+	uint16_t offset;	/* Index of the first command to return */
+} __ec_align2;
+
+struct ec_host_stats_entry {
+	uint16_t command;	/* Command code */
+	uint16_t last_error;	/* Last result other than EC_RES_SUCCESS */
+	uint32_t calls;		/* Number of calls */
+	uint32_t errors;	/* Calls which did not return EC_RES_SUCCESS */
+	uint32_t min_us;	/* Shortest handler time */
+	uint32_t max_us;	/* Longest handler time */
+	uint32_t reserved;
+	uint64_t total_us;	/* Cumulative handler time */
+	uint16_t hist[EC_HOST_STATS_BUCKETS];
+} __ec_align4;
+
+struct ec_response_host_stats {
+	uint16_t total;		/* Number of host commands on the EC */
+	uint8_t count;		/* Number of entries that follow */
+	uint8_t reserved;
+	struct ec_host_stats_entry entries[];
+} __ec_align4;
+
+/*****************************************************************************/
+/*
+ * Per-device I2C bus statistics, kept by ECs built with CONFIG_I2C_STATS.
+ * Devices are listed in the order the EC first talked to them, and returned a
+ * page at a time starting at the given offset.
+ */
+#define EC_CMD_I2C_STATS 0x3EF3
+
+/*
+ * Clear the counters of the returned devices after reading them.  A clearing
+ * read of the first page restarts window_ms, and one of the last page clears
+ * dropped after reporting it.
+ */
+#define EC_I2C_STATS_FLAG_CLEAR BIT(0)
+
+/*
+ * Transfer time histogram.  Bucket n counts transfers which took less than
+ * (32 << n) us, and the last bucket counts everything slower.
+ */
+#define EC_I2C_STATS_BUCKETS 10
+
+struct ec_params_i2c_stats {
+	uint8_t flags;		/* EC_I2C_STATS_FLAG_* */
+	uint8_t offset;		/* Index of the first device to return */
+} __ec_align1;
+
+struct ec_i2c_stats_entry {
+	uint8_t port;		/* I2C port */
+	uint8_t addr;		/* 7-bit slave address */
+	uint16_t reserved;
+	uint32_t xfers;		/* Number of transfers */
+	uint32_t errors;	/* Failed transfers other than timeouts,
+				 * which for most chips means a NAK */
+	uint32_t timeouts;	/* Transfers which timed out */
+	uint32_t retries;	/* Transfers repeated while the bus was busy */
+	uint32_t bytes;		/* Bytes written and read */
+	uint32_t max_us;	/* Longest transfer */
+	uint64_t total_us;	/* Cumulative time on the bus */
+	uint16_t hist[EC_I2C_STATS_BUCKETS];
+} __ec_align4;
+
+struct ec_response_i2c_stats {
+	uint32_t window_ms;	/* Time since the counters were cleared */
+	uint32_t dropped;	/* Transfers to devices beyond the table size */
+	uint8_t total;		/* Number of devices seen by the EC */
+	uint8_t count;		/* Number of entries that follow */
+	uint16_t reserved;
+	struct ec_i2c_stats_entry entries[];
+} __ec_align4;
+
+/*****************************************************************************/
+/*
+ * Read the I2C transfer trace kept by ECs built with CONFIG_I2C_TRACE_BUFFER.
+ *
+ * Each transfer gets the next sequence number.  The host asks for records
+ * starting at a sequence number and gets back as many as fit.  If the
+ * returned seq is larger than the one asked for, the records in between were
+ * overwritten before they were read.  Reading does not remove records, so
+ * several readers can follow the trace.
+ */
+#define EC_CMD_I2C_TRACE 0x3EF4
+
+/* Number of data bytes kept per transfer */
+#define EC_I2C_TRACE_DATA_SIZE 4
+
+struct ec_params_i2c_trace {
+	uint32_t seq;		/* Sequence number of the first record wanted */
+} __ec_align4;
+
+struct ec_i2c_trace_record {
+	uint32_t timestamp;	/* Start of the transfer; EC time in us, low
+				 * 32 bits */
+	uint16_t duration_us;	/* Saturates at 0xffff */
+	uint8_t port;		/* I2C port */
+	uint8_t addr;		/* 7-bit slave address */
+	uint8_t out_size;	/* Bytes written; saturates at 0xff */
+	uint8_t in_size;	/* Bytes read; saturates at 0xff */
+	uint8_t status;		/* enum ec_error_list; saturates at 0xff */
+	uint8_t flags;		/* I2C_XFER_START / I2C_XFER_STOP */
+	/* The first bytes written, followed by the first bytes read */
+	uint8_t data[EC_I2C_TRACE_DATA_SIZE];
+} __ec_align4;
+
+struct ec_response_i2c_trace {
+	uint32_t seq;		/* Sequence number of the first record */
+	uint32_t head;		/* Sequence number of the next transfer */
+	uint8_t count;		/* Number of records that follow */
+	uint8_t reserved[3];
+	struct ec_i2c_trace_record records[];
+} __ec_align4;
+
 /*****************************************************************************/
 /* The command range 0x200-0x2FF is reserved for Rotor. */
 
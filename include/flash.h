@@ -132,6 +132,27 @@ enum flash_region {
  */
 int flash_physical_read(int offset, int size, char *data);
 
+#ifdef CONFIG_FLASH_READ_ASYNC
+/**
+ * Start reading from physical flash without waiting for the data.
+ *
+ * The flash may not be used by anyone else until flash_physical_read_wait()
+ * has been called, which must happen from the same task.
+ *
+ * @param offset	Flash offset to read.
+ * @param size	        Number of bytes to read.
+ * @param data          Destination buffer for data.  Must be 32-bit aligned.
+ */
+int flash_physical_read_async(int offset, int size, char *data);
+
+/**
+ * Wait for the read started by flash_physical_read_async() to complete.
+ *
+ * @return EC_SUCCESS, or non-zero if the read failed.
+ */
+int flash_physical_read_wait(void);
+#endif
+
 /**
  * Write to physical flash.
  *
@@ -298,6 +319,26 @@ int flash_dataptr(int offset, int size_req, int align, const char **ptrp);
  */
 int flash_read(int offset, int size, char *data);
 
+/**
+ * Start reading from flash, returning before the data may have arrived.
+ *
+ * Every successful call must be followed by flash_read_wait() from the same
+ * task before data is used or flash is accessed again.  Without
+ * CONFIG_FLASH_READ_ASYNC the read completes before this returns.
+ *
+ * @param offset	Flash offset to read.
+ * @param size	        Number of bytes to read.
+ * @param data          Destination buffer for data.  Must be 32-bit aligned.
+ */
+int flash_read_async(int offset, int size, char *data);
+
+/**
+ * Wait for the read started by flash_read_async() to complete.
+ *
+ * @return EC_SUCCESS, or non-zero if the read failed.
+ */
+int flash_read_wait(void);
+
 /**
  * Write to flash.
  *
@@ -263,6 +263,31 @@ struct deferred_data {
 	void (*routine)(void);
 };
 
+/* Number of late-start histogram buckets, see EC_HOOK_STATS_LATE_BUCKETS */
+#define HOOK_STATS_LATE_BUCKETS 8
+
+/* Per-routine profile of a hook or deferred function, see CONFIG_HOOK_DEBUG */
+struct hook_routine_stats {
+	uint32_t calls;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint16_t late[HOOK_STATS_LATE_BUCKETS];
+};
+
+/*
+ * Slot of the deferred call queue, a binary min-heap owned by the hook task.
+ * The deadline and func fields describe the heap node at this slot; the pos
+ * field belongs to the deferred routine with the same index as the slot.
+ */
+struct deferred_queue_slot {
+	/* Low 32 bits of the firing time of the heap node */
+	uint32_t deadline;
+	/* Index into __deferred_funcs of the heap node */
+	uint16_t func;
+	/* Heap slot + 1 of the routine with this index, 0 if not queued */
+	uint16_t pos;
+};
+
 /**
  * Start a timer to call a deferred routine.
  *
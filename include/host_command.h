@@ -128,6 +128,20 @@ struct host_command {
 	int version_mask;
 };
 
+/* Number of handler time histogram buckets, see EC_HOST_STATS_BUCKETS */
+#define HOST_COMMAND_STATS_BUCKETS 12
+
+/* Per-command profile of a host command handler, see CONFIG_HOSTCMD_STATS */
+struct host_command_stats {
+	uint32_t calls;
+	uint32_t errors;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint16_t hist[HOST_COMMAND_STATS_BUCKETS];
+	uint16_t last_error;
+};
+
 #ifdef CONFIG_HOST_EVENT64
 typedef uint64_t host_event_t;
 #define HOST_EVENT_CPRINTS(str, e)	CPRINTS("%s 0x%016" PRIx64, str, e)
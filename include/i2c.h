@@ -11,6 +11,7 @@
 #include "common.h"
 #include "gpio.h"
 #include "host_command.h"
+#include "task_id.h"
 #include "stddef.h"
 
 /*
@@ -197,6 +198,91 @@ int i2c_xfer_unlocked(const int port,
 		      const uint8_t *out, int out_size,
 		      uint8_t *in, int in_size, int flags);
 
+/* Priority classes for i2c_xfer_async(), highest first */
+enum i2c_async_prio {
+	I2C_ASYNC_PRIO_HIGH,
+	I2C_ASYNC_PRIO_NORMAL,
+	I2C_ASYNC_PRIO_LOW,
+	I2C_ASYNC_PRIO_COUNT
+};
+
+/* State of an asynchronous I2C request */
+enum i2c_async_state {
+	I2C_ASYNC_IDLE,		/* Never submitted, or cancelled */
+	I2C_ASYNC_QUEUED,	/* Waiting in its port queue */
+	I2C_ASYNC_RUNNING,	/* Transfer in progress */
+	I2C_ASYNC_DONE,		/* Finished; rv holds the result */
+};
+
+/*
+ * Asynchronous I2C request.  The caller owns the request and its buffers, and
+ * must keep them valid until the request is done or cancelled.
+ */
+struct i2c_async_req {
+	/* Transfer, as for i2c_xfer() */
+	int port;
+	uint16_t slave_addr_flags;
+	const uint8_t *out;
+	int out_size;
+	uint8_t *in;
+	int in_size;
+
+	enum i2c_async_prio prio;
+
+	/*
+	 * Completion notification; either or both may be used.  complete() is
+	 * called from the I2C async task, so it must not block for long.  If
+	 * event is non-zero it is set on task once the request is done.
+	 */
+	void (*complete)(struct i2c_async_req *req);
+	task_id_t task;
+	uint32_t event;
+
+	/* Result, valid once state is I2C_ASYNC_DONE */
+	int rv;
+	volatile enum i2c_async_state state;
+
+	/* Private to common/i2c_async.c */
+	struct i2c_async_req *next;
+};
+
+/**
+ * Queue an I2C transfer.
+ *
+ * Requests on a port run one at a time, highest priority class first and in
+ * submission order within a class.  Ports served by different I2C async tasks
+ * run concurrently.  If no I2C async task serves the port, the transfer runs
+ * before this function returns.
+ *
+ * Must be called from task context.
+ *
+ * @param req		Request to queue
+ * @return EC_SUCCESS if queued, EC_ERROR_BUSY if req is already queued or
+ *         running, or EC_ERROR_INVAL if the port or priority is invalid.
+ */
+int i2c_xfer_async(struct i2c_async_req *req);
+
+/**
+ * Remove a queued I2C request which has not started yet.
+ *
+ * @param req		Request to cancel
+ * @return EC_SUCCESS if the request was removed (or was not queued), or
+ *         EC_ERROR_BUSY if it is already running.
+ */
+int i2c_async_cancel(struct i2c_async_req *req);
+
+/**
+ * Task which runs queued asynchronous I2C requests.
+ *
+ * @param u		Bitmask of the port numbers to serve, cast to a pointer;
+ *			NULL serves every port not claimed by another I2C
+ *			async task.  A board may run one task per busy port,
+ *			e.g.
+ *			TASK_ALWAYS(I2C_ASYNC0, i2c_async_task, (void *)BIT(0),
+ *				    TASK_STACK_SIZE)
+ */
+void i2c_async_task(void *u);
+
 #define I2C_LINE_SCL_HIGH BIT(0)
 #define I2C_LINE_SDA_HIGH BIT(1)
 #define I2C_LINE_IDLE (I2C_LINE_SCL_HIGH | I2C_LINE_SDA_HIGH)
@@ -566,6 +652,47 @@ void i2c_trace_notify(int port, uint16_t slave_addr_flags,
 		      const uint8_t *out_data, size_t out_size,
 		      const uint8_t *in_data, size_t in_size);
 
+/**
+ * Defined in common/i2c_stats.c, used by i2c master to count a transfer.
+ *
+ * @param port: I2C port number
+ * @param slave_addr_flags: slave device address
+ * @param bytes: number of bytes written and read
+ * @param rv: result of the transfer
+ * @param us: time the transfer took
+ */
+void i2c_stats_xfer(int port, uint16_t slave_addr_flags, int bytes, int rv,
+		    uint32_t us);
+
+/**
+ * Defined in common/i2c_stats.c, used by i2c master to count a transfer
+ * which is about to be repeated because the bus was busy.
+ *
+ * @param port: I2C port number
+ * @param slave_addr_flags: slave device address
+ */
+void i2c_stats_retry(int port, uint16_t slave_addr_flags);
+
+/**
+ * Defined in common/i2c_trace_buffer.c, used by i2c master to record a
+ * transfer in the trace buffer.
+ *
+ * @param port: I2C port number
+ * @param slave_addr_flags: slave device address
+ * @param out_data: pointer to data written
+ * @param out_size: size of data written
+ * @param in_data: pointer to data read
+ * @param in_size: size of data read
+ * @param flags: I2C_XFER_* flags of the transfer
+ * @param rv: result of the transfer
+ * @param start: get_time().le.lo when the transfer started
+ * @param us: time the transfer took
+ */
+void i2c_trace_buffer_record(int port, uint16_t slave_addr_flags,
+			     const uint8_t *out_data, int out_size,
+			     const uint8_t *in_data, int in_size,
+			     int flags, int rv, uint32_t start, uint32_t us);
+
 /**
  * Set bus speed. Only support for ports with I2C_PORT_FLAG_DYNAMIC_SPEED
  * flag.
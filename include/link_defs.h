@@ -77,11 +77,28 @@ extern const struct hook_data __hooks_usb_pd_disconnect_end[];
 extern const struct hook_data __hooks_usb_pd_connect[];
 extern const struct hook_data __hooks_usb_pd_connect_end[];
 
+/* Priority-sorted call order of the hooks above, see hook_notify() */
+extern uint16_t __hooks_order[];
+extern uint16_t __hooks_order_end[];
+
+/*
+ * Per-routine profiles of hooks and deferred functions, see CONFIG_HOOK_DEBUG
+ */
+extern struct hook_routine_stats __hooks_stats[];
+extern struct hook_routine_stats __hooks_stats_end[];
+extern struct hook_routine_stats __deferred_stats[];
+extern struct hook_routine_stats __deferred_stats_end[];
+
 /* Deferrable functions and firing times*/
 extern const struct deferred_data __deferred_funcs[];
 extern const struct deferred_data __deferred_funcs_end[];
 extern uint64_t __deferred_until[];
 extern uint64_t __deferred_until_end[];
+/* Deferred call queue and pending arm/cancel requests, see hook_task() */
+extern struct deferred_queue_slot __deferred_queue[];
+extern struct deferred_queue_slot __deferred_queue_end[];
+extern uint32_t __deferred_pending[];
+extern uint32_t __deferred_pending_end[];
 
 /* I2C fake devices for unit testing */
 extern const struct test_i2c_xfer __test_i2c_xfer[];
@@ -91,6 +108,10 @@ extern const struct test_i2c_xfer __test_i2c_xfer_end[];
 extern const struct host_command __hcmds[];
 extern const struct host_command __hcmds_end[];
 
+/* Per-command handler profiles, see CONFIG_HOSTCMD_STATS */
+extern struct host_command_stats __hcmds_stats[];
+extern struct host_command_stats __hcmds_stats_end[];
+
 /* MKBP events */
 extern const struct mkbp_event_source __mkbp_evt_srcs[];
 extern const struct mkbp_event_source __mkbp_evt_srcs_end[];
@@ -14,6 +14,9 @@ void mock_tcpci_set_reg(int reg, uint16_t value);
 
 uint16_t mock_tcpci_get_reg(int reg_offset);
 
+/* Number of I2C transactions made with the mock since the last reset */
+int mock_tcpci_get_xfer_count(void);
+
 int verify_tcpci_transmit(enum tcpm_transmit_type tx_type,
 			  enum pd_ctrl_msg_type ctrl_msg,
 			  enum pd_data_msg_type data_msg);
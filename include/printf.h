@@ -76,6 +76,29 @@
 __stdlib_compat int vfnprintf(int (*addchar)(void *context, int c),
 			      void *context, const char *format, va_list args);
 
+/**
+ * Print formatted output to a function, one span at a time
+ *
+ * Same as vfnprintf(), but runs of literal characters from the format string
+ * and each formatted field are passed to the output function in a single
+ * call, so sinks which can copy in bulk avoid a call per character.
+ *
+ * @param addstr	Function to be called for each span of characters.
+ *			Will be passed the same context passed to
+ *			vfnprintf_str(), the characters to add and their
+ *			count (not null-terminated).  Should return 0 if all
+ *			characters were accepted or non-zero if any were
+ *			dropped due to overflow.
+ * @param context	Context pointer to pass to addstr()
+ * @param format	Format string (see above for acceptable formats)
+ * @param args		Parameters
+ * @return EC_SUCCESS, or EC_ERROR_OVERFLOW if the output was truncated.
+ */
+__stdlib_compat int vfnprintf_str(int (*addstr)(void *context,
+						const char *str, int len),
+				  void *context, const char *format,
+				  va_list args);
+
 /**
  * Print formatted outut to a string.
  *
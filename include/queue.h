@@ -199,6 +199,54 @@ size_t queue_advance_head(struct queue const *q, size_t count);
  */
 size_t queue_advance_tail(struct queue const *q, size_t count);
 
+/*
+ * Scatter-gather queue access.  Free space and stored units occupy at most two
+ * contiguous regions of the queue buffer, one up to the end of the buffer and
+ * one wrapped around to its start.  A queue_iovec describes both, so a caller
+ * can hand them straight to a DMA engine or a copy routine without going
+ * through an intermediate buffer.  Unused chunks have a count of zero and a
+ * NULL buffer.
+ */
+struct queue_iovec {
+	struct queue_chunk chunk[2];
+	size_t count; /* Total units in both chunks */
+};
+
+/*
+ * Fill iov with up to count units of free space from the tail of the queue and
+ * return the number of units described.  After writing some or all of that
+ * space, commit it with queue_advance_tail, as for queue_get_write_chunk.
+ */
+size_t queue_get_write_iovec(struct queue const *q, struct queue_iovec *iov,
+			     size_t count);
+
+/*
+ * Fill iov with up to count units from the head of the queue and return the
+ * number of units described.  After consuming some or all of them, release
+ * them with queue_advance_head, as for queue_get_read_chunk.
+ */
+size_t queue_get_read_iovec(struct queue const *q, struct queue_iovec *iov,
+			    size_t count);
+
+/*
+ * Lock-free single-producer/single-consumer access.  One context (a task or
+ * an interrupt handler) may add units while another removes them, with no
+ * interrupt locking and no other synchronization.  The producer is the only
+ * writer of the tail and the consumer the only writer of the head; each
+ * publishes its index with release ordering after touching the buffer, and
+ * reads the other's with acquire ordering before touching it.
+ *
+ * Each call copies as many units as it can and then notifies the queue
+ * policy once for the whole batch, and not at all if nothing moved.
+ *
+ * A queue used this way must not also be accessed through the functions
+ * above from a third context while the producer and consumer are running.
+ */
+size_t queue_spsc_add_units(struct queue const *q, const void *src,
+			    size_t count);
+size_t queue_spsc_remove_units(struct queue const *q, void *dest,
+			       size_t count);
+
 /* Add one unit to queue. */
 size_t queue_add_unit(struct queue const *q, const void *src);
 
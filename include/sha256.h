@@ -29,4 +29,19 @@ uint8_t *SHA256_final(struct sha256_ctx *ctx);
 void hmac_SHA256(uint8_t *output, const uint8_t *key, const int key_len,
 		 const uint8_t *message, const int message_len);
 
+/**
+ * Run the chip hash engine over whole SHA-256 blocks.
+ *
+ * Provided by the chip when CONFIG_SHA256_HW_ACCELERATE is defined.  The
+ * engine must continue from the intermediate state in h and leave the updated
+ * state there, so that partial blocks, saved states and HMAC keep working.
+ *
+ * @param h		Intermediate hash state, updated in place
+ * @param data		Input, block_nb * SHA256_BLOCK_SIZE bytes, any alignment
+ * @param block_nb	Number of blocks to hash
+ * @return EC_SUCCESS, or an error code to hash these blocks in software.
+ */
+int chip_sha256_transform(uint32_t h[8], const uint8_t *data,
+			  unsigned int block_nb);
+
 #endif  /* __CROS_EC_SHA256_H */
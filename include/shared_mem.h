@@ -57,6 +57,54 @@ int shared_mem_acquire(int size, char **dest_ptr);
  */
 void shared_mem_release(void *ptr);
 
+#ifdef CONFIG_SHARED_MEM_SLABS
+/*
+ * Acquires a buffer of at least size bytes from the smallest slab class that
+ * fits, in constant time.  If that class is exhausted, or no class is big
+ * enough, falls back to shared_mem_acquire().  Same return values as
+ * shared_mem_acquire().
+ */
+int shared_mem_slab_acquire(int size, char **dest_ptr);
+
+/**
+ * Releases a buffer previously acquired via shared_mem_slab_acquire().
+ *
+ * Slab buffers may be released from interrupt context, though they can only
+ * be acquired from a task.  Buffers which fell back to shared memory are
+ * released with shared_mem_release(), with its restrictions.
+ */
+void shared_mem_slab_release(void *ptr);
+
+/* Counters for one slab class */
+struct shared_mem_slab_stats {
+	int size;		/* Buffer size in bytes */
+	int count;		/* Number of buffers in the class */
+	int in_use;		/* Buffers currently acquired */
+	int peak;		/* Highest in_use seen */
+	uint32_t acquired;	/* Buffers handed out by this class */
+	uint32_t fallbacks;	/* Requests sent to shared memory when full */
+};
+
+/**
+ * Reads the counters of a slab class.
+ *
+ * @param class		Slab class index, smallest size first
+ * @param stats		Filled in with the counters of the class
+ * @return EC_SUCCESS, or EC_ERROR_INVAL if there is no such class.
+ */
+int shared_mem_slab_get_stats(int class, struct shared_mem_slab_stats *stats);
+#else
+static inline int shared_mem_slab_acquire(int size, char **dest_ptr)
+{
+	return shared_mem_acquire(size, dest_ptr);
+}
+
+static inline void shared_mem_slab_release(void *ptr)
+{
+	shared_mem_release(ptr);
+}
+#endif
+
 /*
  * This structure is allocated at the base of the free memory chunk and every
  * allocated buffer.
@@ -191,6 +191,13 @@ uint32_t prng(uint32_t seed);
 
 uint32_t prng_no_seed(void);
 
+/*
+ * Microsecond timestamp for benchmarks.  On the emulator get_time() only
+ * advances by one on each call, so this reads the host monotonic clock
+ * instead; elsewhere it is get_time().
+ */
+uint64_t test_get_bench_time(void);
+
 /* Number of failed tests */
 extern int __test_error_count;
 
@@ -211,6 +218,17 @@ void test_capture_console(int enabled);
 /* Get captured console output */
 const char *test_get_captured_console(void);
 
+/* Transmit statistics of the emulated UART */
+struct uart_tx_stats {
+	uint64_t bytes;		/* Characters sent */
+	uint64_t writes;	/* Calls to send characters */
+	uint64_t cpu_ns;	/* CPU time spent in uart_process_output() */
+};
+
+/* Get/reset transmit statistics of the emulated UART */
+void test_get_uart_tx_stats(struct uart_tx_stats *stats);
+void test_reset_uart_tx_stats(void);
+
 /*
  * Flush emulator status. Must be called before emulator reboots or
  * exits.
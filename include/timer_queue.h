@@ -0,0 +1,69 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Deadline-sorted queue of armed timers, used by the timer module */
+
+#ifndef __CROS_EC_TIMER_QUEUE_H
+#define __CROS_EC_TIMER_QUEUE_H
+
+#include "common.h"
+#include "task_id.h"
+#include "timer.h"
+
+/*
+ * The queue holds task IDs, earliest deadline first.  It does not track
+ * which timers are running; the caller passes its bitmap of running timers
+ * in, and entries of timers which stopped running are dropped when they
+ * reach the front.
+ */
+struct timer_queue {
+	uint8_t tskid[TASK_ID_COUNT];
+	int len;
+};
+
+/**
+ * Requeue timers armed since the last update.
+ *
+ * A timer may have been cancelled and re-armed with a new deadline while its
+ * old entry was still queued, so the old entry is always dropped.  Those
+ * still running are inserted after any timer with the same deadline.
+ *
+ * @param q		Queue to update
+ * @param armed		Bitmap of timers armed since the last update
+ * @param running	Bitmap of running timers
+ * @param deadline	Deadlines of all timers, indexed by task ID
+ */
+void timer_queue_update(struct timer_queue *q, uint32_t armed,
+			uint32_t running, const timestamp_t *deadline);
+
+/**
+ * Remove the first timer due at a given time from the queue.
+ *
+ * @param q		Queue to pop from
+ * @param running	Bitmap of running timers
+ * @param deadline	Deadlines of all timers, indexed by task ID
+ * @param now		Current time
+ * @return The task ID of the expired timer, or -1 if none is due.
+ */
+int timer_queue_pop_expired(struct timer_queue *q, uint32_t running,
+			    const timestamp_t *deadline, timestamp_t now);
+
+/**
+ * Get the deadline to program into the hardware comparator.
+ *
+ * The comparator only holds the low 32 bits, so a deadline in a later epoch
+ * than now waits for the overflow interrupt instead.  Call this after
+ * timer_queue_pop_expired(), so the front entry is a running timer.
+ *
+ * @param q		Queue to look at
+ * @param deadline	Deadlines of all timers, indexed by task ID
+ * @param now		Current time
+ * @param next		Set to the deadline of the front timer
+ * @return 1 if next was set, 0 if there is no deadline in this epoch.
+ */
+int timer_queue_next(const struct timer_queue *q, const timestamp_t *deadline,
+		     timestamp_t now, timestamp_t *next);
+
+#endif  /* __CROS_EC_TIMER_QUEUE_H */
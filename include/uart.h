@@ -172,6 +172,19 @@ int uart_rx_dma_head(void);
  */
 void uart_write_char(char c);
 
+/**
+ * Send characters to the UART without blocking.
+ *
+ * Sends as many of the characters as the transmitter can take right now.  The
+ * default implementation calls uart_write_char() while uart_tx_ready(); chips
+ * with a transmit FIFO may override it to fill the FIFO in one go.
+ *
+ * @param src		Characters to send.
+ * @param len		Number of characters to send.
+ * @return Number of characters sent, from 0 to len.
+ */
+__override_proto int uart_write_buf(const char *src, int len);
+
 /**
  * Read one char from the UART data register.
  *
@@ -37,6 +37,20 @@ int vboot_get_rw_hash(const uint8_t **dst);
  */
 int vboot_hash_invalidate(int offset, int size);
 
+/**
+ * Drop the saved hash states that depend on a flash region about to change.
+ * Called by every flash_physical_write() and flash_physical_erase(), so that
+ * writes which bypass flash_write() are seen too.
+ *
+ * @param offset	Region start offset in flash
+ * @param size		Size of region in bytes
+ */
+#ifdef CONFIG_VBOOT_HASH_CACHE
+void vboot_hash_cache_invalidate(int offset, int size);
+#else
+static inline void vboot_hash_cache_invalidate(int offset, int size) {}
+#endif
+
 /**
  * Get vboot progress status.
  *
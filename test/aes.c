@@ -26,6 +26,9 @@
 /* Temporary buffer, to avoid using too much stack space. */
 static uint8_t tmp[512];
 
+/* Run the GCM tests through the bulk CTR entry points. */
+static int use_ctr32;
+
 /*
  * Do encryption, put result in |result|, and compare with |ciphertext|.
  */
@@ -47,8 +50,13 @@ static int test_aes_gcm_encrypt(uint8_t *result,
 
 	CRYPTO_gcm128_init(&ctx, &aes_key, (block128_f) AES_encrypt, 0);
 	CRYPTO_gcm128_setiv(&ctx, &aes_key, nonce, nonce_size);
-	TEST_ASSERT(CRYPTO_gcm128_encrypt(&ctx, &aes_key, plaintext, result,
-					  plaintext_size));
+	if (use_ctr32)
+		TEST_ASSERT(CRYPTO_gcm128_encrypt_ctr32(&ctx, &aes_key,
+				plaintext, result, plaintext_size,
+				(ctr128_f)AES_ctr32_encrypt_blocks));
+	else
+		TEST_ASSERT(CRYPTO_gcm128_encrypt(&ctx, &aes_key, plaintext,
+						  result, plaintext_size));
 	TEST_ASSERT(CRYPTO_gcm128_finish(&ctx, tag, tag_size));
 	TEST_ASSERT_ARRAY_EQ(ciphertext, result, plaintext_size);
 
@@ -76,8 +84,13 @@ static int test_aes_gcm_decrypt(uint8_t *result,
 
 	CRYPTO_gcm128_init(&ctx, &aes_key, (block128_f) AES_encrypt, 0);
 	CRYPTO_gcm128_setiv(&ctx, &aes_key, nonce, nonce_size);
-	TEST_ASSERT(CRYPTO_gcm128_decrypt(&ctx, &aes_key, ciphertext, result,
-					  plaintext_size));
+	if (use_ctr32)
+		TEST_ASSERT(CRYPTO_gcm128_decrypt_ctr32(&ctx, &aes_key,
+				ciphertext, result, plaintext_size,
+				(ctr128_f)AES_ctr32_encrypt_blocks));
+	else
+		TEST_ASSERT(CRYPTO_gcm128_decrypt(&ctx, &aes_key, ciphertext,
+						  result, plaintext_size));
 	TEST_ASSERT(CRYPTO_gcm128_finish(&ctx, tag, tag_size));
 	TEST_ASSERT_ARRAY_EQ(plaintext, result, plaintext_size);
 
@@ -515,11 +528,11 @@ static void test_aes_gcm_speed(void)
 	uint8_t *out = tmp;
 	static AES_KEY aes_key;
 	static GCM128_CONTEXT ctx;
-	timestamp_t t0, t1;
+	uint64_t t0, t1, t2;
 
 	assert(plaintext_size <= sizeof(tmp));
 
-	t0 = get_time();
+	t0 = test_get_bench_time();
 	for (i = 0; i < 1000; i++) {
 		AES_set_encrypt_key(key, 8 * key_size, &aes_key);
 		CRYPTO_gcm128_init(&ctx, &aes_key, (block128_f)AES_encrypt, 0);
@@ -528,8 +541,20 @@ static void test_aes_gcm_speed(void)
 				plaintext_size);
 		CRYPTO_gcm128_tag(&ctx, tag, tag_size);
 	}
-	t1 = get_time();
-	ccprintf("AES-GCM duration %lld us\n", (long long)(t1.val - t0.val));
+	t1 = test_get_bench_time();
+	for (i = 0; i < 1000; i++) {
+		AES_set_encrypt_key(key, 8 * key_size, &aes_key);
+		CRYPTO_gcm128_init(&ctx, &aes_key, (block128_f)AES_encrypt, 0);
+		CRYPTO_gcm128_setiv(&ctx, &aes_key, nonce, nonce_size);
+		CRYPTO_gcm128_encrypt_ctr32(&ctx, &aes_key, plaintext, out,
+				plaintext_size,
+				(ctr128_f)AES_ctr32_encrypt_blocks);
+		CRYPTO_gcm128_tag(&ctx, tag, tag_size);
+	}
+	t2 = test_get_bench_time();
+	ccprintf("AES-GCM duration %lld us, ctr32 %lld us (%d KiB)\n",
+		 (long long)(t1 - t0), (long long)(t2 - t1),
+		 1000 * plaintext_size / 1024);
 }
 
 static int test_aes_raw(const uint8_t *key, int key_size,
@@ -660,5 +685,10 @@ void run_test(int argc, char **argv)
 	watchdog_reload();
 	RUN_TEST(test_aes_gcm);
 
+	watchdog_reload();
+	use_ctr32 = 1;
+	RUN_TEST(test_aes_gcm);
+	use_ctr32 = 0;
+
 	test_print_result();
 }
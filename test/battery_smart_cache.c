@@ -0,0 +1,364 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the smart battery register cache.
+ */
+
+#include "battery.h"
+#include "battery_smart.h"
+#include "common.h"
+#include "ec_commands.h"
+#include "hooks.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+void battery_compensate_params(struct batt_params *batt)
+{
+}
+
+void board_battery_compensate_params(struct batt_params *batt)
+{
+}
+
+static uint16_t regs[SB_MANUFACTURER_DATA + 1];
+static int bus_reads;
+static int snapshots;
+
+/* Fake gauge, which counts the reads that reach it */
+static int battery_xfer(const int port, const uint16_t slave_addr_flags,
+			const uint8_t *out, int out_size,
+			uint8_t *in, int in_size, int flags)
+{
+	if (port != I2C_PORT_BATTERY || slave_addr_flags != BATTERY_ADDR_FLAGS)
+		return EC_ERROR_INVAL;
+	if (!out_size) {
+		/* Rest of a block read */
+		memset(in, 0, in_size);
+		return EC_SUCCESS;
+	}
+	if (out[0] >= ARRAY_SIZE(regs))
+		return EC_ERROR_UNKNOWN;
+
+	if (out_size == 3) {
+		regs[out[0]] = out[1] | out[2] << 8;
+		return EC_SUCCESS;
+	}
+
+	/* Block reads are a count byte, then the string */
+	if (!(flags & I2C_XFER_START))
+		return EC_SUCCESS;
+	bus_reads++;
+	if (in_size == 2) {
+		in[0] = regs[out[0]] & 0xff;
+		in[1] = regs[out[0]] >> 8;
+	} else if (in_size) {
+		memset(in, 0, in_size);
+	}
+	return EC_SUCCESS;
+}
+DECLARE_TEST_I2C_XFER(battery_xfer);
+
+/* Pretend the gauge returns temperature and charge in one block */
+__override int board_battery_snapshot(void)
+{
+	snapshots++;
+	sb_cache_fill(SB_TEMPERATURE, 2981);
+	sb_cache_fill(SB_RELATIVE_STATE_OF_CHARGE, 50);
+	return EC_SUCCESS;
+}
+
+/* Change a register behind the cache's back, as the gauge would */
+static void set_reg(int cmd, int value)
+{
+	regs[cmd] = value;
+}
+
+static void advance_ms(int ms)
+{
+	timestamp_t now = get_time();
+
+	now.val += ms * MSEC;
+	force_time(now);
+}
+
+static void reset(void)
+{
+	sb_cache_invalidate(1);
+	bus_reads = 0;
+	snapshots = 0;
+}
+
+static int test_word_cache(void)
+{
+	struct sb_cache_stats before, after;
+	int v;
+
+	reset();
+	set_reg(SB_AVERAGE_TIME_TO_EMPTY, 100);
+	sb_cache_get_stats(&before);
+
+	TEST_EQ(sb_read(SB_AVERAGE_TIME_TO_EMPTY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 100, "%d");
+	TEST_EQ(sb_read(SB_AVERAGE_TIME_TO_EMPTY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 100, "%d");
+	TEST_EQ(bus_reads, 1, "%d");
+
+	sb_cache_get_stats(&after);
+	TEST_EQ(after.hits - before.hits, 1, "%d");
+	TEST_EQ(after.misses - before.misses, 1, "%d");
+
+	/* A change is not seen until the entry expires */
+	set_reg(SB_AVERAGE_TIME_TO_EMPTY, 99);
+	TEST_EQ(sb_read(SB_AVERAGE_TIME_TO_EMPTY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 100, "%d");
+	advance_ms(1001);
+	TEST_EQ(sb_read(SB_AVERAGE_TIME_TO_EMPTY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 99, "%d");
+	TEST_EQ(bus_reads, 2, "%d");
+
+	/*
+	 * Voltage, current and the charging voltage and current always come
+	 * from the battery
+	 */
+	TEST_EQ(sb_read(SB_VOLTAGE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_VOLTAGE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_CURRENT, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_CURRENT, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_CHARGING_VOLTAGE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_CHARGING_VOLTAGE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_CHARGING_CURRENT, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_CHARGING_CURRENT, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 10, "%d");
+
+	/* The gauge sets bits in BatteryMode itself, so it expires too */
+	set_reg(SB_BATTERY_MODE, 0x6001);
+	TEST_EQ(sb_read(SB_BATTERY_MODE, &v), EC_SUCCESS, "%d");
+	set_reg(SB_BATTERY_MODE, 0x6081);
+	TEST_EQ(sb_read(SB_BATTERY_MODE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 0x6001, "0x%x");
+	advance_ms(1001);
+	TEST_EQ(sb_read(SB_BATTERY_MODE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 0x6081, "0x%x");
+	TEST_EQ(bus_reads, 12, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_adaptive_ttl(void)
+{
+	int v;
+
+	reset();
+	set_reg(SB_TEMPERATURE, 2981);
+
+	/* 1 s, then 2 s, then 4 s while the value holds still */
+	TEST_EQ(sb_read(SB_TEMPERATURE, &v), EC_SUCCESS, "%d");
+	advance_ms(1001);
+	TEST_EQ(sb_read(SB_TEMPERATURE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 2, "%d");
+	advance_ms(1500);
+	TEST_EQ(sb_read(SB_TEMPERATURE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 2, "%d");
+	advance_ms(501);
+	TEST_EQ(sb_read(SB_TEMPERATURE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 3, "%d");
+
+	/* A change drops back to the shortest TTL */
+	set_reg(SB_TEMPERATURE, 2991);
+	advance_ms(4001);
+	TEST_EQ(sb_read(SB_TEMPERATURE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 2991, "%d");
+	TEST_EQ(bus_reads, 4, "%d");
+	advance_ms(1001);
+	TEST_EQ(sb_read(SB_TEMPERATURE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 5, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_invalidation(void)
+{
+	int v;
+
+	reset();
+	set_reg(SB_DESIGN_CAPACITY, 5000);
+	set_reg(SB_REMAINING_CAPACITY, 2500);
+	set_reg(SB_BATTERY_STATUS, 0x40);
+
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_REMAINING_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_BATTERY_STATUS, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 3, "%d");
+
+	/* Static registers live until something flushes them */
+	advance_ms(MINUTE / MSEC);
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 3, "%d");
+
+	/* A write drops the dynamic registers only */
+	TEST_EQ(sb_read(SB_REMAINING_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 4, "%d");
+	TEST_EQ(sb_write(SB_AT_RATE, 0), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_REMAINING_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 5, "%d");
+
+	/* So does a change in status, or in AC */
+	set_reg(SB_BATTERY_STATUS, 0x60);
+	TEST_EQ(sb_read(SB_BATTERY_STATUS, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_REMAINING_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 7, "%d");
+	hook_notify(HOOK_AC_CHANGE);
+	TEST_EQ(sb_read(SB_REMAINING_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 8, "%d");
+
+	/* Changing the capacity mode drops everything */
+	TEST_EQ(sb_write(SB_BATTERY_MODE, 0), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 9, "%d");
+
+	/* As does a failed read, since the battery may have been swapped */
+	TEST_EQ(test_detach_i2c(I2C_PORT_BATTERY, BATTERY_ADDR_FLAGS),
+		EC_SUCCESS, "%d");
+	TEST_NE(sb_read(SB_VOLTAGE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(test_attach_i2c(I2C_PORT_BATTERY, BATTERY_ADDR_FLAGS),
+		EC_SUCCESS, "%d");
+	bus_reads = 0;
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 5000, "%d");
+	TEST_EQ(bus_reads, 1, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int passthru(const uint8_t *out, int out_size, int in_size)
+{
+	struct {
+		struct ec_params_i2c_passthru p;
+		struct ec_params_i2c_passthru_msg msg[2];
+		uint8_t out[4];
+	} __packed params = {
+		.p.port = I2C_PORT_BATTERY,
+		.p.num_msgs = in_size ? 2 : 1,
+	};
+	struct {
+		struct ec_response_i2c_passthru r;
+		uint8_t in[2];
+	} __packed resp;
+	int n = params.p.num_msgs;
+
+	params.msg[0].addr_flags = BATTERY_ADDR_FLAGS;
+	params.msg[0].len = out_size;
+	params.msg[1].addr_flags = BATTERY_ADDR_FLAGS | EC_I2C_FLAG_READ;
+	params.msg[1].len = in_size;
+	/* The write data follows the messages actually used */
+	memcpy((uint8_t *)&params.msg[n], out, out_size);
+
+	return test_send_host_command(EC_CMD_I2C_PASSTHRU, 0, &params,
+				      sizeof(params.p) +
+				      n * sizeof(params.msg[0]) + out_size,
+				      &resp, sizeof(resp));
+}
+
+static int test_passthru(void)
+{
+	static const uint8_t read_mode[] = {SB_BATTERY_MODE};
+	static const uint8_t write_mode[] = {SB_BATTERY_MODE, 0x00, 0x01};
+	int v;
+
+	reset();
+	set_reg(SB_BATTERY_MODE, 0);
+	set_reg(SB_DESIGN_CAPACITY, 5000);
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(sb_read(SB_BATTERY_MODE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 2, "%d");
+
+	/* A read through passthru leaves the cache alone */
+	TEST_EQ(passthru(read_mode, sizeof(read_mode), 2), EC_RES_SUCCESS,
+		"%d");
+	TEST_EQ(bus_reads, 3, "%d");
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 3, "%d");
+
+	/* A write drops everything, as the host may have changed the mode */
+	TEST_EQ(passthru(write_mode, sizeof(write_mode), 0), EC_RES_SUCCESS,
+		"%d");
+	set_reg(SB_DESIGN_CAPACITY, 500);
+	TEST_EQ(sb_read(SB_BATTERY_MODE, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 0x0100, "0x%x");
+	TEST_EQ(sb_read(SB_DESIGN_CAPACITY, &v), EC_SUCCESS, "%d");
+	TEST_EQ(v, 500, "%d");
+	TEST_EQ(bus_reads, 5, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_strings(void)
+{
+	char name[8];
+
+	reset();
+	TEST_EQ(battery_device_name(name, sizeof(name)), EC_SUCCESS, "%d");
+	TEST_EQ(battery_device_name(name, sizeof(name)), EC_SUCCESS, "%d");
+	TEST_EQ(battery_device_chemistry(name, sizeof(name)), EC_SUCCESS,
+		"%d");
+	TEST_EQ(battery_device_chemistry(name, 4), EC_SUCCESS, "%d");
+	TEST_EQ(bus_reads, 2, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_get_params(void)
+{
+	struct batt_params batt;
+	struct sb_cache_stats stats;
+	int first;
+
+	reset();
+	set_reg(SB_TEMPERATURE, 0);
+
+	battery_get_params(&batt);
+	TEST_ASSERT(!(batt.flags & BATT_FLAG_BAD_ANY));
+	TEST_EQ(snapshots, 1, "%d");
+	/* Values from the snapshot are used without another read */
+	TEST_EQ(batt.temperature, 2981, "%d");
+	TEST_EQ(batt.state_of_charge, 50, "%d");
+	first = bus_reads;
+
+	/*
+	 * A second pass only reads voltage, current, status and the charging
+	 * voltage and current
+	 */
+	bus_reads = 0;
+	battery_get_params(&batt);
+	TEST_ASSERT(!(batt.flags & BATT_FLAG_BAD_ANY));
+	TEST_EQ(snapshots, 1, "%d");
+	TEST_EQ(bus_reads, 5, "%d");
+	TEST_ASSERT(bus_reads < first);
+
+	sb_cache_get_stats(&stats);
+	TEST_EQ(stats.snapshots, 1, "%d");
+	ccprintf("first pass %d reads, second pass %d reads\n", first,
+		 bus_reads);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_word_cache);
+	RUN_TEST(test_adaptive_ttl);
+	RUN_TEST(test_invalidation);
+	RUN_TEST(test_passthru);
+	RUN_TEST(test_strings);
+	RUN_TEST(test_get_params);
+
+	test_print_result();
+}
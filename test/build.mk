@@ -15,6 +15,7 @@ test-list-host = accel_cal
 test-list-host += aes
 test-list-host += base32
 test-list-host += battery_get_params_smart
+test-list-host += battery_smart_cache
 test-list-host += bklight_lid
 test-list-host += bklight_passthru
 test-list-host += body_detection
@@ -25,8 +26,12 @@ test-list-host += charge_manager
 test-list-host += charge_manager_drp_charging
 test-list-host += charge_ramp
 test-list-host += compile_time_macros
+test-list-host += console_binlog
 test-list-host += console_edit
 test-list-host += crc32
+test-list-host += crc32_nibble
+test-list-host += crc32_slice4
+test-list-host += crc32_slice8
 test-list-host += entropy
 test-list-host += extpwr_gpio
 test-list-host += fan
@@ -38,8 +43,12 @@ test-list-host += fpsensor_crypto
 test-list-host += fpsensor_state
 test-list-host += gyro_cal
 test-list-host += hooks
+test-list-host += hooks_debug
 test-list-host += host_command
+test-list-host += i2c_async
 test-list-host += i2c_bitbang
+test-list-host += i2c_stats
+test-list-host += i2c_trace_buffer
 test-list-host += inductive_charging
 test-list-host += interrupt
 test-list-host += is_enabled
@@ -65,16 +74,22 @@ test-list-host += printf
 test-list-host += queue
 test-list-host += rsa
 test-list-host += rsa3
+test-list-host += rsa3072
+test-list-host += rsa4096
 test-list-host += rtc
 test-list-host += sbs_charging_v2
 test-list-host += sha256
+test-list-host += sha256_hw
 test-list-host += sha256_unrolled
 test-list-host += shmalloc
+test-list-host += shmem_slab
 test-list-host += static_if
 test-list-host += static_if_error
 test-list-host += system
 test-list-host += thermal
 test-list-host += timer_dos
+test-list-host += timer_queue
+test-list-host += uart_tx
 test-list-host += uptime
 test-list-host += usb_common
 test-list-host += usb_pd_int
@@ -91,6 +106,7 @@ test-list-host += usb_typec_ctvpd
 test-list-host += usb_typec_drp_acc_trysrc
 test-list-host += usb_prl_old
 test-list-host += usb_tcpmv2_tcpci
+test-list-host += usb_tcpmv2_tcpci_burst
 test-list-host += usb_prl
 test-list-host += usb_prl_noextended
 test-list-host += usb_pe_drp_old
@@ -100,6 +116,8 @@ test-list-host += usb_pe_drp_noextended
 test-list-host += utils
 test-list-host += utils_str
 test-list-host += vboot
+test-list-host += vboot_hash
+test-list-host += vboot_hash_pipeline
 test-list-host += x25519
 test-list-host += stillness_detector
 endif
@@ -123,6 +141,7 @@ accel_cal-y=accel_cal.o
 aes-y=aes.o
 base32-y=base32.o
 battery_get_params_smart-y=battery_get_params_smart.o
+battery_smart_cache-y=battery_smart_cache.o
 bklight_lid-y=bklight_lid.o
 bklight_passthru-y=bklight_passthru.o
 body_detection-y=body_detection.o body_detection_data_literals.o motion_common.o
@@ -133,8 +152,12 @@ charge_manager-y=charge_manager.o
 charge_manager_drp_charging-y=charge_manager.o
 charge_ramp-y+=charge_ramp.o
 compile_time_macros-y=compile_time_macros.o
+console_binlog-y=console_binlog.o
 console_edit-y=console_edit.o
 crc32-y=crc32.o
+crc32_nibble-y=crc32.o
+crc32_slice4-y=crc32.o
+crc32_slice8-y=crc32.o
 entropy-y=entropy.o
 extpwr_gpio-y=extpwr_gpio.o
 fan-y=fan.o
@@ -146,8 +169,12 @@ fpsensor_crypto-y=fpsensor_crypto.o
 fpsensor_state-y=fpsensor_state.o
 gyro_cal-y=gyro_cal.o
 hooks-y=hooks.o
+hooks_debug-y=hooks.o
 host_command-y=host_command.o
+i2c_async-y=i2c_async.o
 i2c_bitbang-y=i2c_bitbang.o
+i2c_stats-y=i2c_stats.o
+i2c_trace_buffer-y=i2c_trace_buffer.o
 inductive_charging-y=inductive_charging.o
 interrupt-y=interrupt.o
 is_enabled-y=is_enabled.o
@@ -176,13 +203,17 @@ rollback-y=rollback.o
 rollback_entropy-y=rollback_entropy.o
 rsa-y=rsa.o
 rsa3-y=rsa.o
+rsa3072-y=rsa.o
+rsa4096-y=rsa.o
 rtc-y=rtc.o
 scratchpad-y=scratchpad.o
 sbs_charging-y=sbs_charging.o
 sbs_charging_v2-y=sbs_charging_v2.o
 sha256-y=sha256.o
+sha256_hw-y=sha256.o
 sha256_unrolled-y=sha256.o
 shmalloc-y=shmalloc.o
+shmem_slab-y=shmem_slab.o
 static_if-y=static_if.o
 stm32f_rtc-y=stm32f_rtc.o
 stress-y=stress.o
@@ -190,6 +221,8 @@ system-y=system.o
 thermal-y=thermal.o
 timer_calib-y=timer_calib.o
 timer_dos-y=timer_dos.o
+timer_queue-y=timer_queue.o
+uart_tx-y=uart_tx.o
 uptime-y=uptime.o
 usb_common-y=usb_common_test.o fake_battery.o
 usb_pd_int-y=usb_pd_int.o
@@ -213,9 +246,12 @@ usb_pe_drp_old_noextended-y=usb_pe_drp_old.o usb_sm_checks.o fake_usbc.o
 usb_pe_drp-y=usb_pe_drp.o usb_sm_checks.o
 usb_pe_drp_noextended-y=usb_pe_drp_noextended.o usb_sm_checks.o
 usb_tcpmv2_tcpci-y=usb_tcpmv2_tcpci.o vpd_api.o usb_sm_checks.o
+usb_tcpmv2_tcpci_burst-y=usb_tcpmv2_tcpci.o vpd_api.o usb_sm_checks.o
 utils-y=utils.o
 utils_str-y=utils_str.o
 vboot-y=vboot.o
+vboot_hash-y=vboot_hash.o
+vboot_hash_pipeline-y=vboot_hash.o
 float-y=fp.o
 fp-y=fp.o
 x25519-y=x25519.o
@@ -0,0 +1,236 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test binary (deferred-formatting) console logging.
+ */
+
+#include "common.h"
+#include "console.h"
+#include "console_binlog.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+static const char fmt_pe[] = "C%d: PE %s -> %s, flags 0x%08x";
+static const char fmt_misc[] = "%c %+d %llu %-*s %ph %pT %%";
+
+/* Record decoded from the captured console output */
+static uint8_t record[BINLOG_MAX_RECORD];
+static int record_len;
+static int record_pos;
+
+static int base64_value(char c)
+{
+	if (c >= 'A' && c <= 'Z')
+		return c - 'A';
+	if (c >= 'a' && c <= 'z')
+		return c - 'a' + 26;
+	if (c >= '0' && c <= '9')
+		return c - '0' + 52;
+	if (c == '+')
+		return 62;
+	if (c == '/')
+		return 63;
+	return -1;
+}
+
+/* Decode a captured "$<base64>\r\n" line into record[] */
+static int decode_line(const char *line)
+{
+	uint32_t v = 0;
+	int bits = 0;
+
+	TEST_EQ(line[0], BINLOG_MARKER, "%c");
+	record_len = 0;
+	record_pos = 0;
+
+	for (line++; *line != '\r'; line++) {
+		int d = base64_value(*line);
+
+		TEST_ASSERT(d >= 0);
+		v = (v << 6) | d;
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			TEST_ASSERT(record_len < sizeof(record));
+			record[record_len++] = v >> bits;
+		}
+	}
+	TEST_ASSERT_ARRAY_EQ(line, "\r\n", 3);
+
+	return EC_SUCCESS;
+}
+
+static uint64_t get_varint(void)
+{
+	uint64_t v = 0;
+	int shift = 0;
+	uint8_t b;
+
+	do {
+		b = record[record_pos++];
+		v |= (uint64_t)(b & 0x7f) << shift;
+		shift += 7;
+	} while (b & 0x80);
+
+	return v;
+}
+
+static int64_t get_svarint(void)
+{
+	uint64_t v = get_varint();
+
+	return (v >> 1) ^ -(v & 1);
+}
+
+/* Check the record header and return its timestamp */
+static int check_header(const char *format, enum console_channel channel,
+			uint64_t *ts)
+{
+	uint32_t id;
+
+	memcpy(&id, record, sizeof(id));
+	TEST_EQ(id, (uint32_t)(uintptr_t)format, "0x%08x");
+	TEST_EQ(record[4], channel | (IS_ENABLED(CONFIG_CONSOLE_VERBOSE) ?
+				      0 : BINLOG_TIMESTAMP_MSEC), "%d");
+	record_pos = 5;
+	*ts = get_varint();
+
+	return EC_SUCCESS;
+}
+
+static int check_string(const char *expect)
+{
+	int len = get_varint();
+
+	TEST_EQ(len, (int)strlen(expect), "%d");
+	TEST_ASSERT_ARRAY_EQ(&record[record_pos], expect, len);
+	record_pos += len;
+
+	return EC_SUCCESS;
+}
+
+static int test_record(void)
+{
+	uint64_t before = get_time().val;
+	uint64_t ts;
+
+	test_capture_console(1);
+	cprints(CC_USBCHARGE, fmt_pe, 1, "SRC_READY", "SRC_TRANSITION",
+		0xdeadbeef);
+	cflush();
+	test_capture_console(0);
+
+	TEST_ASSERT(decode_line(test_get_captured_console()) == EC_SUCCESS);
+	TEST_ASSERT(check_header(fmt_pe, CC_USBCHARGE, &ts) == EC_SUCCESS);
+	TEST_ASSERT(ts >= before && ts <= get_time().val);
+	TEST_ASSERT(get_svarint() == 1LL);
+	TEST_ASSERT(check_string("SRC_READY") == EC_SUCCESS);
+	TEST_ASSERT(check_string("SRC_TRANSITION") == EC_SUCCESS);
+	TEST_ASSERT(get_varint() == 0xdeadbeefULL);
+	TEST_EQ(record_pos, record_len, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_conversions(void)
+{
+	const uint8_t bytes[] = { 0x00, 0x5e };
+	uint64_t at = 1234567;
+	uint64_t ts;
+
+	test_capture_console(1);
+	cprints(CC_SYSTEM, fmt_misc, 'x', -300, 1ULL << 40, 6, "ab",
+		HEX_BUF(bytes, 2), &at);
+	cflush();
+	test_capture_console(0);
+
+	TEST_ASSERT(decode_line(test_get_captured_console()) == EC_SUCCESS);
+	TEST_ASSERT(check_header(fmt_misc, CC_SYSTEM, &ts) == EC_SUCCESS);
+	TEST_ASSERT(get_varint() == (uint64_t)'x');
+	TEST_ASSERT(get_svarint() == -300LL);
+	TEST_ASSERT(get_varint() == 1ULL << 40);
+	TEST_ASSERT(get_svarint() == 6LL);
+	TEST_ASSERT(check_string("ab") == EC_SUCCESS);
+	TEST_ASSERT(get_varint() == 3ULL);
+	TEST_ASSERT_ARRAY_EQ(&record[record_pos], bytes, 2);
+	record_pos += 2;
+	TEST_ASSERT(get_varint() == at);
+	TEST_EQ(record_pos, record_len, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_fallback(void)
+{
+	/* Records which do not fit are printed as text */
+	test_capture_console(1);
+	cprints(CC_SYSTEM, "%s",
+		"0123456789012345678901234567890123456789"
+		"0123456789012345678901234567890123456789"
+		"0123456789012345678901234567890123456789");
+	cflush();
+	test_capture_console(0);
+	TEST_EQ(test_get_captured_console()[0], '[', "%c");
+
+	/* So is everything once binary logging is turned off */
+	UART_INJECT("binlog off\n");
+	msleep(30);
+	test_capture_console(1);
+	cprints(CC_SYSTEM, "text");
+	cflush();
+	test_capture_console(0);
+	TEST_EQ(test_get_captured_console()[0], '[', "%c");
+
+	UART_INJECT("binlog on\n");
+	msleep(30);
+	test_capture_console(1);
+	cprints(CC_SYSTEM, "binary");
+	cflush();
+	test_capture_console(0);
+	TEST_EQ(test_get_captured_console()[0], BINLOG_MARKER, "%c");
+
+	return EC_SUCCESS;
+}
+
+static int test_size(void)
+{
+	int binary_len, text_len;
+
+	test_capture_console(1);
+	cprints(CC_USBCHARGE, fmt_pe, 1, "SRC_READY", "SRC_TRANSITION",
+		0xdeadbeef);
+	cflush();
+	test_capture_console(0);
+	binary_len = strlen(test_get_captured_console());
+
+	UART_INJECT("binlog off\n");
+	msleep(30);
+	test_capture_console(1);
+	cprints(CC_USBCHARGE, fmt_pe, 1, "SRC_READY", "SRC_TRANSITION",
+		0xdeadbeef);
+	cflush();
+	test_capture_console(0);
+	text_len = strlen(test_get_captured_console());
+	UART_INJECT("binlog on\n");
+	msleep(30);
+
+	ccprintf("CPRINTS line: %d bytes as text, %d bytes as binary\n",
+		 text_len, binary_len);
+	TEST_ASSERT(binary_len < text_len);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_record);
+	RUN_TEST(test_conversions);
+	RUN_TEST(test_fallback);
+	RUN_TEST(test_size);
+
+	test_print_result();
+}
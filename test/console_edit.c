@@ -7,12 +7,14 @@
 
 #include "common.h"
 #include "console.h"
+#include "link_defs.h"
 #include "test_util.h"
 #include "timer.h"
 #include "util.h"
 
 static int cmd_1_call_cnt;
 static int cmd_2_call_cnt;
+static int cmd_3_call_cnt;
 
 static int command_test_1(int argc, char **argv)
 {
@@ -28,6 +30,13 @@ static int command_test_2(int argc, char **argv)
 }
 DECLARE_CONSOLE_COMMAND(test2, command_test_2, NULL, NULL);
 
+static int command_test_3(int argc, char **argv)
+{
+	cmd_3_call_cnt++;
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(test2long, command_test_3, NULL, NULL);
+
 /*****************************************************************************/
 /* Test utilities */
 
@@ -273,6 +282,48 @@ static int test_output_channel(void)
 	return EC_SUCCESS;
 }
 
+static int test_command_sorted(void)
+{
+	const struct console_command *cmd;
+
+	for (cmd = __cmds + 1; cmd < __cmds_end; cmd++)
+		TEST_ASSERT(strcasecmp(cmd[-1].name, cmd->name) < 0);
+
+	return EC_SUCCESS;
+}
+
+static int test_command_lookup(void)
+{
+	cmd_1_call_cnt = 0;
+	cmd_2_call_cnt = 0;
+	cmd_3_call_cnt = 0;
+
+	/* Exact match, in any case */
+	UART_INJECT("TEST1\n");
+	msleep(30);
+	TEST_EQ(cmd_1_call_cnt, 1, "%d");
+
+	/* Exact match which is also a prefix of another command */
+	UART_INJECT("test2\n");
+	msleep(30);
+	TEST_EQ(cmd_2_call_cnt, 1, "%d");
+	TEST_EQ(cmd_3_call_cnt, 0, "%d");
+
+	/* Unique prefix */
+	UART_INJECT("test2l\n");
+	msleep(30);
+	TEST_EQ(cmd_3_call_cnt, 1, "%d");
+
+	/* Ambiguous prefix */
+	UART_INJECT("test\n");
+	msleep(30);
+	TEST_EQ(cmd_1_call_cnt, 1, "%d");
+	TEST_EQ(cmd_2_call_cnt, 1, "%d");
+	TEST_EQ(cmd_3_call_cnt, 1, "%d");
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, char **argv)
 {
 	test_reset();
@@ -290,6 +341,8 @@ void run_test(int argc, char **argv)
 	RUN_TEST(test_history_stash);
 	RUN_TEST(test_history_list);
 	RUN_TEST(test_output_channel);
+	RUN_TEST(test_command_sorted);
+	RUN_TEST(test_command_lookup);
 
 	test_print_result();
 }
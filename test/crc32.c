@@ -8,6 +8,7 @@
 #include "common.h"
 #include "console.h"
 #include "crc.h"
+#include "crc8.h"
 #include "test_util.h"
 #include "util.h"
 
@@ -63,6 +64,138 @@ static int test_kat0(void)
 	return EC_SUCCESS;
 }
 
+static uint8_t buf[4096];
+
+static void fill_buf(void)
+{
+	uint32_t seed = 0x12345678;
+	int i;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+/* Bit-at-a-time reference, independent of the table driven engines */
+static uint32_t crc32_ref(const uint8_t *data, int size)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	int i;
+
+	while (size--) {
+		crc ^= *data++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+
+	return crc ^ 0xFFFFFFFF;
+}
+
+static uint8_t crc8_ref(const uint8_t *data, int size, uint8_t crc)
+{
+	int i;
+
+	while (size--) {
+		crc ^= *data++;
+		for (i = 0; i < 8; i++)
+			crc = (crc << 1) ^ (crc & 0x80 ? 0x07 : 0);
+	}
+
+	return crc;
+}
+
+static int test_kat_buffer(void)
+{
+	uint32_t crc;
+	const char input[] = "123456789";
+
+	crc32_ctx_init(&crc);
+	crc32_ctx_hash(&crc, input, strlen(input));
+	TEST_ASSERT(crc32_ctx_result(&crc) == 0xcbf43926);
+
+	return EC_SUCCESS;
+}
+
+/* Every length and alignment around the multi-byte steps */
+static int test_buffer(void)
+{
+	uint32_t crc;
+	int offset, size, split;
+
+	fill_buf();
+
+	for (offset = 0; offset < 8; offset++) {
+		for (size = 0; size <= 64; size++) {
+			crc32_ctx_init(&crc);
+			crc32_ctx_hash(&crc, buf + offset, size);
+			TEST_ASSERT(crc32_ctx_result(&crc) ==
+				    crc32_ref(buf + offset, size));
+		}
+	}
+
+	/* Hashing in pieces gives the same result */
+	for (split = 0; split <= 64; split++) {
+		crc32_ctx_init(&crc);
+		crc32_ctx_hash(&crc, buf, split);
+		crc32_ctx_hash(&crc, buf + split, sizeof(buf) - split);
+		TEST_ASSERT(crc32_ctx_result(&crc) ==
+			    crc32_ref(buf, sizeof(buf)));
+	}
+
+	return EC_SUCCESS;
+}
+
+static int test_crc8(void)
+{
+	const char input[] = "123456789";
+	int offset, size;
+
+	TEST_ASSERT(crc8((const uint8_t *)input, strlen(input)) == 0xf4);
+
+	fill_buf();
+
+	for (offset = 0; offset < 8; offset++)
+		for (size = 0; size <= 64; size++)
+			TEST_ASSERT(crc8(buf + offset, size) ==
+				    crc8_ref(buf + offset, size, 0));
+
+	TEST_ASSERT(crc8_arg(buf + 10, 20, crc8(buf, 10)) ==
+		    crc8(buf, 30));
+
+	return EC_SUCCESS;
+}
+
+#define CRC_BENCH_LOOPS 256
+
+static int test_bench(void)
+{
+	uint64_t t0, t1, t2;
+	uint32_t crc;
+	uint8_t crc8_val = 0;
+	int i;
+
+	fill_buf();
+
+	crc32_ctx_init(&crc);
+	t0 = test_get_bench_time();
+	for (i = 0; i < CRC_BENCH_LOOPS; i++)
+		crc32_ctx_hash(&crc, buf, sizeof(buf));
+	t1 = test_get_bench_time();
+	for (i = 0; i < CRC_BENCH_LOOPS; i++)
+		crc8_val = crc8_arg(buf, sizeof(buf), crc8_val);
+	t2 = test_get_bench_time();
+
+	ccprintf("crc32 %d KiB duration %lld us (result %08x)\n",
+		 CRC_BENCH_LOOPS * (int)sizeof(buf) / 1024,
+		 (long long)(t1 - t0), crc32_ctx_result(&crc));
+	ccprintf("crc8 %d KiB duration %lld us (result %02x)\n",
+		 CRC_BENCH_LOOPS * (int)sizeof(buf) / 1024,
+		 (long long)(t2 - t1), crc8_val);
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, char **argv)
 {
 	test_reset();
@@ -70,6 +203,10 @@ void run_test(int argc, char **argv)
 	RUN_TEST(test_static_version);
 	RUN_TEST(test_8);
 	RUN_TEST(test_kat0);
+	RUN_TEST(test_kat_buffer);
+	RUN_TEST(test_buffer);
+	RUN_TEST(test_crc8);
+	RUN_TEST(test_bench);
 
 	test_print_result();
 }
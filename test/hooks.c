@@ -7,11 +7,14 @@
 
 #include "common.h"
 #include "console.h"
+#include "ec_commands.h"
 #include "hooks.h"
 #include "test_util.h"
 #include "timer.h"
 #include "util.h"
 
+#define NOTIFY_BENCH_LOOPS 10000
+
 static int init_hook_count;
 static int tick_hook_count;
 static int tick2_hook_count;
@@ -51,6 +54,45 @@ static void second_hook(void)
 }
 DECLARE_HOOK(HOOK_SECOND, second_hook, HOOK_PRIO_DEFAULT);
 
+/*
+ * HOOK_BATTERY_SOC_CHANGE hooks declared out of priority order, about as many
+ * as the HOOK_SECOND list of a full board such as hx20.
+ */
+static int order_hook_count;
+static int order_hook_errors;
+static int order_last_prio;
+
+#define DECLARE_ORDER_HOOK(n, prio)					\
+	static void order_hook_##n(void)				\
+	{								\
+		if ((prio) < order_last_prio)				\
+			order_hook_errors++;				\
+		order_last_prio = (prio);				\
+		order_hook_count++;					\
+	}								\
+	DECLARE_HOOK(HOOK_BATTERY_SOC_CHANGE, order_hook_##n, prio)
+
+DECLARE_ORDER_HOOK(0, HOOK_PRIO_DEFAULT);
+DECLARE_ORDER_HOOK(1, HOOK_PRIO_LAST);
+DECLARE_ORDER_HOOK(2, HOOK_PRIO_FIRST);
+DECLARE_ORDER_HOOK(3, HOOK_PRIO_DEFAULT + 1);
+DECLARE_ORDER_HOOK(4, HOOK_PRIO_DEFAULT);
+DECLARE_ORDER_HOOK(5, HOOK_PRIO_TEMP_SENSOR);
+DECLARE_ORDER_HOOK(6, HOOK_PRIO_DEFAULT - 1);
+DECLARE_ORDER_HOOK(7, HOOK_PRIO_TEMP_SENSOR_DONE);
+DECLARE_ORDER_HOOK(8, HOOK_PRIO_FIRST + 1);
+DECLARE_ORDER_HOOK(9, HOOK_PRIO_DEFAULT);
+DECLARE_ORDER_HOOK(10, HOOK_PRIO_LAST);
+DECLARE_ORDER_HOOK(11, HOOK_PRIO_DEFAULT + 1);
+DECLARE_ORDER_HOOK(12, HOOK_PRIO_TEMP_SENSOR);
+DECLARE_ORDER_HOOK(13, HOOK_PRIO_FIRST);
+DECLARE_ORDER_HOOK(14, HOOK_PRIO_DEFAULT);
+DECLARE_ORDER_HOOK(15, HOOK_PRIO_DEFAULT - 1);
+DECLARE_ORDER_HOOK(16, HOOK_PRIO_DEFAULT);
+DECLARE_ORDER_HOOK(17, HOOK_PRIO_TEMP_SENSOR_DONE);
+DECLARE_ORDER_HOOK(18, HOOK_PRIO_LAST);
+DECLARE_ORDER_HOOK(19, HOOK_PRIO_DEFAULT);
+
 static void deferred_func(void)
 {
 	deferred_call_count++;
@@ -105,6 +147,96 @@ static int test_priority(void)
 	return EC_SUCCESS;
 }
 
+static int test_notify_order(void)
+{
+	order_hook_count = 0;
+	order_hook_errors = 0;
+	order_last_prio = HOOK_PRIO_FIRST;
+	hook_notify(HOOK_BATTERY_SOC_CHANGE);
+	TEST_EQ(order_hook_count, 20, "%d");
+	TEST_EQ(order_hook_errors, 0, "%d");
+
+	/* Second notify walks the already-built order */
+	order_last_prio = HOOK_PRIO_FIRST;
+	hook_notify(HOOK_BATTERY_SOC_CHANGE);
+	TEST_EQ(order_hook_count, 40, "%d");
+	TEST_EQ(order_hook_errors, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_notify_latency(void)
+{
+	uint64_t t0, t1;
+	int i;
+
+	t0 = test_get_bench_time();
+	for (i = 0; i < NOTIFY_BENCH_LOOPS; i++) {
+		order_last_prio = HOOK_PRIO_FIRST;
+		hook_notify(HOOK_BATTERY_SOC_CHANGE);
+	}
+	t1 = test_get_bench_time();
+	ccprintf("hook_notify x%d (20 hooks) duration %lld us\n",
+		 NOTIFY_BENCH_LOOPS, (long long)(t1 - t0));
+	/* do not check speed, just as a benchmark */
+	TEST_EQ(order_hook_errors, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+#ifdef CONFIG_HOOK_DEBUG
+/* Find a routine in the EC_CMD_HOOK_STATS pages and return its call count */
+static int hook_stats_calls(uint8_t kind, uint8_t flags, void (*routine)(void))
+{
+	struct ec_params_hook_stats p = {
+		.kind = kind,
+		.flags = flags,
+	};
+	/* Room for three entries, to exercise paging */
+	uint8_t buf[sizeof(struct ec_response_hook_stats) +
+		    3 * sizeof(struct ec_hook_stats_entry)];
+	struct ec_response_hook_stats *r = (void *)buf;
+	int calls = -1;
+	int i;
+
+	do {
+		if (test_send_host_command(EC_CMD_HOOK_STATS, 0, &p, sizeof(p),
+					   buf, sizeof(buf)) != EC_RES_SUCCESS)
+			return -1;
+		for (i = 0; i < r->count; i++) {
+			if (r->entries[i].routine ==
+			    (uint32_t)(uintptr_t)routine)
+				calls = r->entries[i].calls;
+		}
+		p.offset += r->count;
+	} while (r->count && p.offset < r->total);
+
+	return calls;
+}
+
+static int test_hook_stats(void)
+{
+	/* test_notify_order() and test_notify_latency() ran before */
+	TEST_ASSERT(hook_stats_calls(EC_HOOK_STATS_HOOKS, 0, order_hook_0) >=
+		    NOTIFY_BENCH_LOOPS + 2);
+	TEST_ASSERT(hook_stats_calls(EC_HOOK_STATS_HOOKS, 0, tick_hook) > 0);
+
+	/* Clearing returns the counts one last time */
+	TEST_ASSERT(hook_stats_calls(EC_HOOK_STATS_HOOKS,
+				     EC_HOOK_STATS_FLAG_CLEAR,
+				     order_hook_0) > 0);
+	TEST_EQ(hook_stats_calls(EC_HOOK_STATS_HOOKS, 0, order_hook_0), 0,
+		"%d");
+
+	hook_call_deferred(&deferred_func_data, 0);
+	usleep(10 * MSEC);
+	TEST_ASSERT(hook_stats_calls(EC_HOOK_STATS_DEFERRED, 0,
+				     deferred_func) > 0);
+
+	return EC_SUCCESS;
+}
+#endif
+
 static int test_deferred(void)
 {
 	deferred_call_count = 0;
@@ -134,6 +266,45 @@ static int test_deferred(void)
 	return EC_SUCCESS;
 }
 
+static int deferred_order[4];
+static int deferred_order_count;
+
+#define DECLARE_ORDER_DEFERRED(n)					\
+	static void order_deferred_##n(void)				\
+	{								\
+		if (deferred_order_count < ARRAY_SIZE(deferred_order))	\
+			deferred_order[deferred_order_count] = n;	\
+		deferred_order_count++;					\
+	}								\
+	DECLARE_DEFERRED(order_deferred_##n)
+
+DECLARE_ORDER_DEFERRED(0);
+DECLARE_ORDER_DEFERRED(1);
+DECLARE_ORDER_DEFERRED(2);
+DECLARE_ORDER_DEFERRED(3);
+
+static int test_deferred_order(void)
+{
+	deferred_order_count = 0;
+	hook_call_deferred(&order_deferred_0_data, 40 * MSEC);
+	hook_call_deferred(&order_deferred_1_data, 30 * MSEC);
+	hook_call_deferred(&order_deferred_2_data, 20 * MSEC);
+	hook_call_deferred(&order_deferred_3_data, 10 * MSEC);
+	usleep(5 * MSEC);
+	/* Move 3 to the back, cancel 1 and bring 0 to the front */
+	hook_call_deferred(&order_deferred_3_data, 60 * MSEC);
+	hook_call_deferred(&order_deferred_1_data, -1);
+	hook_call_deferred(&order_deferred_0_data, 5 * MSEC);
+	usleep(100 * MSEC);
+
+	TEST_EQ(deferred_order_count, 3, "%d");
+	TEST_EQ(deferred_order[0], 0, "%d");
+	TEST_EQ(deferred_order[1], 2, "%d");
+	TEST_EQ(deferred_order[2], 3, "%d");
+
+	return EC_SUCCESS;
+}
+
 static int repeating_deferred_count;
 static void deferred_repeating_func(void);
 DECLARE_DEFERRED(deferred_repeating_func);
@@ -166,7 +337,13 @@ void run_test(int argc, char **argv)
 	RUN_TEST(test_init_hook);
 	RUN_TEST(test_ticks);
 	RUN_TEST(test_priority);
+	RUN_TEST(test_notify_order);
+	RUN_TEST(test_notify_latency);
+#ifdef CONFIG_HOOK_DEBUG
+	RUN_TEST(test_hook_stats);
+#endif
 	RUN_TEST(test_deferred);
+	RUN_TEST(test_deferred_order);
 	RUN_TEST(test_repeating_deferred);
 
 	test_print_result();
@@ -8,6 +8,7 @@
 #include "common.h"
 #include "console.h"
 #include "host_command.h"
+#include "link_defs.h"
 #include "task.h"
 #include "test_util.h"
 #include "timer.h"
@@ -27,6 +28,26 @@ struct ec_response_hello *r =
 struct ec_response_get_chip_info *chip_info_r =
 	(struct ec_response_get_chip_info *)(resp_buf + sizeof(*resp));
 
+/* Commands at both ends of an otherwise unused page */
+#define TEST_CMD_PAGE_FIRST 0x2b00
+#define TEST_CMD_PAGE_LAST 0x2bff
+
+static enum ec_status hostcmd_page_first(struct host_cmd_handler_args *args)
+{
+	*(uint8_t *)args->response = 1;
+	args->response_size = 1;
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(TEST_CMD_PAGE_FIRST, hostcmd_page_first, EC_VER_MASK(0));
+
+static enum ec_status hostcmd_page_last(struct host_cmd_handler_args *args)
+{
+	*(uint8_t *)args->response = 2;
+	args->response_size = 1;
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(TEST_CMD_PAGE_LAST, hostcmd_page_last, EC_VER_MASK(0));
+
 static void hostcmd_respond(struct host_packet *pkt)
 {
 	task_wake(TASK_ID_TEST_RUNNER);
@@ -132,6 +153,40 @@ static int test_hostcmd_invalid_command(void)
 	hostcmd_send();
 	TEST_ASSERT(resp->result == EC_RES_INVALID_COMMAND);
 
+	/* Page with no handlers at all */
+	hostcmd_fill_in_default();
+	req->command = 0x2a00;
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_INVALID_COMMAND);
+
+	return EC_SUCCESS;
+}
+
+/* Send a command with no parameters; return the first response byte */
+static int hostcmd_send_page_cmd(uint16_t command)
+{
+	hostcmd_fill_in_default();
+	req->command = command;
+	req->data_len = 0;
+	pkt.request_size = sizeof(*req);
+	hostcmd_send();
+
+	if (resp->result != EC_RES_SUCCESS)
+		return -1;
+	return (uint8_t)resp_buf[sizeof(*resp)];
+}
+
+static int test_hostcmd_page_ends(void)
+{
+	TEST_EQ(hostcmd_send_page_cmd(TEST_CMD_PAGE_FIRST), 1, "%d");
+	TEST_EQ(hostcmd_send_page_cmd(TEST_CMD_PAGE_LAST), 2, "%d");
+
+	/* Neighbours in the same page and the pages either side */
+	TEST_EQ(hostcmd_send_page_cmd(TEST_CMD_PAGE_FIRST + 1), -1, "%d");
+	TEST_EQ(hostcmd_send_page_cmd(TEST_CMD_PAGE_LAST - 1), -1, "%d");
+	TEST_EQ(hostcmd_send_page_cmd(TEST_CMD_PAGE_FIRST - 1), -1, "%d");
+	TEST_EQ(hostcmd_send_page_cmd(TEST_CMD_PAGE_LAST + 1), -1, "%d");
+
 	return EC_SUCCESS;
 }
 
@@ -300,6 +355,217 @@ static int test_hostcmd_clears_unused_data(void)
 	return EC_SUCCESS;
 }
 
+static uint8_t *batch_add(uint8_t *buf, uint16_t command, uint32_t param)
+{
+	struct ec_params_batch_entry *e = (void *)buf;
+
+	e->command = command;
+	e->version = 0;
+	e->size = param ? sizeof(param) : 0;
+	memcpy(e + 1, &param, e->size);
+
+	return buf + sizeof(*e) + e->size;
+}
+
+static void hostcmd_fill_batch(uint8_t flags, uint16_t command)
+{
+	struct ec_params_batch *b = (void *)(req_buf + sizeof(*req));
+	uint8_t *end = (uint8_t *)(b + 1);
+
+	hostcmd_fill_in_default();
+	req->command = EC_CMD_BATCH;
+
+	memset(b, 0, BUFFER_SIZE - sizeof(*req));
+	b->count = 3;
+	b->flags = flags;
+	end = batch_add(end, EC_CMD_HELLO, 0x11223344);
+	end = batch_add(end, command, EC_REBOOT_COLD);
+	end = batch_add(end, EC_CMD_HELLO, 0x01020304);
+
+	req->data_len = end - (uint8_t *)b;
+	pkt.request_size = sizeof(*req) + req->data_len;
+}
+
+static int test_hostcmd_batch(void)
+{
+	struct ec_response_batch *b = (void *)(resp_buf + sizeof(*resp));
+	struct ec_response_batch_entry *e = (void *)(b + 1);
+	uint32_t out;
+
+	hostcmd_fill_batch(0, 0xff);
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_SUCCESS);
+	TEST_ASSERT(b->count == 3);
+
+	TEST_ASSERT(e->result == EC_RES_SUCCESS);
+	TEST_ASSERT(e->size == sizeof(out));
+	memcpy(&out, e + 1, sizeof(out));
+	TEST_ASSERT(out == 0x12243648);
+	e = (void *)((uint8_t *)(e + 1) + e->size);
+
+	TEST_ASSERT(e->result == EC_RES_INVALID_COMMAND);
+	TEST_ASSERT(e->size == 0);
+	e++;
+
+	TEST_ASSERT(e->result == EC_RES_SUCCESS);
+	memcpy(&out, e + 1, sizeof(out));
+	TEST_ASSERT(out == 0x01020304 + 0x01020304);
+
+	/* Stop after the failing sub-command */
+	hostcmd_fill_batch(EC_BATCH_FLAG_STOP_ON_ERROR, 0xff);
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_SUCCESS);
+	TEST_ASSERT(b->count == 2);
+
+	/* Truncated sub-request fails the whole batch */
+	hostcmd_fill_batch(0, 0xff);
+	req->data_len -= 2;
+	pkt.request_size -= 2;
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_INVALID_PARAM);
+
+	/*
+	 * So does a command which responds early or does not return, before
+	 * any of the batch runs
+	 */
+	hostcmd_fill_batch(0, EC_CMD_REBOOT_EC);
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_INVALID_PARAM);
+	TEST_ASSERT(resp->data_len == 0);
+
+	hostcmd_fill_batch(0, EC_CMD_FLASH_ERASE);
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_INVALID_PARAM);
+
+	return EC_SUCCESS;
+}
+
+static int hostcmd_read_stats(uint16_t command, uint8_t flags,
+			      struct ec_host_stats_entry *out)
+{
+	struct ec_params_host_stats *p = (void *)(req_buf + sizeof(*req));
+	struct ec_response_host_stats *r = (void *)(resp_buf + sizeof(*resp));
+	const struct host_command *cmd;
+
+	for (cmd = __hcmds; cmd < __hcmds_end; cmd++)
+		if (cmd->command == command)
+			break;
+
+	hostcmd_fill_in_default();
+	req->command = EC_CMD_HOST_STATS;
+	req->data_len = sizeof(*p);
+	pkt.request_size = sizeof(*req) + sizeof(*p);
+	p->flags = flags;
+	p->reserved = 0;
+	p->offset = cmd - __hcmds;
+	hostcmd_send();
+
+	if (resp->result != EC_RES_SUCCESS || r->count < 1 ||
+	    r->total != __hcmds_end - __hcmds ||
+	    r->entries[0].command != command)
+		return EC_ERROR_UNKNOWN;
+
+	memcpy(out, &r->entries[0], sizeof(*out));
+	return EC_SUCCESS;
+}
+
+static void hostcmd_fill_test_protocol(uint32_t ec_result)
+{
+	struct ec_params_test_protocol *tp =
+		(void *)(req_buf + sizeof(*req));
+
+	hostcmd_fill_in_default();
+	req->command = EC_CMD_TEST_PROTOCOL;
+	req->data_len = sizeof(*tp);
+	pkt.request_size = sizeof(*req) + sizeof(*tp);
+	memset(tp, 0, sizeof(*tp));
+	tp->ec_result = ec_result;
+}
+
+static int test_hostcmd_stats(void)
+{
+	struct ec_host_stats_entry e;
+	const struct host_command *cmd;
+	int i, sum = 0;
+
+	TEST_ASSERT(hostcmd_read_stats(EC_CMD_TEST_PROTOCOL,
+				       EC_HOST_STATS_FLAG_CLEAR, &e) ==
+		    EC_SUCCESS);
+
+	for (i = 0; i < 3; i++) {
+		hostcmd_fill_test_protocol(EC_RES_SUCCESS);
+		hostcmd_send();
+	}
+	hostcmd_fill_test_protocol(EC_RES_BUSY);
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_BUSY);
+
+	/* Unsupported version never reaches the handler */
+	hostcmd_fill_test_protocol(EC_RES_SUCCESS);
+	req->command_version = 1;
+	hostcmd_send();
+	TEST_ASSERT(resp->result == EC_RES_INVALID_VERSION);
+
+	TEST_ASSERT(hostcmd_read_stats(EC_CMD_TEST_PROTOCOL, 0, &e) ==
+		    EC_SUCCESS);
+	TEST_EQ(e.calls, 4, "%d");
+	TEST_EQ(e.errors, 1, "%d");
+	TEST_EQ(e.last_error, EC_RES_BUSY, "%d");
+	TEST_ASSERT(e.min_us <= e.max_us);
+	TEST_ASSERT(e.total_us >= e.max_us);
+	for (i = 0; i < EC_HOST_STATS_BUCKETS; i++)
+		sum += e.hist[i];
+	TEST_EQ(sum, 4, "%d");
+
+	/* Reading with clear returns the counts, then resets them */
+	TEST_ASSERT(hostcmd_read_stats(EC_CMD_TEST_PROTOCOL,
+				       EC_HOST_STATS_FLAG_CLEAR, &e) ==
+		    EC_SUCCESS);
+	TEST_EQ(e.calls, 4, "%d");
+	TEST_ASSERT(hostcmd_read_stats(EC_CMD_TEST_PROTOCOL, 0, &e) ==
+		    EC_SUCCESS);
+	TEST_EQ(e.calls, 0, "%d");
+
+	/* The error count does not stop at 16 bits */
+	for (cmd = __hcmds; cmd->command != EC_CMD_TEST_PROTOCOL; cmd++)
+		;
+	__hcmds_stats[cmd - __hcmds].errors = UINT16_MAX;
+	hostcmd_fill_test_protocol(EC_RES_BUSY);
+	hostcmd_send();
+	TEST_ASSERT(hostcmd_read_stats(EC_CMD_TEST_PROTOCOL,
+				       EC_HOST_STATS_FLAG_CLEAR, &e) ==
+		    EC_SUCCESS);
+	TEST_EQ(e.errors, UINT16_MAX + 1, "%d");
+
+	return EC_SUCCESS;
+}
+
+#define HOSTCMD_BENCH_LOOPS 1000
+
+static int test_hostcmd_dispatch_latency(void)
+{
+	uint64_t t0, t1;
+	int i;
+
+	/* Alternate two commands so the lookup is not trivially cached */
+	t0 = test_get_bench_time();
+	for (i = 0; i < HOSTCMD_BENCH_LOOPS; i++) {
+		hostcmd_fill_in_default();
+		hostcmd_send();
+		TEST_ASSERT(resp->result == EC_RES_SUCCESS);
+
+		hostcmd_fill_chip_info();
+		hostcmd_send();
+		TEST_ASSERT(resp->result == EC_RES_SUCCESS);
+	}
+	t1 = test_get_bench_time();
+
+	ccprintf("host_packet_receive x%d duration %lld us\n",
+		 2 * HOSTCMD_BENCH_LOOPS, (long long)(t1 - t0));
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, char **argv)
 {
 	wait_for_task_started();
@@ -310,11 +576,15 @@ void run_test(int argc, char **argv)
 	RUN_TEST(test_hostcmd_too_long);
 	RUN_TEST(test_hostcmd_driver_error);
 	RUN_TEST(test_hostcmd_invalid_command);
+	RUN_TEST(test_hostcmd_page_ends);
 	RUN_TEST(test_hostcmd_wrong_command_version);
 	RUN_TEST(test_hostcmd_wrong_struct_version);
 	RUN_TEST(test_hostcmd_invalid_checksum);
 	RUN_TEST(test_hostcmd_reuse_response_buffer);
 	RUN_TEST(test_hostcmd_clears_unused_data);
+	RUN_TEST(test_hostcmd_batch);
+	RUN_TEST(test_hostcmd_stats);
+	RUN_TEST(test_hostcmd_dispatch_latency);
 
 	test_print_result();
 }
@@ -0,0 +1,204 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test asynchronous I2C request queues.
+ */
+
+#include "common.h"
+#include "i2c.h"
+#include "task.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+#define MOCK_ADDR_FLAGS 0x42
+#define MOCK_PORT I2C_PORT_EEPROM
+BUILD_ASSERT(MOCK_PORT >= I2C_PORT_COUNT);
+
+/* Command byte which makes the mock device hold the bus until released */
+#define CMD_BLOCK 0xb0
+
+#define TEST_EVENT_DONE TASK_EVENT_CUSTOM_BIT(0)
+
+static volatile int blocked;
+static uint8_t order[8];
+static int order_len;
+static int completions;
+
+static int mock_xfer(const int port, const uint16_t slave_addr_flags,
+		     const uint8_t *out, int out_size,
+		     uint8_t *in, int in_size, int flags)
+{
+	if (port != MOCK_PORT || slave_addr_flags != MOCK_ADDR_FLAGS)
+		return EC_ERROR_INVAL;
+	if (out_size < 1)
+		return EC_ERROR_UNKNOWN;
+
+	if (out[0] == CMD_BLOCK) {
+		while (blocked)
+			msleep(1);
+	}
+
+	if (order_len < ARRAY_SIZE(order))
+		order[order_len++] = out[0];
+	if (in_size)
+		in[0] = out[0] + 1;
+
+	return EC_SUCCESS;
+}
+DECLARE_TEST_I2C_XFER(mock_xfer);
+
+/* The sparse port numbers share the host's one controller */
+int i2c_port_to_controller(int port)
+{
+	return port == MOCK_PORT ? 0 : -1;
+}
+
+static void count_completion(struct i2c_async_req *req)
+{
+	completions++;
+}
+
+static void init_req(struct i2c_async_req *req, const uint8_t *cmd,
+		     uint8_t *resp, enum i2c_async_prio prio)
+{
+	memset(req, 0, sizeof(*req));
+	req->port = MOCK_PORT;
+	req->slave_addr_flags = MOCK_ADDR_FLAGS;
+	req->out = cmd;
+	req->out_size = 1;
+	req->in = resp;
+	req->in_size = 1;
+	req->prio = prio;
+	req->complete = count_completion;
+}
+
+static int wait_for_state(struct i2c_async_req *req,
+			  enum i2c_async_state state)
+{
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		if (req->state == state)
+			return EC_SUCCESS;
+		msleep(1);
+	}
+	return EC_ERROR_TIMEOUT;
+}
+
+static int test_priority_order(void)
+{
+	static const uint8_t cmd[] = {CMD_BLOCK, 0x10, 0x20, 0x30, 0x40, 0x50};
+	uint8_t resp[ARRAY_SIZE(cmd)] = {0};
+	struct i2c_async_req req[ARRAY_SIZE(cmd)];
+	static const enum i2c_async_prio prio[] = {
+		I2C_ASYNC_PRIO_LOW, I2C_ASYNC_PRIO_LOW, I2C_ASYNC_PRIO_NORMAL,
+		I2C_ASYNC_PRIO_HIGH, I2C_ASYNC_PRIO_NORMAL, I2C_ASYNC_PRIO_LOW,
+	};
+	static const uint8_t expected[] = {CMD_BLOCK, 0x30, 0x20, 0x40, 0x10};
+	int i;
+
+	order_len = 0;
+	completions = 0;
+	for (i = 0; i < ARRAY_SIZE(cmd); i++)
+		init_req(&req[i], &cmd[i], &resp[i], prio[i]);
+
+	/* Hold the bus so that the rest of the requests queue up */
+	blocked = 1;
+	TEST_EQ(i2c_xfer_async(&req[0]), EC_SUCCESS, "%d");
+	TEST_EQ(wait_for_state(&req[0], I2C_ASYNC_RUNNING), EC_SUCCESS, "%d");
+	TEST_EQ(i2c_async_cancel(&req[0]), EC_ERROR_BUSY, "%d");
+
+	for (i = 1; i < ARRAY_SIZE(cmd); i++)
+		TEST_EQ(i2c_xfer_async(&req[i]), EC_SUCCESS, "%d");
+	TEST_EQ(req[2].state, I2C_ASYNC_QUEUED, "%d");
+
+	/* A request can only be in one queue at a time */
+	TEST_EQ(i2c_xfer_async(&req[2]), EC_ERROR_BUSY, "%d");
+
+	/* Cancel the last request, which is also the tail of its queue */
+	TEST_EQ(i2c_async_cancel(&req[5]), EC_SUCCESS, "%d");
+	TEST_EQ(req[5].state, I2C_ASYNC_IDLE, "%d");
+
+	blocked = 0;
+	for (i = 0; i < ARRAY_SIZE(cmd) - 1; i++) {
+		TEST_EQ(wait_for_state(&req[i], I2C_ASYNC_DONE), EC_SUCCESS,
+			"%d");
+		TEST_EQ(req[i].rv, EC_SUCCESS, "%d");
+		TEST_EQ(resp[i], (uint8_t)(cmd[i] + 1), "0x%x");
+	}
+
+	TEST_EQ(order_len, (int)ARRAY_SIZE(expected), "%d");
+	TEST_ASSERT_ARRAY_EQ(order, expected, ARRAY_SIZE(expected));
+	TEST_EQ(completions, (int)ARRAY_SIZE(expected), "%d");
+	TEST_EQ(resp[5], 0, "%d");
+
+	/* A finished request may be submitted again */
+	TEST_EQ(i2c_xfer_async(&req[5]), EC_SUCCESS, "%d");
+	TEST_EQ(wait_for_state(&req[5], I2C_ASYNC_DONE), EC_SUCCESS, "%d");
+	TEST_EQ(resp[5], cmd[5] + 1, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_event(void)
+{
+	static const uint8_t cmd = 0x60;
+	uint8_t resp = 0;
+	struct i2c_async_req req;
+	uint32_t evt;
+
+	init_req(&req, &cmd, &resp, I2C_ASYNC_PRIO_NORMAL);
+	req.complete = NULL;
+	req.task = task_get_current();
+	req.event = TEST_EVENT_DONE;
+
+	TEST_EQ(i2c_xfer_async(&req), EC_SUCCESS, "%d");
+	evt = task_wait_event_mask(TEST_EVENT_DONE, 100 * MSEC);
+	TEST_EQ(evt, TEST_EVENT_DONE, "0x%x");
+	TEST_EQ(req.state, I2C_ASYNC_DONE, "%d");
+	TEST_EQ(req.rv, EC_SUCCESS, "%d");
+	TEST_EQ(resp, 0x61, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_errors(void)
+{
+	static const uint8_t cmd = 0x70;
+	uint8_t resp = 0;
+	struct i2c_async_req req;
+
+	/* The transfer result is reported through rv */
+	init_req(&req, &cmd, &resp, I2C_ASYNC_PRIO_HIGH);
+	req.slave_addr_flags = MOCK_ADDR_FLAGS + 1;
+	TEST_EQ(i2c_xfer_async(&req), EC_SUCCESS, "%d");
+	TEST_EQ(wait_for_state(&req, I2C_ASYNC_DONE), EC_SUCCESS, "%d");
+	TEST_NE(req.rv, EC_SUCCESS, "%d");
+
+	/* Ports are looked up by number, not used as an index */
+	init_req(&req, &cmd, &resp, I2C_ASYNC_PRIO_HIGH);
+	req.port = 0;
+	TEST_EQ(i2c_xfer_async(&req), EC_ERROR_INVAL, "%d");
+	TEST_EQ(i2c_async_cancel(&req), EC_ERROR_INVAL, "%d");
+
+	init_req(&req, &cmd, &resp, I2C_ASYNC_PRIO_COUNT);
+	TEST_EQ(i2c_xfer_async(&req), EC_ERROR_INVAL, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	/* Let the I2C async task claim its port */
+	msleep(10);
+
+	RUN_TEST(test_priority_order);
+	RUN_TEST(test_event);
+	RUN_TEST(test_errors);
+
+	test_print_result();
+}
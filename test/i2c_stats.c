@@ -0,0 +1,202 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test I2C bus statistics.
+ */
+
+#include "common.h"
+#include "ec_commands.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+#define MOCK_PORT 0
+#define MOCK_ADDR_FLAGS 0x42
+
+/* Registers of the mock device, which each behave differently */
+enum mock_reg {
+	REG_OK,
+	REG_NAK,
+	REG_TIMEOUT,
+	REG_SLOW,
+	REG_BUSY_ONCE,
+};
+
+static int busy;
+
+static int mock_xfer(const int port, const uint16_t slave_addr_flags,
+		     const uint8_t *out, int out_size,
+		     uint8_t *in, int in_size, int flags)
+{
+	if (port != MOCK_PORT || I2C_GET_ADDR(slave_addr_flags) !=
+	    I2C_GET_ADDR(MOCK_ADDR_FLAGS))
+		return EC_ERROR_INVAL;
+	if (out_size < 1)
+		return EC_ERROR_UNKNOWN;
+
+	switch (out[0]) {
+	case REG_NAK:
+		return EC_ERROR_UNKNOWN;
+	case REG_TIMEOUT:
+		return EC_ERROR_TIMEOUT;
+	case REG_SLOW:
+		udelay(3 * MSEC);
+		break;
+	case REG_BUSY_ONCE:
+		if (!busy++)
+			return EC_ERROR_BUSY;
+		break;
+	}
+
+	memset(in, 0, in_size);
+	return EC_SUCCESS;
+}
+DECLARE_TEST_I2C_XFER(mock_xfer);
+
+static int read_stats(uint8_t flags, struct ec_response_i2c_stats *r,
+		      int size)
+{
+	struct ec_params_i2c_stats p = {
+		.flags = flags,
+	};
+
+	return test_send_host_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p),
+				      r, size);
+}
+
+static struct ec_i2c_stats_entry *find_entry(struct ec_response_i2c_stats *r,
+					     int port, int addr)
+{
+	int i;
+
+	for (i = 0; i < r->count; i++) {
+		if (r->entries[i].port == port && r->entries[i].addr == addr)
+			return &r->entries[i];
+	}
+	return NULL;
+}
+
+static int test_counters(void)
+{
+	uint8_t buf[sizeof(struct ec_response_i2c_stats) +
+		    4 * sizeof(struct ec_i2c_stats_entry)];
+	struct ec_response_i2c_stats *r = (void *)buf;
+	struct ec_i2c_stats_entry *e;
+	int v, b, sum = 0;
+
+	TEST_EQ(read_stats(EC_I2C_STATS_FLAG_CLEAR, r, sizeof(buf)),
+		EC_RES_SUCCESS, "%d");
+
+	TEST_EQ(i2c_read16(MOCK_PORT, MOCK_ADDR_FLAGS, REG_OK, &v),
+		EC_SUCCESS, "%d");
+	TEST_EQ(i2c_write8(MOCK_PORT, MOCK_ADDR_FLAGS, REG_OK, 0),
+		EC_SUCCESS, "%d");
+	TEST_NE(i2c_read8(MOCK_PORT, MOCK_ADDR_FLAGS, REG_NAK, &v),
+		EC_SUCCESS, "%d");
+	TEST_EQ(i2c_read8(MOCK_PORT, MOCK_ADDR_FLAGS, REG_TIMEOUT, &v),
+		EC_ERROR_TIMEOUT, "%d");
+	TEST_EQ(i2c_read8(MOCK_PORT, MOCK_ADDR_FLAGS, REG_SLOW, &v),
+		EC_SUCCESS, "%d");
+	busy = 0;
+	TEST_EQ(i2c_read8(MOCK_PORT, MOCK_ADDR_FLAGS, REG_BUSY_ONCE, &v),
+		EC_SUCCESS, "%d");
+
+	TEST_EQ(read_stats(0, r, sizeof(buf)), EC_RES_SUCCESS, "%d");
+	e = find_entry(r, MOCK_PORT, I2C_GET_ADDR(MOCK_ADDR_FLAGS));
+	TEST_ASSERT(e);
+
+	/* The busy transfer is counted twice, once as a retry */
+	TEST_EQ(e->xfers, 7, "%d");
+	TEST_EQ(e->errors, 2, "%d");
+	TEST_EQ(e->timeouts, 1, "%d");
+	TEST_EQ(e->retries, 1, "%d");
+	/* 1 + 2, 2, then 1 + 1 for each of the five 8-bit reads */
+	TEST_EQ(e->bytes, 3 + 2 + 5 * 2, "%d");
+	TEST_ASSERT(e->max_us >= 3 * MSEC);
+	TEST_ASSERT(e->total_us >= 3 * MSEC);
+
+	for (b = 0; b < EC_I2C_STATS_BUCKETS; b++)
+		sum += e->hist[b];
+	TEST_EQ(sum, 7, "%d");
+	/* 3 ms lands in [2048, 4096) us */
+	TEST_ASSERT(e->hist[7] >= 1);
+
+	TEST_EQ(r->dropped, 0, "%d");
+	TEST_ASSERT(r->total >= 1);
+
+	/* Clearing keeps the device but zeroes its counters */
+	TEST_EQ(read_stats(EC_I2C_STATS_FLAG_CLEAR, r, sizeof(buf)),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(read_stats(0, r, sizeof(buf)), EC_RES_SUCCESS, "%d");
+	e = find_entry(r, MOCK_PORT, I2C_GET_ADDR(MOCK_ADDR_FLAGS));
+	TEST_ASSERT(e);
+	TEST_EQ(e->xfers, 0, "%d");
+	TEST_ASSERT(r->window_ms < 1000);
+
+	return EC_SUCCESS;
+}
+
+static int test_paging(void)
+{
+	uint8_t buf[sizeof(struct ec_response_i2c_stats)];
+	struct ec_response_i2c_stats *r = (void *)buf;
+	struct ec_params_i2c_stats p = { 0 };
+
+	/* A response with no room for entries returns none */
+	TEST_EQ(read_stats(0, r, sizeof(buf)), EC_RES_SUCCESS, "%d");
+	TEST_EQ(r->count, 0, "%d");
+	TEST_ASSERT(r->total >= 1);
+
+	p.offset = r->total + 1;
+	TEST_EQ(test_send_host_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p),
+				       r, sizeof(buf)),
+		EC_RES_INVALID_PARAM, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_dropped(void)
+{
+	uint8_t buf[sizeof(struct ec_response_i2c_stats) +
+		    sizeof(struct ec_i2c_stats_entry)];
+	struct ec_response_i2c_stats *r = (void *)buf;
+	struct ec_params_i2c_stats p = {
+		.flags = EC_I2C_STATS_FLAG_CLEAR,
+	};
+	int addr, v;
+
+	/* Fill the table, then talk to two devices which do not fit */
+	for (addr = 0x10; addr < 0x10 + CONFIG_I2C_STATS_DEVICES + 2; addr++)
+		i2c_read8(MOCK_PORT, addr, REG_OK, &v);
+
+	/* A clearing read reports dropped on every page, the last included */
+	do {
+		TEST_EQ(test_send_host_command(EC_CMD_I2C_STATS, 0, &p,
+					       sizeof(p), r, sizeof(buf)),
+			EC_RES_SUCCESS, "%d");
+		TEST_EQ(r->total, CONFIG_I2C_STATS_DEVICES, "%d");
+		TEST_EQ(r->count, 1, "%d");
+		TEST_ASSERT(r->dropped >= 2);
+		p.offset += r->count;
+	} while (p.offset < r->total);
+
+	/* Only then is it cleared */
+	TEST_EQ(read_stats(0, r, sizeof(buf)), EC_RES_SUCCESS, "%d");
+	TEST_EQ(r->dropped, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_counters);
+	RUN_TEST(test_paging);
+	RUN_TEST(test_dropped);
+
+	test_print_result();
+}
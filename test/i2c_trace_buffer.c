@@ -0,0 +1,154 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the binary I2C trace buffer.
+ */
+
+#include "common.h"
+#include "ec_commands.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+#define MOCK_PORT 0
+#define MOCK_ADDR_FLAGS 0x42
+
+/* Command byte which makes the mock device NAK */
+#define CMD_NAK 0xee
+
+static int mock_xfer(const int port, const uint16_t slave_addr_flags,
+		     const uint8_t *out, int out_size,
+		     uint8_t *in, int in_size, int flags)
+{
+	int i;
+
+	if (port != MOCK_PORT || slave_addr_flags != MOCK_ADDR_FLAGS)
+		return EC_ERROR_INVAL;
+	if (out_size && out[0] == CMD_NAK)
+		return EC_ERROR_UNKNOWN;
+
+	/* Reads return the command byte plus the offset */
+	for (i = 0; i < in_size; i++)
+		in[i] = (out_size ? out[0] : 0) + i;
+	return EC_SUCCESS;
+}
+DECLARE_TEST_I2C_XFER(mock_xfer);
+
+static struct {
+	struct ec_response_i2c_trace r;
+	struct ec_i2c_trace_record records[CONFIG_I2C_TRACE_BUFFER_SIZE];
+} resp;
+
+static int read_trace(uint32_t seq, int size)
+{
+	struct ec_params_i2c_trace p = {
+		.seq = seq,
+	};
+
+	return test_send_host_command(EC_CMD_I2C_TRACE, 0, &p, sizeof(p),
+				      &resp, size);
+}
+
+static int test_record(void)
+{
+	static const uint8_t out[] = {0x10, 0xaa, 0xbb};
+	static const uint8_t expected[] = {0x10, 0xaa, 0xbb, 0x10};
+	uint8_t in[6];
+	struct ec_i2c_trace_record *t;
+	uint32_t head;
+	uint8_t cmd;
+	timestamp_t before;
+
+	TEST_EQ(read_trace(0, sizeof(resp)), EC_RES_SUCCESS, "%d");
+	head = resp.r.head;
+
+	before = get_time();
+	TEST_EQ(i2c_xfer(MOCK_PORT, MOCK_ADDR_FLAGS, out, sizeof(out),
+			 in, sizeof(in)), EC_SUCCESS, "%d");
+	cmd = CMD_NAK;
+	TEST_NE(i2c_xfer(MOCK_PORT, MOCK_ADDR_FLAGS, &cmd, 1, in, 2),
+		EC_SUCCESS, "%d");
+
+	TEST_EQ(read_trace(head, sizeof(resp)), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.seq, head, "%d");
+	TEST_EQ(resp.r.head, head + 2, "%d");
+	TEST_EQ(resp.r.count, 2, "%d");
+
+	/* Write bytes first, then as many read bytes as fit */
+	t = &resp.r.records[0];
+	TEST_EQ(t->port, MOCK_PORT, "%d");
+	TEST_EQ(t->addr, I2C_GET_ADDR(MOCK_ADDR_FLAGS), "0x%x");
+	TEST_EQ(t->out_size, (int)sizeof(out), "%d");
+	TEST_EQ(t->in_size, (int)sizeof(in), "%d");
+	TEST_EQ(t->status, EC_SUCCESS, "%d");
+	TEST_EQ(t->flags, I2C_XFER_SINGLE, "%d");
+	TEST_ASSERT(t->timestamp >= before.le.lo);
+	TEST_ASSERT_ARRAY_EQ(t->data, expected, sizeof(expected));
+
+	/* A failed read records no data from the device */
+	t = &resp.r.records[1];
+	TEST_EQ(t->status, EC_ERROR_UNKNOWN, "%d");
+	TEST_EQ(t->data[0], CMD_NAK, "0x%x");
+	TEST_EQ(t->data[1], 0, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_wrap(void)
+{
+	uint8_t cmd, val;
+	uint32_t head;
+	int i;
+
+	TEST_EQ(read_trace(0, sizeof(resp)), EC_RES_SUCCESS, "%d");
+	head = resp.r.head;
+
+	/* Overflow the buffer by three records */
+	for (i = 0; i < CONFIG_I2C_TRACE_BUFFER_SIZE + 3; i++) {
+		cmd = i;
+		TEST_EQ(i2c_xfer(MOCK_PORT, MOCK_ADDR_FLAGS, &cmd, 1, &val, 1),
+			EC_SUCCESS, "%d");
+	}
+
+	/* The oldest three are gone */
+	TEST_EQ(read_trace(head, sizeof(resp)), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.seq, head + 3, "%d");
+	TEST_EQ(resp.r.count, CONFIG_I2C_TRACE_BUFFER_SIZE, "%d");
+	for (i = 0; i < resp.r.count; i++)
+		TEST_EQ(resp.r.records[i].data[0], i + 3, "%d");
+
+	/* A small response buffer is filled and the rest read later */
+	TEST_EQ(read_trace(head + 3,
+			   sizeof(resp.r) + 3 * sizeof(resp.r.records[0])),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.count, 3, "%d");
+	TEST_EQ(read_trace(head + 6, sizeof(resp)), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.seq, head + 6, "%d");
+	TEST_EQ(resp.r.count, CONFIG_I2C_TRACE_BUFFER_SIZE - 3, "%d");
+	TEST_EQ(resp.r.records[0].data[0], 6, "%d");
+
+	/* Caught up: nothing more to read */
+	TEST_EQ(read_trace(resp.r.head, sizeof(resp)), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.count, 0, "%d");
+
+	/* A sequence number from the future, as after an EC reboot */
+	TEST_EQ(read_trace(resp.r.head + 100, sizeof(resp)), EC_RES_SUCCESS,
+		"%d");
+	TEST_EQ(resp.r.seq, resp.r.head - CONFIG_I2C_TRACE_BUFFER_SIZE, "%d");
+	TEST_EQ(resp.r.count, CONFIG_I2C_TRACE_BUFFER_SIZE, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_record);
+	RUN_TEST(test_wrap);
+
+	test_print_result();
+}
@@ -297,6 +297,123 @@ test_static int test_vsnprintf_combined(void)
 	return EC_SUCCESS;
 }
 
+/* Output sink which records the number of output calls it receives */
+struct sink {
+	char buf[256];
+	int len;
+	int calls;
+};
+
+static int sink_addchar(void *context, int c)
+{
+	struct sink *sink = context;
+
+	sink->calls++;
+	if (sink->len == sizeof(sink->buf))
+		return 1;
+	sink->buf[sink->len++] = c;
+	return 0;
+}
+
+static int sink_addstr(void *context, const char *str, int len)
+{
+	struct sink *sink = context;
+	int n = MIN(len, (int)sizeof(sink->buf) - sink->len);
+
+	sink->calls++;
+	memcpy(sink->buf + sink->len, str, n);
+	sink->len += n;
+	return n != len;
+}
+
+static int sink_printf(struct sink *sink, bool bulk, const char *format, ...)
+{
+	va_list args;
+	int rv;
+
+	memset(sink, 0, sizeof(*sink));
+	va_start(args, format);
+	if (bulk)
+		rv = vfnprintf_str(sink_addstr, sink, format, args);
+	else
+		rv = vfnprintf(sink_addchar, sink, format, args);
+	va_end(args);
+
+	return rv;
+}
+
+#define SINK_COMPARE(ncalls, format, ...)                                     \
+	do {                                                                  \
+		TEST_EQ(sink_printf(&chars, false, format, ##__VA_ARGS__),    \
+			EC_SUCCESS, "%d");                                    \
+		TEST_EQ(sink_printf(&spans, true, format, ##__VA_ARGS__),     \
+			EC_SUCCESS, "%d");                                    \
+		TEST_EQ(chars.len, spans.len, "%d");                          \
+		TEST_ASSERT_ARRAY_EQ(chars.buf, spans.buf, chars.len);        \
+		TEST_EQ(spans.calls, ncalls, "%d");                           \
+	} while (0)
+
+test_static int test_vfnprintf_str(void)
+{
+	const char bytes[] = {0x00, 0x5E, 0xAB};
+	struct sink chars, spans;
+
+	/* Literal runs and formatted fields are each sent in one call */
+	SINK_COMPARE(0, "");
+	SINK_COMPARE(1, "hello world");
+	SINK_COMPARE(3, "port %d: state", 1);
+	SINK_COMPARE(4, "%s -> %s\n", "SRC_READY", "SRC_DISCOVERY");
+	SINK_COMPARE(2, "100%%");
+	SINK_COMPARE(2, "%c%c", 'a', 'b');
+	SINK_COMPARE(2, "%08x", 0x1234);
+	SINK_COMPARE(2, "%8d", -42);
+	SINK_COMPARE(3, "%-8s|", "ab");
+	SINK_COMPARE(4, "%40s", "x");
+	SINK_COMPARE(1, "%.3s", "abcdef");
+	SINK_COMPARE(1, "%ph", HEX_BUF(bytes, 3));
+	SINK_COMPARE(1, "%pP", (void *)0x1234);
+
+	/* Spans which do not fit are truncated */
+	T(expect(EC_ERROR_OVERFLOW, "abc", false, 4, "abcdefgh"));
+	T(expect(EC_ERROR_OVERFLOW, "ab   ", false, 6, "ab%8d", 1));
+
+	return EC_SUCCESS;
+}
+
+#define BENCH_LOOPS 20000
+
+/* A typical CPRINTS() line from a HOOK_TICK handler */
+#define BENCH_FORMAT "[%pT C%d: PE state %s -> %s, flags 0x%08x]\n"
+
+test_static int test_cprints_bench(void)
+{
+	uint64_t ts = 123456789;
+	uint64_t t0, t1, t2;
+	struct sink chars, spans;
+	int i;
+
+	t0 = test_get_bench_time();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		sink_printf(&chars, false, BENCH_FORMAT, &ts, 0,
+			    "PE_SRC_Ready", "PE_SRC_Transition_Supply", i);
+	t1 = test_get_bench_time();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		sink_printf(&spans, true, BENCH_FORMAT, &ts, 0,
+			    "PE_SRC_Ready", "PE_SRC_Transition_Supply", i);
+	t2 = test_get_bench_time();
+
+	TEST_EQ(chars.len, spans.len, "%d");
+	TEST_ASSERT_ARRAY_EQ(chars.buf, spans.buf, chars.len);
+
+	ccprintf("%d lines of %d bytes:\n", BENCH_LOOPS, spans.len);
+	ccprintf("  per-char  %lld us (%d calls/line)\n",
+		 (long long)(t1 - t0), chars.calls);
+	ccprintf("  per-span  %lld us (%d calls/line)\n",
+		 (long long)(t2 - t1), spans.calls);
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, char **argv)
 {
 	test_reset();
@@ -309,6 +426,8 @@ void run_test(int argc, char **argv)
 	RUN_TEST(test_vsnprintf_timestamps);
 	RUN_TEST(test_vsnprintf_hexdump);
 	RUN_TEST(test_vsnprintf_combined);
+	RUN_TEST(test_vfnprintf_str);
+	RUN_TEST(test_cprints_bench);
 
 	test_print_result();
 }
@@ -12,6 +12,10 @@
 #include "timer.h"
 #include "util.h"
 #include <stdio.h>
+#ifdef EMU_BUILD
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 static struct queue const test_queue8 = QUEUE_NULL(8, char);
 static struct queue const test_queue2 = QUEUE_NULL(2, int16_t);
@@ -324,6 +328,64 @@ static int test_queue8_chunks_offset(void)
 	return EC_SUCCESS;
 }
 
+static int test_queue8_iovec(void)
+{
+	static uint8_t const data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	struct queue_iovec iov;
+	uint8_t out[8];
+
+	/* Move near the end of the queue so both directions wrap */
+	TEST_ASSERT(queue_advance_tail(&test_queue8, 6) == 6);
+	TEST_ASSERT(queue_advance_head(&test_queue8, 6) == 6);
+
+	/* All free space is described, split at the end of the buffer */
+	TEST_ASSERT(queue_get_write_iovec(&test_queue8, &iov, 8) == 8);
+	TEST_ASSERT(iov.count == 8);
+	TEST_ASSERT(iov.chunk[0].count == 2);
+	TEST_ASSERT(iov.chunk[0].buffer == test_queue8.buffer + 6);
+	TEST_ASSERT(iov.chunk[1].count == 6);
+	TEST_ASSERT(iov.chunk[1].buffer == test_queue8.buffer);
+
+	/* Write five units through the spans and commit them */
+	TEST_ASSERT(queue_get_write_iovec(&test_queue8, &iov, 5) == 5);
+	TEST_ASSERT(iov.chunk[0].count == 2);
+	TEST_ASSERT(iov.chunk[1].count == 3);
+	memcpy(iov.chunk[0].buffer, data, iov.chunk[0].count);
+	memcpy(iov.chunk[1].buffer, data + 2, iov.chunk[1].count);
+	TEST_ASSERT(queue_advance_tail(&test_queue8, iov.count) == 5);
+	TEST_ASSERT(queue_count(&test_queue8) == 5);
+
+	/* Remaining free space is contiguous */
+	TEST_ASSERT(queue_get_write_iovec(&test_queue8, &iov, 8) == 3);
+	TEST_ASSERT(iov.chunk[0].count == 3);
+	TEST_ASSERT(iov.chunk[0].buffer == test_queue8.buffer + 3);
+	TEST_ASSERT(iov.chunk[1].count == 0);
+	TEST_ASSERT(iov.chunk[1].buffer == NULL);
+
+	/* Read back through both spans */
+	TEST_ASSERT(queue_get_read_iovec(&test_queue8, &iov, 8) == 5);
+	TEST_ASSERT(iov.chunk[0].count == 2);
+	TEST_ASSERT(iov.chunk[1].count == 3);
+	memcpy(out, iov.chunk[0].buffer, iov.chunk[0].count);
+	memcpy(out + 2, iov.chunk[1].buffer, iov.chunk[1].count);
+	TEST_ASSERT_ARRAY_EQ(out, data, 5);
+
+	/* Release part of it; the rest is now a single span */
+	TEST_ASSERT(queue_advance_head(&test_queue8, 3) == 3);
+	TEST_ASSERT(queue_get_read_iovec(&test_queue8, &iov, 8) == 2);
+	TEST_ASSERT(iov.chunk[0].buffer == test_queue8.buffer + 1);
+	TEST_ASSERT(iov.chunk[1].count == 0);
+	TEST_ASSERT(queue_remove_units(&test_queue8, out, 2) == 2);
+	TEST_ASSERT_ARRAY_EQ(out, data + 3, 2);
+
+	/* Nothing left to read */
+	TEST_ASSERT(queue_get_read_iovec(&test_queue8, &iov, 8) == 0);
+	TEST_ASSERT(iov.chunk[0].count == 0);
+	TEST_ASSERT(iov.chunk[0].buffer == NULL);
+
+	return EC_SUCCESS;
+}
+
 static int test_queue8_iterate_begin(void)
 {
 	struct queue const *q = &test_queue8;
@@ -410,6 +472,132 @@ static int test_queue8_iterate_next_reset_on_change(void)
 	return EC_SUCCESS;
 }
 
+#ifdef EMU_BUILD
+/* Counts notifications; add and remove are each only called by one side */
+struct spsc_policy {
+	struct queue_policy policy;
+	size_t *added;
+	size_t *removed;
+	size_t *notifies;
+};
+
+static size_t spsc_added, spsc_removed, spsc_notifies;
+
+static void spsc_policy_add(struct queue_policy const *policy, size_t count)
+{
+	struct spsc_policy const *p = (struct spsc_policy const *)policy;
+
+	*p->added += count;
+	(*p->notifies)++;
+}
+
+static void spsc_policy_remove(struct queue_policy const *policy,
+			       size_t count)
+{
+	struct spsc_policy const *p = (struct spsc_policy const *)policy;
+
+	*p->removed += count;
+}
+
+static struct spsc_policy const spsc_policy = {
+	.policy = {
+		.add = spsc_policy_add,
+		.remove = spsc_policy_remove,
+	},
+	.added = &spsc_added,
+	.removed = &spsc_removed,
+	.notifies = &spsc_notifies,
+};
+
+#define SPSC_STRESS_UNITS 2000000
+#define SPSC_MAX_BATCH 7
+
+/* Wide units make a torn or early-published copy easy to spot */
+struct spsc_unit {
+	uint32_t seq[8];
+};
+
+static struct queue const spsc_queue =
+	QUEUE(16, struct spsc_unit, spsc_policy.policy);
+static uint32_t spsc_bad_unit;
+static uint32_t spsc_bad_value;
+
+static void *spsc_producer(void *arg)
+{
+	struct spsc_unit buf[SPSC_MAX_BATCH];
+	uint32_t next = 0;
+	size_t batch = 1;
+	size_t i, j, n;
+
+	while (next < SPSC_STRESS_UNITS) {
+		n = MIN(batch, SPSC_STRESS_UNITS - next);
+		for (i = 0; i < n; i++)
+			for (j = 0; j < ARRAY_SIZE(buf[i].seq); j++)
+				buf[i].seq[j] = next + i;
+
+		n = queue_spsc_add_units(&spsc_queue, buf, n);
+		if (!n)
+			sched_yield();
+		next += n;
+		batch = batch % SPSC_MAX_BATCH + 1;
+	}
+
+	return NULL;
+}
+
+static void *spsc_consumer(void *arg)
+{
+	struct spsc_unit buf[SPSC_MAX_BATCH + 2];
+	uint32_t next = 0;
+	size_t batch = 1;
+	size_t i, j, n;
+
+	while (next < SPSC_STRESS_UNITS) {
+		n = queue_spsc_remove_units(&spsc_queue, buf, batch);
+		if (!n)
+			sched_yield();
+		for (i = 0; i < n; i++, next++) {
+			for (j = 0; j < ARRAY_SIZE(buf[i].seq); j++) {
+				if (buf[i].seq[j] == next || spsc_bad_unit)
+					continue;
+				spsc_bad_unit = next + 1;
+				spsc_bad_value = buf[i].seq[j];
+			}
+		}
+		batch = batch % ARRAY_SIZE(buf) + 1;
+	}
+
+	return NULL;
+}
+
+static int test_queue_spsc_stress(void)
+{
+	pthread_t producer, consumer;
+
+	queue_init(&spsc_queue);
+	spsc_added = spsc_removed = spsc_notifies = 0;
+	spsc_bad_unit = 0;
+
+	TEST_ASSERT(pthread_create(&consumer, NULL, spsc_consumer, NULL) == 0);
+	TEST_ASSERT(pthread_create(&producer, NULL, spsc_producer, NULL) == 0);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	if (spsc_bad_unit)
+		ccprintf("unit %d read as %d\n", spsc_bad_unit - 1,
+			 spsc_bad_value);
+	TEST_EQ(spsc_bad_unit, 0, "%d");
+	TEST_ASSERT(queue_is_empty(&spsc_queue));
+	TEST_ASSERT(spsc_added == SPSC_STRESS_UNITS);
+	TEST_ASSERT(spsc_removed == SPSC_STRESS_UNITS);
+
+	/* One notification per non-empty batch, not per unit */
+	TEST_ASSERT(spsc_notifies < SPSC_STRESS_UNITS);
+
+	return EC_SUCCESS;
+}
+#endif
+
 void before_test(void)
 {
 	queue_init(&test_queue2);
@@ -433,10 +621,14 @@ void run_test(int argc, char **argv)
 	RUN_TEST(test_queue8_chunks_empty);
 	RUN_TEST(test_queue8_chunks_advance);
 	RUN_TEST(test_queue8_chunks_offset);
+	RUN_TEST(test_queue8_iovec);
 	RUN_TEST(test_queue8_iterate_begin);
 	RUN_TEST(test_queue8_iterate_next);
 	RUN_TEST(test_queue2_iterate_next_full);
 	RUN_TEST(test_queue8_iterate_next_reset_on_change);
+#ifdef EMU_BUILD
+	RUN_TEST(test_queue_spsc_stress);
+#endif
 
 	test_print_result();
 }
@@ -11,14 +11,34 @@
 #include "test_util.h"
 #include "util.h"
 
-#ifdef TEST_RSA3
+#if defined(TEST_RSA3)
 #include "rsa2048-3.h"
+#elif defined(TEST_RSA3072)
+#include "rsa3072-F4.h"
+#elif defined(TEST_RSA4096)
+#include "rsa4096-F4.h"
 #else
 #include "rsa2048-F4.h"
 #endif
 
 static uint32_t rsa_workbuf[3 * RSANUMBYTES/4];
 
+#define RSA_BENCH_LOOPS 20
+
+static void bench_rsa(void)
+{
+	uint64_t t0, t1;
+	int i;
+
+	t0 = test_get_bench_time();
+	for (i = 0; i < RSA_BENCH_LOOPS; i++)
+		rsa_verify(rsa_key, sig, hash, rsa_workbuf);
+	t1 = test_get_bench_time();
+
+	ccprintf("RSA-%d verify: %lld us\n", CONFIG_RSA_KEY_SIZE,
+		 (long long)(t1 - t0) / RSA_BENCH_LOOPS);
+}
+
 void run_test(int argc, char **argv)
 {
 	int good;
@@ -49,6 +69,8 @@ void run_test(int argc, char **argv)
 	}
 	ccprintf("RSA verify FAILED (as expected)\n");
 
+	bench_rsa();
+
 	test_pass();
 }
 
@@ -0,0 +1,138 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * RSA 3072 with F4 exponent public key and verification.
+ * Private key in rsa3072-F4.pem.
+ */
+
+/* First generate a key:
+ * # openssl genrsa -out key.pem 3072
+ * # openssl rsa -in key.pem -pubout > key.pub
+ * Then dump the key:
+ * # dumpRSAPublicKey -pub key.pub | xxd -i
+ */
+const uint8_t rsa_data[] = {
+	0x60, 0x00, 0x00, 0x00, 0x13, 0xac, 0x64, 0xa0, 0xe5, 0x01, 0x62, 0xf6,
+	0x1e, 0xf8, 0x16, 0x5f, 0x07, 0xac, 0xed, 0xba, 0xfa, 0xd3, 0x36, 0x65,
+	0x56, 0x13, 0x55, 0xd7, 0x95, 0x06, 0x39, 0x21, 0x10, 0x65, 0x82, 0x2e,
+	0x90, 0x61, 0x82, 0xad, 0x2e, 0xc0, 0xd3, 0xec, 0xe7, 0xb5, 0x16, 0xd1,
+	0xff, 0xaf, 0x89, 0x57, 0x1d, 0x68, 0x8f, 0x7b, 0x2e, 0x69, 0x26, 0x8a,
+	0x15, 0x88, 0xbc, 0xeb, 0xb9, 0xcf, 0xec, 0x76, 0xf2, 0x60, 0xe3, 0x3b,
+	0x7d, 0xfe, 0x00, 0xc0, 0xc9, 0xd2, 0x79, 0xe7, 0x20, 0xf3, 0x02, 0x63,
+	0xb9, 0x8f, 0xe7, 0xda, 0x6c, 0x99, 0xe4, 0x63, 0x76, 0xff, 0xf6, 0x2c,
+	0xc0, 0xe9, 0xf7, 0x74, 0xdc, 0x87, 0x76, 0xc3, 0x7c, 0x64, 0x77, 0xd3,
+	0x79, 0xa9, 0xc9, 0x89, 0x31, 0x1a, 0xbc, 0x4c, 0x61, 0x65, 0xb2, 0xd0,
+	0x14, 0xd4, 0x83, 0xb2, 0x6a, 0x2d, 0xee, 0xcb, 0x28, 0x26, 0x50, 0xf2,
+	0x80, 0x92, 0x17, 0xfd, 0x8f, 0x2d, 0xfd, 0xb8, 0x22, 0x2f, 0x3b, 0xef,
+	0x24, 0xfd, 0x03, 0x50, 0xf9, 0x2d, 0xb4, 0x4f, 0xc4, 0xf5, 0x62, 0xb5,
+	0xd9, 0x36, 0xc6, 0x64, 0x98, 0xb0, 0xa0, 0x20, 0x7b, 0x20, 0xdf, 0x5e,
+	0x10, 0x49, 0x51, 0xaf, 0xb1, 0x93, 0xb7, 0x17, 0xab, 0x65, 0xe5, 0x08,
+	0x1d, 0x62, 0xd5, 0xee, 0xbc, 0x0a, 0xae, 0x7e, 0xfb, 0xc9, 0xf7, 0x62,
+	0xad, 0x20, 0x0b, 0x28, 0x44, 0x52, 0xb4, 0x65, 0x73, 0x1c, 0xcb, 0xc4,
+	0x45, 0x1c, 0x58, 0xce, 0x00, 0x39, 0x09, 0xed, 0xc4, 0x5f, 0xa0, 0x87,
+	0xf7, 0x71, 0xb4, 0x92, 0xc8, 0xd3, 0x46, 0xf9, 0xd3, 0xea, 0x2d, 0x1a,
+	0x83, 0xc8, 0x75, 0xbc, 0xf7, 0x2e, 0x37, 0xcb, 0xb5, 0xfe, 0x92, 0x9d,
+	0x40, 0x64, 0xf1, 0xc7, 0xca, 0x2d, 0xf5, 0x62, 0x04, 0xf4, 0x8a, 0x16,
+	0x14, 0x8e, 0x02, 0xc1, 0x36, 0x8c, 0x76, 0x82, 0x2b, 0xf4, 0x2b, 0x8b,
+	0x7b, 0x39, 0xf0, 0xda, 0xc8, 0xbb, 0x45, 0x65, 0x2f, 0x26, 0xb7, 0x5a,
+	0xb4, 0x16, 0x91, 0x83, 0x4f, 0x8d, 0x7b, 0xbc, 0x51, 0x63, 0x35, 0x75,
+	0x39, 0xc7, 0xdd, 0xf0, 0xb0, 0xc5, 0x8a, 0x6d, 0x7a, 0xb9, 0x67, 0xef,
+	0x96, 0x8f, 0x7d, 0xca, 0xb2, 0x8a, 0x73, 0x0e, 0x66, 0xf2, 0xcd, 0x5d,
+	0xa0, 0x89, 0xa4, 0x7b, 0x2c, 0x84, 0xc1, 0x5e, 0x59, 0x71, 0x0e, 0x93,
+	0x9f, 0x72, 0xfd, 0x39, 0xcc, 0xfb, 0x82, 0xd4, 0x9b, 0x95, 0x34, 0x54,
+	0xae, 0x24, 0x82, 0xea, 0xef, 0x84, 0x0a, 0xae, 0x66, 0x4d, 0xf1, 0xe0,
+	0x7b, 0x5a, 0xbb, 0x42, 0x58, 0x61, 0x80, 0xe8, 0x06, 0x9f, 0xb8, 0xee,
+	0x89, 0x39, 0x99, 0x87, 0x3b, 0xb4, 0xf3, 0x3a, 0x9e, 0x49, 0xd2, 0xb9,
+	0x54, 0x07, 0x93, 0x34, 0x81, 0xb6, 0x28, 0x95, 0xa9, 0x21, 0xee, 0xfa,
+	0xdb, 0x69, 0x85, 0xb9, 0x5e, 0x09, 0xc7, 0x9c, 0x4a, 0x78, 0xcd, 0x8c,
+	0x6d, 0x94, 0x3c, 0x8d, 0x00, 0x1c, 0x65, 0xda, 0xbc, 0x26, 0x7e, 0xb7,
+	0x01, 0x70, 0x9a, 0x9c, 0x63, 0xe2, 0x5d, 0x89, 0x07, 0xcf, 0xa4, 0x36,
+	0x85, 0x0a, 0x61, 0x37, 0xd3, 0xdd, 0x92, 0x9f, 0x7c, 0x11, 0xab, 0x7f,
+	0x0b, 0x45, 0xd0, 0xb4, 0x45, 0xdc, 0x4b, 0xcf, 0xd9, 0xaf, 0xfc, 0x42,
+	0x0f, 0x67, 0x72, 0x70, 0xb9, 0x15, 0x8c, 0xd4, 0xca, 0x30, 0x0c, 0x53,
+	0x2b, 0x64, 0xb4, 0xf4, 0x59, 0xfe, 0x8f, 0xbc, 0x18, 0x9e, 0x4a, 0x32,
+	0xa1, 0x54, 0x3e, 0xbc, 0xeb, 0x65, 0xa6, 0xb8, 0x17, 0xa0, 0x45, 0x3e,
+	0x9f, 0x10, 0xcf, 0xf7, 0x4d, 0x1c, 0x78, 0xf0, 0x77, 0x65, 0x65, 0x26,
+	0x70, 0x36, 0xf1, 0xaf, 0x00, 0x7b, 0x09, 0xb7, 0x10, 0x5d, 0x56, 0x09,
+	0xae, 0xa0, 0x2d, 0x6e, 0x16, 0xc4, 0x3d, 0xad, 0x6b, 0x11, 0xb0, 0x6a,
+	0xfa, 0x7f, 0xff, 0xd5, 0x5c, 0x9a, 0x31, 0x68, 0xa8, 0x25, 0xc5, 0xc6,
+	0x9d, 0xab, 0x5c, 0xef, 0xf0, 0xd2, 0xd1, 0xe3, 0x4e, 0x12, 0xe3, 0x69,
+	0x03, 0x8a, 0xd0, 0x5b, 0x92, 0x7d, 0x4f, 0x76, 0xec, 0xbc, 0x63, 0xe8,
+	0x67, 0xb0, 0x38, 0x14, 0x04, 0xde, 0x74, 0x92, 0xc7, 0xf9, 0x69, 0x4a,
+	0x36, 0x29, 0x49, 0x3a, 0x8a, 0x06, 0xbb, 0xa9, 0x8b, 0x93, 0x9f, 0xdf,
+	0x34, 0x55, 0x9b, 0xf5, 0x5d, 0x1c, 0xb3, 0xe7, 0xf5, 0xad, 0xe7, 0x68,
+	0x9d, 0xa1, 0xba, 0xfd, 0xab, 0x5b, 0x9d, 0x27, 0x60, 0x5d, 0x85, 0x11,
+	0x4a, 0xba, 0xdc, 0xe4, 0xfa, 0x08, 0xdd, 0x58, 0x23, 0xd6, 0x7f, 0x7d,
+	0xc8, 0xe3, 0x98, 0x4f, 0x79, 0x3b, 0x68, 0x96, 0x9c, 0x41, 0x8d, 0xe0,
+	0xb9, 0xe2, 0x3f, 0x11, 0x15, 0x2a, 0x37, 0x06, 0xdf, 0x7b, 0x6e, 0xd4,
+	0xe3, 0x12, 0xdc, 0x21, 0xcc, 0x03, 0x83, 0x1c, 0x57, 0x0b, 0xee, 0x0e,
+	0x39, 0xdc, 0xd5, 0x3c, 0xf9, 0x3c, 0xaa, 0x20, 0xd5, 0xcc, 0xdb, 0x8d,
+	0x1a, 0x1e, 0x18, 0x7f, 0xb6, 0x68, 0xc3, 0xf9, 0x70, 0xcf, 0x83, 0x5d,
+	0x0b, 0x76, 0x41, 0x76, 0xe2, 0x76, 0xe9, 0x13, 0x69, 0x23, 0x61, 0x57,
+	0x7f, 0x96, 0xe3, 0x0b, 0x07, 0x2b, 0x38, 0x84, 0x40, 0x6d, 0xe1, 0xc2,
+	0x71, 0x90, 0x3d, 0x8d, 0x37, 0x43, 0x56, 0x75, 0x72, 0x6b, 0xe6, 0x8d,
+	0x67, 0x11, 0x72, 0x06, 0xf0, 0xf6, 0xb9, 0xe7, 0x1b, 0x0c, 0xbb, 0x96,
+	0xc5, 0x6a, 0x27, 0x65, 0x51, 0x95, 0x83, 0xc2, 0xd9, 0xb1, 0xa4, 0x80,
+	0x39, 0x3c, 0x7c, 0x11, 0x8a, 0x12, 0x4a, 0x3b, 0x7a, 0x45, 0x0d, 0xfd,
+	0xa2, 0x35, 0x57, 0x82, 0x09, 0x90, 0x8f, 0xa0, 0x4a, 0x56, 0x94, 0x9d,
+	0x06, 0xca, 0x50, 0x9f, 0xd5, 0x70, 0x3d, 0xed, 0x36, 0x88, 0x5b, 0x9a,
+	0x95, 0xa2, 0xc4, 0xcc, 0xf0, 0x04, 0xcc, 0x08
+};
+
+const struct rsa_public_key *rsa_key = (struct rsa_public_key *)rsa_data;
+BUILD_ASSERT(sizeof(*rsa_key) == sizeof(rsa_data));
+
+/* SHA-256 sum to verify:
+ * # sha256sum README.md | sed -e 's/\(..\)/0x\1, /mg'
+ */
+const uint8_t hash[] = {
+	0xb7, 0x3a, 0xa2, 0xf5, 0x38, 0xed, 0xc1, 0x4e, 0xe2, 0x97, 0xf9, 0x1e,
+	0x0e, 0x5f, 0xc0, 0xaa, 0xaa, 0x2d, 0x0f, 0x39, 0x8f, 0x2c, 0x5b, 0x6f,
+	0x01, 0x4e, 0x2c, 0xf6, 0x68, 0x09, 0x3c, 0xd8
+};
+
+/* Incorrect hash to test the negative case */
+const uint8_t hash_wrong[] = {
+	0x61, 0x1b, 0xd2, 0x44, 0xc7, 0x18, 0xa7, 0x2d, 0x0f, 0x2d, 0x3d, 0x0f,
+	0xe3, 0xb3, 0xc5, 0xe4, 0x12, 0xc2, 0x7b, 0x1e, 0x05, 0x2c, 0x6f, 0xad,
+	0xc4, 0xac, 0x71, 0x55, 0xe8, 0x80, 0x5c, 0x38
+};
+
+/* Generate signature:
+ * # openssl dgst -sha256 -sign key.pem README.md | xxd -i
+ */
+const uint8_t sig[] = {
+	0x30, 0xbb, 0x2e, 0x11, 0x2b, 0xad, 0x81, 0xed, 0xdf, 0xc3, 0x2b, 0xc4,
+	0xab, 0x7e, 0xca, 0xc6, 0x57, 0xe5, 0x9b, 0x15, 0x62, 0x17, 0x80, 0x07,
+	0x3a, 0x7f, 0x82, 0xb9, 0x1b, 0xe3, 0x64, 0xe3, 0x36, 0x23, 0x4f, 0x6b,
+	0xb3, 0xd8, 0x85, 0xf8, 0xcd, 0xf3, 0x37, 0x20, 0xd6, 0xab, 0x51, 0xfa,
+	0x7d, 0x3e, 0xd1, 0xa0, 0xd1, 0x79, 0x51, 0xdc, 0x9c, 0xd3, 0x80, 0x0a,
+	0x9e, 0x48, 0x5d, 0x6c, 0x16, 0x09, 0x59, 0x64, 0x7b, 0x51, 0xf3, 0x3d,
+	0xd1, 0x14, 0x06, 0x3f, 0x9d, 0x20, 0x78, 0x86, 0x51, 0xa8, 0xcf, 0x1d,
+	0x9d, 0xf7, 0x07, 0x21, 0x7c, 0x68, 0xa2, 0xe4, 0x86, 0x19, 0x24, 0x27,
+	0xc2, 0x8e, 0x33, 0xbc, 0x51, 0x7a, 0x9b, 0xc8, 0x1e, 0x5a, 0x52, 0x0b,
+	0x4e, 0xef, 0x0b, 0x69, 0xd4, 0x32, 0x53, 0x5e, 0x1d, 0x20, 0xb6, 0x64,
+	0x0b, 0x4f, 0x91, 0xfe, 0x8d, 0x37, 0xb7, 0x4b, 0x52, 0xd3, 0x40, 0x5c,
+	0x2a, 0x8c, 0xa7, 0xd1, 0x25, 0xf4, 0xe9, 0xe6, 0xb6, 0xc6, 0x56, 0x28,
+	0xec, 0x14, 0xea, 0x2f, 0x21, 0x4e, 0x92, 0x41, 0xfb, 0xd2, 0x25, 0xb8,
+	0xd1, 0x1c, 0x36, 0x54, 0x1c, 0x96, 0x3e, 0x01, 0x55, 0x19, 0xb2, 0x93,
+	0xe2, 0x55, 0x8f, 0x22, 0x38, 0xe4, 0xb2, 0x74, 0xa0, 0x7f, 0x0e, 0xc8,
+	0xee, 0xf8, 0x9f, 0x51, 0x23, 0xed, 0x68, 0x6a, 0x60, 0xf2, 0x51, 0xef,
+	0x0c, 0xab, 0x5f, 0x27, 0x62, 0x6d, 0x91, 0x3a, 0xaa, 0xca, 0x1a, 0x7d,
+	0x77, 0xb7, 0xa0, 0x4a, 0x47, 0xf1, 0xf4, 0xd7, 0x3f, 0xc4, 0x22, 0x01,
+	0xc6, 0x94, 0x93, 0x50, 0xe2, 0xda, 0xd7, 0x1f, 0x55, 0x5d, 0x3b, 0xa6,
+	0x16, 0x22, 0xc3, 0x3f, 0xe6, 0x44, 0x47, 0x26, 0xaa, 0xa5, 0xce, 0x8d,
+	0x3b, 0xf1, 0x0d, 0x89, 0xe7, 0xd1, 0xce, 0x1e, 0xe5, 0x34, 0x14, 0x78,
+	0x68, 0x7e, 0xcc, 0x01, 0x4a, 0x7e, 0x67, 0x7a, 0x85, 0xaa, 0xbd, 0xb1,
+	0x9e, 0xe7, 0x87, 0x34, 0x4f, 0x0c, 0xa6, 0xf5, 0xb8, 0xe8, 0x90, 0x24,
+	0x5d, 0xbb, 0x44, 0x29, 0x3d, 0x46, 0xf3, 0xc5, 0x9b, 0x38, 0x89, 0xd2,
+	0xd9, 0x22, 0x7b, 0xbe, 0x62, 0xd5, 0xe5, 0x42, 0xe1, 0x9c, 0x0d, 0x52,
+	0x31, 0x9c, 0xab, 0x2a, 0xfe, 0x34, 0x02, 0x3e, 0xdc, 0x5a, 0x60, 0xd1,
+	0x13, 0x0b, 0xc8, 0xb9, 0x16, 0x96, 0x79, 0x84, 0x77, 0xb1, 0x9f, 0xe8,
+	0xc5, 0xc4, 0x53, 0x8c, 0xf3, 0xdd, 0x88, 0x80, 0x08, 0x98, 0x8b, 0x7c,
+	0x10, 0xfb, 0xa0, 0xce, 0x1d, 0xb9, 0xb2, 0x8f, 0xb5, 0x59, 0xd6, 0x47,
+	0x92, 0x7a, 0x67, 0x73, 0x0d, 0x87, 0x72, 0x11, 0x60, 0x37, 0x21, 0xb3,
+	0xdc, 0xc6, 0x28, 0x5f, 0x54, 0x36, 0xb9, 0x5c, 0xc2, 0xab, 0x4a, 0xde,
+	0xef, 0x01, 0x9e, 0x99, 0xe1, 0xf6, 0xc7, 0xad, 0xa6, 0x0b, 0x0d, 0xa3
+};
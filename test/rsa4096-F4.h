@@ -0,0 +1,170 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * RSA 4096 with F4 exponent public key and verification.
+ * Private key in rsa4096-F4.pem.
+ */
+
+/* First generate a key:
+ * # openssl genrsa -out key.pem 4096
+ * # openssl rsa -in key.pem -pubout > key.pub
+ * Then dump the key:
+ * # dumpRSAPublicKey -pub key.pub | xxd -i
+ */
+const uint8_t rsa_data[] = {
+	0x80, 0x00, 0x00, 0x00, 0x9f, 0xee, 0x4a, 0xde, 0xa1, 0x52, 0xef, 0x14,
+	0x2b, 0xa2, 0x92, 0x11, 0x10, 0x9e, 0xff, 0x26, 0x00, 0xd2, 0xcb, 0x06,
+	0x8c, 0xe4, 0x30, 0xd9, 0x07, 0xd0, 0x93, 0xef, 0x29, 0x1c, 0x2e, 0xc1,
+	0x97, 0x01, 0x07, 0x1b, 0xfe, 0x45, 0xff, 0x26, 0xcf, 0x95, 0x9b, 0xb0,
+	0x41, 0x24, 0x75, 0x3a, 0x97, 0xcb, 0x51, 0x95, 0xf5, 0xee, 0x94, 0x50,
+	0x1b, 0xe4, 0x71, 0xbd, 0x94, 0xa7, 0x28, 0x44, 0x80, 0xa9, 0xb8, 0x9e,
+	0x96, 0x48, 0x5f, 0x40, 0x7f, 0xc1, 0xc3, 0x96, 0xce, 0xd5, 0x0d, 0x1d,
+	0x64, 0x01, 0x6e, 0x52, 0x37, 0xd7, 0xe7, 0xc9, 0xb0, 0x3a, 0x56, 0x5a,
+	0x89, 0x76, 0x0a, 0x88, 0xc8, 0x7e, 0xc4, 0x80, 0x42, 0xb6, 0x1c, 0x00,
+	0xec, 0x9e, 0x84, 0x02, 0xd5, 0xa4, 0xfa, 0xf0, 0x98, 0x06, 0x7c, 0x83,
+	0xd8, 0xc4, 0x87, 0x3b, 0x6a, 0x1c, 0xb7, 0x6e, 0xc2, 0x29, 0xb3, 0x41,
+	0xd5, 0x4a, 0x8a, 0x3e, 0x01, 0xcd, 0xfb, 0xac, 0x4c, 0x44, 0x1c, 0x45,
+	0xcb, 0x6f, 0xde, 0xc5, 0xb9, 0xde, 0x0c, 0x39, 0xf7, 0x29, 0x1e, 0x7b,
+	0x60, 0xc4, 0xf5, 0x4b, 0xad, 0xd2, 0xe0, 0xe6, 0x4b, 0x5b, 0x2d, 0x98,
+	0x3c, 0x83, 0xe2, 0xd9, 0x76, 0x8e, 0x80, 0x3a, 0x02, 0xb8, 0x4a, 0x9a,
+	0xa9, 0x4e, 0xbc, 0xc3, 0xf4, 0x25, 0x41, 0xef, 0xd7, 0x12, 0x4d, 0xf5,
+	0x80, 0x29, 0xad, 0xd1, 0xcb, 0xa6, 0x56, 0x69, 0xd6, 0xa5, 0xae, 0x0f,
+	0x94, 0x3a, 0xc9, 0x17, 0x8e, 0xa9, 0x9a, 0x25, 0xe0, 0x24, 0xba, 0xb3,
+	0x7e, 0x34, 0xa5, 0x29, 0xab, 0xbf, 0x92, 0xa0, 0x7e, 0x90, 0x6d, 0x4f,
+	0x60, 0xff, 0x91, 0xf2, 0x03, 0x28, 0x71, 0x40, 0x16, 0xb2, 0x0c, 0x54,
+	0x03, 0x8a, 0x0d, 0xcf, 0x6b, 0x09, 0x4f, 0xd9, 0x18, 0x22, 0x46, 0xc0,
+	0xd3, 0xb5, 0xf0, 0xa0, 0xf5, 0xfc, 0x37, 0x85, 0xe3, 0x13, 0xd3, 0x29,
+	0x53, 0xb8, 0x63, 0x57, 0xb6, 0x39, 0x33, 0x36, 0xe9, 0x88, 0xd2, 0x30,
+	0x3c, 0x93, 0x13, 0x3c, 0xc0, 0xe7, 0xfe, 0x61, 0xd6, 0xfa, 0xdb, 0x84,
+	0x37, 0x44, 0xfd, 0x56, 0xc9, 0x62, 0xae, 0x8d, 0x0b, 0xc8, 0xea, 0xc6,
+	0xd1, 0xa0, 0x55, 0x7a, 0x5d, 0xaf, 0x79, 0x94, 0x31, 0xf4, 0x9c, 0x2c,
+	0xe3, 0xb2, 0x85, 0xcc, 0xc1, 0x4d, 0x36, 0x47, 0xba, 0xbd, 0x00, 0x5b,
+	0x2b, 0x1f, 0x37, 0xa2, 0x9f, 0x52, 0xe5, 0x24, 0xd7, 0x88, 0x33, 0xb7,
+	0xfa, 0x2f, 0x30, 0x81, 0xce, 0x38, 0xf4, 0xc5, 0x4a, 0x12, 0x96, 0x64,
+	0xe9, 0x68, 0x40, 0x0c, 0x18, 0xaa, 0x12, 0xd4, 0x8e, 0x0e, 0xe4, 0xd8,
+	0x54, 0x48, 0x70, 0x84, 0x17, 0x35, 0x0c, 0xa2, 0xeb, 0x61, 0xc5, 0xc6,
+	0x87, 0x07, 0xab, 0x13, 0xe0, 0x94, 0x91, 0x02, 0xc2, 0x54, 0x5c, 0xfc,
+	0x68, 0xa8, 0xc3, 0x95, 0x61, 0x9b, 0x1c, 0xe8, 0x99, 0x8a, 0xc7, 0x51,
+	0x12, 0x04, 0xba, 0x28, 0x43, 0x92, 0x35, 0xd6, 0x3a, 0x7f, 0x44, 0x74,
+	0x82, 0x12, 0x06, 0x91, 0xa8, 0x25, 0xf3, 0x4a, 0xc5, 0x5a, 0xe7, 0xe9,
+	0x97, 0x5f, 0x48, 0xf0, 0x81, 0x39, 0x73, 0xab, 0xf6, 0xdf, 0xa3, 0x0f,
+	0xa6, 0x5e, 0x19, 0x56, 0x58, 0xf2, 0x87, 0x17, 0xc8, 0x8f, 0xa3, 0x27,
+	0xa9, 0x5b, 0x3e, 0x60, 0x0c, 0x29, 0x2b, 0xf8, 0x75, 0xc6, 0x47, 0x67,
+	0xef, 0x91, 0x9c, 0xd8, 0xac, 0x2b, 0x2c, 0x39, 0xb4, 0xa0, 0x1f, 0x09,
+	0x9a, 0x46, 0x86, 0x60, 0xc7, 0xa1, 0xc4, 0x26, 0x7d, 0xd8, 0x2a, 0xf7,
+	0x19, 0xeb, 0x51, 0xd7, 0x3d, 0x80, 0xb1, 0xfb, 0xe0, 0xf5, 0x47, 0x10,
+	0xce, 0x67, 0x72, 0x29, 0x28, 0x54, 0xef, 0xe4, 0xe0, 0x29, 0xe3, 0x0a,
+	0xb1, 0x94, 0x03, 0x3c, 0x2a, 0x5f, 0x02, 0xa3, 0x1c, 0x9e, 0x92, 0x3a,
+	0xe0, 0x77, 0x29, 0xde, 0xd0, 0x3c, 0x02, 0xff, 0x22, 0x36, 0x4c, 0xd1,
+	0x26, 0x6c, 0xc7, 0x82, 0x12, 0xb3, 0x49, 0x71, 0x2b, 0x8d, 0x7c, 0xf0,
+	0x23, 0x6f, 0x5a, 0xb6, 0x36, 0xf7, 0x51, 0xb4, 0x26, 0xd0, 0xd8, 0xef,
+	0x8d, 0xd9, 0x67, 0xe2, 0x5b, 0x0b, 0x81, 0xe7, 0x2d, 0x15, 0x1e, 0x8b,
+	0xd4, 0xc2, 0xa6, 0xf1, 0xb5, 0xc3, 0x0d, 0xb3, 0x34, 0x42, 0xc2, 0x07,
+	0x49, 0xfb, 0x1f, 0x32, 0x83, 0x9d, 0xab, 0xa1, 0xee, 0xb3, 0xe9, 0x9d,
+	0xfa, 0x68, 0xaa, 0x8b, 0xb3, 0xf7, 0x1e, 0x08, 0xbf, 0x78, 0xd0, 0x73,
+	0xc1, 0x28, 0x9c, 0xbc, 0x62, 0x34, 0x5d, 0xf7, 0x00, 0x60, 0x18, 0x70,
+	0x1b, 0x8a, 0x0c, 0x32, 0xc5, 0x9b, 0xbc, 0x33, 0xb7, 0x39, 0xdd, 0xf8,
+	0xbe, 0x9a, 0x4d, 0x1b, 0x72, 0x2f, 0xac, 0x25, 0x5c, 0x07, 0x06, 0x7a,
+	0x06, 0x97, 0x0b, 0x16, 0xee, 0xe9, 0x3a, 0xd4, 0x96, 0x54, 0x4c, 0xcf,
+	0x2b, 0xf2, 0xf5, 0xeb, 0xe4, 0xcb, 0xc2, 0x01, 0x24, 0xc1, 0x16, 0x3e,
+	0xbc, 0x1a, 0x90, 0x06, 0x5f, 0x2c, 0x04, 0xe9, 0x06, 0xc5, 0x99, 0xe9,
+	0x47, 0x34, 0x3a, 0x31, 0xda, 0xd7, 0xad, 0x4f, 0xea, 0x56, 0x5d, 0xc7,
+	0x42, 0x83, 0xec, 0x27, 0x34, 0xf2, 0xc9, 0xff, 0x95, 0x43, 0x0a, 0x6c,
+	0x5e, 0xfb, 0x1a, 0xc2, 0x24, 0x6c, 0xff, 0x78, 0xa9, 0xe4, 0x55, 0x98,
+	0xe2, 0xf6, 0xa8, 0x00, 0xae, 0x64, 0xbe, 0x2f, 0x22, 0xe3, 0x76, 0x41,
+	0xce, 0xea, 0x1d, 0x86, 0x8d, 0xe2, 0x74, 0x43, 0x9c, 0x60, 0x63, 0x8b,
+	0x5a, 0xe2, 0x6c, 0x7e, 0xeb, 0xad, 0xe8, 0x48, 0x1c, 0xfe, 0x71, 0x2c,
+	0x32, 0xb8, 0x05, 0x64, 0x00, 0x3f, 0x0e, 0xe2, 0x40, 0x1a, 0xb0, 0xf2,
+	0x56, 0x32, 0xdd, 0x5c, 0xba, 0x55, 0xdd, 0x75, 0xcf, 0x65, 0x57, 0xfc,
+	0x9a, 0x8f, 0xee, 0xec, 0x00, 0x11, 0xa3, 0x1f, 0xaa, 0xe1, 0xc4, 0xda,
+	0xd8, 0x2a, 0xbc, 0x16, 0xc8, 0x43, 0xc6, 0x73, 0xbb, 0x14, 0x9b, 0xce,
+	0x2f, 0xc4, 0x1e, 0xe7, 0x90, 0x84, 0x69, 0x19, 0x80, 0x4a, 0x30, 0xc7,
+	0x9a, 0xe5, 0x66, 0x47, 0x4c, 0x35, 0x88, 0xd5, 0xc1, 0xe7, 0x72, 0x26,
+	0xd1, 0x55, 0x77, 0x44, 0xd8, 0xd8, 0x7b, 0x5b, 0x0c, 0x01, 0x1c, 0xf3,
+	0x59, 0x53, 0x08, 0xff, 0x8e, 0x45, 0xfa, 0xd0, 0x13, 0xca, 0x71, 0x34,
+	0x88, 0xe2, 0x65, 0x6d, 0x6b, 0x38, 0xc8, 0xa5, 0x25, 0xdd, 0xff, 0xe7,
+	0xda, 0x87, 0x40, 0x84, 0x6f, 0x0e, 0x15, 0xa7, 0xa2, 0xd2, 0x72, 0xd2,
+	0xfa, 0xf1, 0x23, 0x30, 0x5e, 0xa0, 0x49, 0x88, 0xb3, 0x0b, 0xa7, 0x34,
+	0x87, 0x7d, 0xe2, 0x30, 0x83, 0x9f, 0x3c, 0xe0, 0x76, 0xeb, 0x2f, 0x1f,
+	0xa6, 0x6b, 0x19, 0x16, 0xc3, 0xd5, 0x74, 0xbd, 0x64, 0xba, 0x09, 0x86,
+	0x02, 0xdd, 0x73, 0x08, 0x74, 0x07, 0x8a, 0x9f, 0x9a, 0x57, 0x3f, 0x80,
+	0xad, 0xfc, 0xbd, 0x98, 0x14, 0x4a, 0x97, 0x7c, 0xa0, 0x08, 0xc1, 0x3b,
+	0x7a, 0x39, 0xaa, 0xd0, 0x52, 0x53, 0x99, 0x33, 0xf5, 0xe8, 0x0e, 0x3d,
+	0xbf, 0xe5, 0x31, 0xf9, 0x54, 0x38, 0x41, 0xce, 0xb7, 0x85, 0xd5, 0x49,
+	0x09, 0x93, 0x44, 0xe9, 0xec, 0x41, 0xd9, 0xd9, 0xc1, 0x12, 0xb1, 0x39,
+	0x7a, 0xc7, 0x56, 0x27, 0xcd, 0xa6, 0x65, 0x15, 0xd6, 0xaf, 0xec, 0x50,
+	0xe2, 0x08, 0x85, 0x65, 0x86, 0x1a, 0x71, 0x35, 0xce, 0x84, 0xe8, 0x87,
+	0x18, 0x36, 0x48, 0x0f, 0xc0, 0x81, 0x38, 0xa8, 0xc6, 0x8d, 0xff, 0x4b,
+	0x52, 0x48, 0xa8, 0xf8, 0x96, 0x9c, 0x31, 0x6e, 0xa7, 0xf7, 0xc4, 0x38,
+	0x3c, 0x04, 0xd2, 0xf4, 0xa8, 0xef, 0xd0, 0x8a, 0x9a, 0x12, 0xc9, 0xdd,
+	0xf4, 0x93, 0x19, 0xa1, 0xd8, 0x0d, 0x17, 0x6f, 0x6a, 0x21, 0x0a, 0x61
+};
+
+const struct rsa_public_key *rsa_key = (struct rsa_public_key *)rsa_data;
+BUILD_ASSERT(sizeof(*rsa_key) == sizeof(rsa_data));
+
+/* SHA-256 sum to verify:
+ * # sha256sum README.md | sed -e 's/\(..\)/0x\1, /mg'
+ */
+const uint8_t hash[] = {
+	0xb7, 0x3a, 0xa2, 0xf5, 0x38, 0xed, 0xc1, 0x4e, 0xe2, 0x97, 0xf9, 0x1e,
+	0x0e, 0x5f, 0xc0, 0xaa, 0xaa, 0x2d, 0x0f, 0x39, 0x8f, 0x2c, 0x5b, 0x6f,
+	0x01, 0x4e, 0x2c, 0xf6, 0x68, 0x09, 0x3c, 0xd8
+};
+
+/* Incorrect hash to test the negative case */
+const uint8_t hash_wrong[] = {
+	0x61, 0x1b, 0xd2, 0x44, 0xc7, 0x18, 0xa7, 0x2d, 0x0f, 0x2d, 0x3d, 0x0f,
+	0xe3, 0xb3, 0xc5, 0xe4, 0x12, 0xc2, 0x7b, 0x1e, 0x05, 0x2c, 0x6f, 0xad,
+	0xc4, 0xac, 0x71, 0x55, 0xe8, 0x80, 0x5c, 0x38
+};
+
+/* Generate signature:
+ * # openssl dgst -sha256 -sign key.pem README.md | xxd -i
+ */
+const uint8_t sig[] = {
+	0x42, 0x9c, 0x3e, 0x11, 0x7f, 0x08, 0xfd, 0x10, 0x23, 0x1b, 0xd3, 0x98,
+	0xd0, 0x8d, 0xf6, 0x83, 0xb4, 0xb8, 0x42, 0x74, 0x84, 0x82, 0xa3, 0xac,
+	0x9c, 0x8e, 0x6e, 0xce, 0x87, 0x97, 0xba, 0xc9, 0x9d, 0x0d, 0x6f, 0x2d,
+	0xe6, 0x02, 0xae, 0x35, 0x07, 0x46, 0x18, 0xf0, 0x06, 0xd6, 0xd1, 0xd4,
+	0x4b, 0x16, 0x41, 0xee, 0x8d, 0x54, 0xf0, 0x01, 0x01, 0xdb, 0x78, 0x75,
+	0xe5, 0x46, 0x74, 0x54, 0x7c, 0xfe, 0x8d, 0x04, 0xb5, 0x68, 0x3e, 0x50,
+	0x52, 0x33, 0x4d, 0xbb, 0x6e, 0xfc, 0xa9, 0x4b, 0x9a, 0x3a, 0x90, 0x14,
+	0x8f, 0xdc, 0x33, 0xc4, 0x0b, 0x9f, 0x96, 0x23, 0xfa, 0xe8, 0x1b, 0x44,
+	0xda, 0xb9, 0x39, 0xed, 0x4a, 0x92, 0x38, 0xe0, 0x53, 0xee, 0x56, 0x1f,
+	0xe0, 0xac, 0x94, 0x52, 0xa1, 0x28, 0xec, 0x90, 0x0f, 0xae, 0x47, 0x88,
+	0x40, 0xb2, 0xa7, 0x6c, 0xee, 0xc1, 0x56, 0x55, 0x2a, 0x12, 0x13, 0x15,
+	0x68, 0x54, 0x4d, 0x19, 0x25, 0x02, 0x89, 0xa3, 0x5a, 0x36, 0x79, 0xb1,
+	0x97, 0xeb, 0x00, 0x84, 0xe6, 0x9d, 0xe6, 0xc9, 0xff, 0x8f, 0x91, 0x7c,
+	0x85, 0x15, 0xea, 0x7d, 0xd8, 0x07, 0xaf, 0x1c, 0xae, 0xad, 0x23, 0x79,
+	0x00, 0x51, 0x45, 0xb1, 0xe1, 0x4c, 0x21, 0xe8, 0x14, 0xe9, 0xaa, 0x83,
+	0xbb, 0x8c, 0x5e, 0xdb, 0xa6, 0x1d, 0x6f, 0x7c, 0xfc, 0xc6, 0x55, 0x28,
+	0x87, 0xf3, 0x14, 0xca, 0xf7, 0x49, 0x34, 0x56, 0x27, 0x55, 0xe0, 0xfb,
+	0x57, 0x03, 0xb4, 0xcf, 0xea, 0x1e, 0x30, 0x47, 0x47, 0x9c, 0xd9, 0xfb,
+	0x06, 0x71, 0xde, 0x06, 0xcb, 0x98, 0x61, 0x2b, 0xb3, 0x10, 0xed, 0x61,
+	0xfe, 0x52, 0xcb, 0xcf, 0x20, 0xff, 0x7e, 0x24, 0xb4, 0x50, 0x24, 0xa0,
+	0xf4, 0x67, 0xaa, 0xd3, 0xf9, 0x00, 0xd0, 0xb6, 0x78, 0x6e, 0x6f, 0x2e,
+	0x0b, 0xfc, 0x0b, 0xd0, 0xd9, 0x4d, 0xba, 0x3e, 0x1c, 0xc3, 0x34, 0x83,
+	0x17, 0x32, 0x4e, 0x5c, 0x76, 0x85, 0xea, 0x62, 0xf7, 0x24, 0x12, 0x1d,
+	0x9a, 0x7a, 0x8a, 0x1f, 0x7d, 0x92, 0xce, 0x09, 0xd0, 0xd0, 0xa7, 0xff,
+	0x0d, 0x45, 0xcf, 0x67, 0xd1, 0xaf, 0x0b, 0xa8, 0x1c, 0x44, 0x5d, 0xd7,
+	0x09, 0xce, 0x07, 0x6b, 0x58, 0x44, 0x97, 0xb0, 0x10, 0x3b, 0xab, 0x91,
+	0x33, 0xde, 0x71, 0xd1, 0x3c, 0x0d, 0xf3, 0xf5, 0x98, 0x5e, 0xfb, 0x0e,
+	0xb8, 0xf5, 0x27, 0x53, 0xf5, 0x49, 0x71, 0x70, 0x13, 0xe1, 0x10, 0xab,
+	0x20, 0x25, 0x08, 0xa1, 0x66, 0xc7, 0x4a, 0xee, 0x14, 0x46, 0xd9, 0x31,
+	0x59, 0x3b, 0x48, 0x72, 0xb5, 0x5b, 0x08, 0xfb, 0xcf, 0x25, 0x0e, 0xb1,
+	0x71, 0xc1, 0x87, 0xb0, 0x88, 0x10, 0xdb, 0x24, 0x54, 0xab, 0x16, 0x59,
+	0x04, 0xee, 0x32, 0x0e, 0xfe, 0x26, 0xe7, 0x28, 0xbc, 0x1c, 0xeb, 0x78,
+	0x22, 0xff, 0xdd, 0x38, 0xea, 0xfd, 0xf6, 0x52, 0xca, 0x64, 0xbd, 0xac,
+	0x0d, 0xb4, 0x1d, 0xd4, 0xa4, 0xb3, 0x9d, 0x1a, 0xb7, 0x09, 0x05, 0xbd,
+	0x0a, 0x4d, 0x8a, 0xa7, 0xee, 0x17, 0x05, 0xdc, 0x56, 0x1d, 0x2f, 0x85,
+	0xf5, 0x27, 0xd4, 0x2d, 0x6f, 0x1c, 0xef, 0x0e, 0x47, 0x43, 0x10, 0x89,
+	0x95, 0xfd, 0x3d, 0x67, 0xcc, 0x90, 0xfc, 0x00, 0x44, 0x8b, 0xf5, 0x93,
+	0xa5, 0x19, 0x40, 0x2b, 0xbf, 0x0f, 0xe6, 0x16, 0x2a, 0x44, 0x27, 0xc4,
+	0x3f, 0xc8, 0xec, 0x52, 0x70, 0x16, 0x52, 0x41, 0x6d, 0x9c, 0xa2, 0x7a,
+	0x76, 0x6b, 0x88, 0x79, 0x54, 0x22, 0xd3, 0x07, 0x3e, 0xc4, 0xaa, 0x6a,
+	0xfa, 0x89, 0x10, 0x34, 0x36, 0xd3, 0x65, 0x05, 0x8d, 0x0a, 0x82, 0x50,
+	0xaa, 0x4f, 0x4b, 0x92, 0x74, 0xd2, 0xb9, 0xc2, 0x7a, 0xae, 0x09, 0x23,
+	0x04, 0x5d, 0x17, 0xcd, 0x71, 0x8f, 0x5e, 0xcc
+};
@@ -0,0 +1,196 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Tests for the shared memory slab pools.
+ */
+
+#include "common.h"
+#include "console.h"
+#include "shared_mem.h"
+#include "task.h"
+#include "test_util.h"
+#include "util.h"
+
+#define SLAB_BENCH_LOOPS 10000
+
+static void get_stats(int class, struct shared_mem_slab_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	shared_mem_slab_get_stats(class, stats);
+}
+
+static int test_slab_classes(void)
+{
+	struct shared_mem_slab_stats small, large;
+	char *a, *b;
+
+	get_stats(0, &small);
+	get_stats(1, &large);
+	TEST_EQ(small.size, 64, "%d");
+	TEST_EQ(small.count, 8, "%d");
+	TEST_EQ(large.size, 1024, "%d");
+	TEST_EQ(large.count, 2, "%d");
+	TEST_EQ(shared_mem_slab_get_stats(2, &small), EC_ERROR_INVAL, "%d");
+
+	/* Requests go to the smallest class that fits */
+	TEST_EQ(shared_mem_slab_acquire(10, &a), EC_SUCCESS, "%d");
+	TEST_EQ(shared_mem_slab_acquire(65, &b), EC_SUCCESS, "%d");
+	TEST_NE(a, b, "%p");
+
+	get_stats(0, &small);
+	get_stats(1, &large);
+	TEST_EQ(small.in_use, 1, "%d");
+	TEST_EQ(large.in_use, 1, "%d");
+
+	memset(a, 0xa5, 64);
+	memset(b, 0x5a, 1024);
+
+	shared_mem_slab_release(a);
+	shared_mem_slab_release(b);
+
+	get_stats(0, &small);
+	get_stats(1, &large);
+	TEST_EQ(small.in_use, 0, "%d");
+	TEST_EQ(large.in_use, 0, "%d");
+
+	/* A released buffer is handed out again */
+	TEST_EQ(shared_mem_slab_acquire(64, &b), EC_SUCCESS, "%d");
+	TEST_EQ(a, b, "%p");
+	shared_mem_slab_release(b);
+
+	return EC_SUCCESS;
+}
+
+static int test_slab_exhaust(void)
+{
+	struct shared_mem_slab_stats stats, before;
+	char *buf[9];
+	int i, j;
+
+	get_stats(0, &before);
+
+	for (i = 0; i < ARRAY_SIZE(buf); i++)
+		TEST_EQ(shared_mem_slab_acquire(32, buf + i), EC_SUCCESS, "%d");
+
+	/* Slab buffers never overlap */
+	for (i = 0; i < 8; i++)
+		for (j = i + 1; j < 8; j++)
+			TEST_ASSERT(buf[i] + 64 <= buf[j] ||
+				    buf[j] + 64 <= buf[i]);
+
+	/* The ninth came from shared memory */
+	get_stats(0, &stats);
+	TEST_EQ(stats.in_use, 8, "%d");
+	TEST_EQ(stats.peak, 8, "%d");
+	TEST_EQ(stats.acquired, before.acquired + 8, "%u");
+	TEST_EQ(stats.fallbacks, before.fallbacks + 1, "%u");
+
+	for (i = 0; i < ARRAY_SIZE(buf); i++)
+		shared_mem_slab_release(buf[i]);
+
+	get_stats(0, &stats);
+	TEST_EQ(stats.in_use, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static char *isr_buf;
+static int isr_ran;
+
+static void release_isr(void)
+{
+	isr_ran = in_interrupt_context();
+	shared_mem_slab_release(isr_buf);
+}
+
+static int test_slab_release_from_isr(void)
+{
+	struct shared_mem_slab_stats stats;
+	char *buf;
+
+	TEST_EQ(shared_mem_slab_acquire(64, &isr_buf), EC_SUCCESS, "%d");
+	task_trigger_test_interrupt(release_isr);
+	TEST_ASSERT(isr_ran);
+
+	/* The buffer is free again, not leaked */
+	get_stats(0, &stats);
+	TEST_EQ(stats.in_use, 0, "%d");
+	TEST_EQ(shared_mem_slab_acquire(64, &buf), EC_SUCCESS, "%d");
+	TEST_EQ(buf, isr_buf, "%p");
+	shared_mem_slab_release(buf);
+
+	return EC_SUCCESS;
+}
+
+static int test_slab_oversize(void)
+{
+	struct shared_mem_slab_stats before, after;
+	char *buf;
+
+	get_stats(1, &before);
+
+	/* Larger than any class, so served by shared memory */
+	TEST_EQ(shared_mem_slab_acquire(2048, &buf), EC_SUCCESS, "%d");
+	memset(buf, 0, 2048);
+	shared_mem_slab_release(buf);
+
+	get_stats(1, &after);
+	TEST_EQ(after.acquired, before.acquired, "%u");
+	TEST_EQ(after.fallbacks, before.fallbacks, "%u");
+
+	return EC_SUCCESS;
+}
+
+/*
+ * Compare the cost of a 64-byte acquire/release pair from the slabs against
+ * shared memory with a few buffers already held in it.
+ */
+static int test_slab_bench(void)
+{
+	char *held[6];
+	char *buf;
+	uint64_t t0, t1, t2;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(held); i++)
+		TEST_EQ(shared_mem_acquire(128 * (i + 1), held + i),
+			EC_SUCCESS, "%d");
+	for (i = 0; i < ARRAY_SIZE(held); i += 2)
+		shared_mem_release(held[i]);
+
+	t0 = test_get_bench_time();
+	for (i = 0; i < SLAB_BENCH_LOOPS; i++) {
+		TEST_EQ(shared_mem_slab_acquire(64, &buf), EC_SUCCESS, "%d");
+		shared_mem_slab_release(buf);
+	}
+	t1 = test_get_bench_time();
+	for (i = 0; i < SLAB_BENCH_LOOPS; i++) {
+		TEST_EQ(shared_mem_acquire(64, &buf), EC_SUCCESS, "%d");
+		shared_mem_release(buf);
+	}
+	t2 = test_get_bench_time();
+
+	for (i = 1; i < ARRAY_SIZE(held); i += 2)
+		shared_mem_release(held[i]);
+
+	ccprintf("slab x%d duration %lld us\n", SLAB_BENCH_LOOPS,
+		 (long long)(t1 - t0));
+	ccprintf("shared_mem x%d duration %lld us\n", SLAB_BENCH_LOOPS,
+		 (long long)(t2 - t1));
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_slab_classes);
+	RUN_TEST(test_slab_release_from_isr);
+	RUN_TEST(test_slab_exhaust);
+	RUN_TEST(test_slab_oversize);
+	RUN_TEST(test_slab_bench);
+
+	test_print_result();
+}
@@ -18,6 +18,10 @@
 /* Host commands are sorted. */
 #define CONFIG_HOSTCMD_SECTION_SORTED
 
+/* Dispatch host commands by table */
+#define CONFIG_HOSTCMD_DISPATCH_TABLE
+#define CONFIG_HOSTCMD_BATCH
+
 /* Don't compile features unless specifically testing for them */
 #undef CONFIG_VBOOT_HASH
 #undef CONFIG_USB_PD_LOGGING
@@ -49,6 +53,14 @@
 #define CONFIG_MALLOC
 #endif
 
+#ifdef TEST_HOOKS_DEBUG
+#define CONFIG_HOOK_DEBUG
+#endif
+
+#ifdef TEST_HOST_COMMAND
+#define CONFIG_HOSTCMD_STATS
+#endif
+
 #ifdef TEST_KB_8042
 #define CONFIG_KEYBOARD_PROTOCOL_8042
 #endif
@@ -219,8 +231,27 @@ enum sensor_id {
 
 #endif
 
-#ifdef TEST_CRC32
+#if defined(TEST_CRC32) || defined(TEST_CRC32_NIBBLE) || \
+	defined(TEST_CRC32_SLICE4) || defined(TEST_CRC32_SLICE8)
 #define CONFIG_SW_CRC
+#define CONFIG_CRC8
+#endif
+
+#ifdef TEST_CONSOLE_BINLOG
+#define CONFIG_CONSOLE_BINARY_LOG
+#endif
+
+#ifdef TEST_CRC32_NIBBLE
+#define CONFIG_SW_CRC_NIBBLE
+#endif
+
+#ifdef TEST_CRC32_SLICE4
+#define CONFIG_SW_CRC_SLICE_BY_4
+#endif
+
+#ifdef TEST_CRC32_SLICE8
+#define CONFIG_SW_CRC_SLICE_BY_8
+#define CONFIG_CRC8_TABLE
 #endif
 
 #ifdef TEST_RSA
@@ -239,6 +270,22 @@ enum sensor_id {
 #define CONFIG_RWSIG_TYPE_RWSIG
 #endif
 
+#ifdef TEST_RSA3072
+#define CONFIG_RSA
+#undef CONFIG_RSA_KEY_SIZE
+#define CONFIG_RSA_KEY_SIZE 3072
+#undef CONFIG_RSA_EXPONENT_3
+#define CONFIG_RWSIG_TYPE_RWSIG
+#endif
+
+#ifdef TEST_RSA4096
+#define CONFIG_RSA
+#undef CONFIG_RSA_KEY_SIZE
+#define CONFIG_RSA_KEY_SIZE 4096
+#undef CONFIG_RSA_EXPONENT_3
+#define CONFIG_RWSIG_TYPE_RWSIG
+#endif
+
 #ifdef TEST_SHA256
 #define CONFIG_SHA256
 #endif
@@ -248,10 +295,21 @@ enum sensor_id {
 #define CONFIG_SHA256_UNROLLED
 #endif
 
+#ifdef TEST_SHA256_HW
+#define CONFIG_SHA256
+#define CONFIG_SHA256_HW_ACCELERATE
+#endif
+
 #ifdef TEST_SHMALLOC
 #define CONFIG_MALLOC
 #endif
 
+#ifdef TEST_SHMEM_SLAB
+#define CONFIG_MALLOC
+#define CONFIG_SHARED_MEM_SLABS \
+	SHARED_MEM_SLAB(64, 8) SHARED_MEM_SLAB(1024, 2)
+#endif
+
 #ifdef TEST_SBS_CHARGING_V2
 #define CONFIG_BATTERY
 #define CONFIG_BATTERY_MOCK
@@ -282,6 +340,10 @@ int board_discharge_on_ac(int enabled);
 int ncp15wb_calculate_temp(uint16_t adc);
 #endif
 
+#ifdef TEST_TIMER_QUEUE
+#define CONFIG_TIMER_QUEUE
+#endif
+
 #ifdef TEST_FAN
 #define CONFIG_FANS 1
 #endif
@@ -304,6 +366,16 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define I2C_PORT_CHARGER 0
 #endif
 
+#ifdef TEST_BATTERY_SMART_CACHE
+#define CONFIG_BATTERY_SMART
+#define CONFIG_BATTERY_SMART_CACHE
+#define CONFIG_I2C
+#define CONFIG_I2C_MASTER
+#define I2C_PORT_MASTER 0
+#define I2C_PORT_BATTERY 0
+#define I2C_PORT_CHARGER 0
+#endif
+
 #ifdef TEST_CEC
 #define CONFIG_CEC
 #endif
@@ -464,7 +536,7 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #undef CONFIG_USB_PD_HOST_CMD
 #endif
 
-#ifdef TEST_USB_TCPMV2_TCPCI
+#if defined(TEST_USB_TCPMV2_TCPCI) || defined(TEST_USB_TCPMV2_TCPCI_BURST)
 #define CONFIG_USB_DRP_ACC_TRYSRC
 #define CONFIG_USB_PD_DUAL_ROLE
 #define CONFIG_USB_PD_DUAL_ROLE_AUTO_TOGGLE
@@ -577,6 +649,27 @@ int ncp15wb_calculate_temp(uint16_t adc);
 					 CONFIG_RW_SIZE - CONFIG_RW_SIG_SIZE)
 #endif
 
+#ifdef TEST_VBOOT_HASH
+#define CONFIG_VBOOT_HASH
+#define CONFIG_VBOOT_HASH_CACHE
+#endif
+
+#ifdef TEST_VBOOT_HASH_PIPELINE
+/* Read the flash as a SPI flash chip would, with the test's async reads */
+#undef CONFIG_MAPPED_STORAGE
+#undef CONFIG_FLASH_PSTATE
+#undef CONFIG_FLASH_PSTATE_BANK
+#define CONFIG_FLASH_READ_ASYNC
+#define CONFIG_VBOOT_HASH
+#define CONFIG_VBOOT_HASH_CACHE
+#define CONFIG_VBOOT_HASH_PIPELINE
+/* Both chunk buffers must fit in CONFIG_SHAREDMEM_MINIMUM_SIZE */
+#undef CONFIG_VBOOT_HASH_CHUNK_SIZE
+#define CONFIG_VBOOT_HASH_CHUNK_SIZE 512
+#undef CONFIG_VBOOT_HASH_CHUNKS_PER_STEP
+#define CONFIG_VBOOT_HASH_CHUNKS_PER_STEP 3
+#endif
+
 #ifdef TEST_X25519
 #define CONFIG_CURVE25519
 #endif /* TEST_X25519 */
@@ -588,5 +681,27 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define I2C_BITBANG_PORT_COUNT 1
 #endif
 
+#ifdef TEST_I2C_ASYNC
+#define CONFIG_I2C_ASYNC
+/* Use a port number past I2C_PORT_COUNT, as MCHP boards do */
+#define CONFIG_I2C_MULTI_PORT_CONTROLLER
+#undef I2C_PORT_EEPROM
+#define I2C_PORT_EEPROM 6
+#endif
+
+#ifdef TEST_I2C_STATS
+#define CONFIG_I2C_STATS
+#undef CONFIG_I2C_STATS_DEVICES
+#define CONFIG_I2C_STATS_DEVICES 2
+#undef CONFIG_I2C_NACK_RETRY_COUNT
+#define CONFIG_I2C_NACK_RETRY_COUNT 2
+#endif
+
+#ifdef TEST_I2C_TRACE_BUFFER
+#define CONFIG_I2C_TRACE_BUFFER
+#undef CONFIG_I2C_TRACE_BUFFER_SIZE
+#define CONFIG_I2C_TRACE_BUFFER_SIZE 8
+#endif
+
 #endif  /* TEST_BUILD */
 #endif  /* __TEST_TEST_CONFIG_H */
@@ -37,7 +37,9 @@ int task_timer(void *seed)
 	uint32_t num = (uint32_t)(uintptr_t)seed;
 	int golden_cnt = calculate_golden(num);
 	task_id_t id = task_get_current();
-	timestamp_t start;
+	timestamp_t start, deadline;
+	uint32_t late, late_max = 0;
+	uint64_t late_total = 0;
 	int cnt = 0;
 
 	while (1) {
@@ -48,13 +50,20 @@ int task_timer(void *seed)
 
 		while (get_time().val - start.val < TEST_TIME) {
 			/* Wait for a "random" period */
+			deadline.val = get_time().val + PERIOD_US(num);
 			task_wait_event(PERIOD_US(num));
+			/* How long after its deadline the task got to run */
+			late = get_time().val - deadline.val;
+			late_max = MAX(late_max, late);
+			late_total += late;
 			ccprintf("%01d\n", id);
 			cnt++;
 			/* next pseudo random delay */
 			num = prng(num);
 		}
 		ccprintf("Task %d: Count=%d Golden=%d\n", id, cnt, golden_cnt);
+		ccprintf("Task %d: wake latency avg %d us max %d us\n", id,
+			 cnt ? (int)(late_total / cnt) : 0, late_max);
 		cnt -= golden_cnt;
 		if (cnt < 0)
 			cnt = -cnt;
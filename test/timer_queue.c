@@ -0,0 +1,179 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the deadline queue behind the common timer module.
+ */
+
+#include "common.h"
+#include "test_util.h"
+#include "timer.h"
+#include "timer_queue.h"
+#include "util.h"
+
+/* Timers used by the test; any task ID will do */
+#define TA 0
+#define TB 1
+#define TC 2
+#define TD 3
+BUILD_ASSERT(TASK_ID_COUNT > TD);
+
+static struct timer_queue q;
+static timestamp_t deadline[TASK_ID_COUNT];
+static uint32_t running;
+
+static void arm(int tskid, uint64_t t)
+{
+	deadline[tskid].val = t;
+	running |= BIT(tskid);
+	timer_queue_update(&q, BIT(tskid), running, deadline);
+}
+
+static int pop(uint64_t t)
+{
+	timestamp_t now = { .val = t };
+	int tskid = timer_queue_pop_expired(&q, running, deadline, now);
+
+	/* Expiring a timer stops it, as in process_timers() */
+	if (tskid >= 0)
+		running &= ~BIT(tskid);
+	return tskid;
+}
+
+static uint64_t next(uint64_t t)
+{
+	timestamp_t now = { .val = t };
+	timestamp_t n;
+
+	if (!timer_queue_next(&q, deadline, now, &n))
+		return -1ull;
+	return n.val;
+}
+
+static void reset(void)
+{
+	memset(&q, 0, sizeof(q));
+	running = 0;
+}
+
+static int test_insert(void)
+{
+	reset();
+	arm(TA, 300);
+	arm(TB, 100);
+	arm(TC, 200);
+	TEST_EQ(q.len, 3, "%d");
+	TEST_ASSERT(next(0) == 100ull);
+
+	/* Nothing is due early, and each timer expires at its deadline */
+	TEST_EQ(pop(99), -1, "%d");
+	TEST_EQ(pop(100), TB, "%d");
+	TEST_EQ(pop(100), -1, "%d");
+	TEST_ASSERT(next(100) == 200ull);
+
+	/* Late processing expires every timer due, earliest first */
+	TEST_EQ(pop(1000), TC, "%d");
+	TEST_EQ(pop(1000), TA, "%d");
+	TEST_EQ(pop(1000), -1, "%d");
+	TEST_EQ(q.len, 0, "%d");
+	TEST_ASSERT(next(1000) == -1ull);
+
+	return EC_SUCCESS;
+}
+
+static int test_equal_deadlines(void)
+{
+	reset();
+	arm(TC, 100);
+	arm(TA, 50);
+	arm(TB, 100);
+	arm(TD, 100);
+
+	/* Timers with the same deadline expire in the order they were armed */
+	TEST_EQ(pop(100), TA, "%d");
+	TEST_EQ(pop(100), TC, "%d");
+	TEST_EQ(pop(100), TB, "%d");
+	TEST_EQ(pop(100), TD, "%d");
+	TEST_EQ(pop(100), -1, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_cancel(void)
+{
+	reset();
+	arm(TA, 100);
+	arm(TB, 200);
+	arm(TC, 300);
+
+	/*
+	 * Cancelling only clears the running bit; the stale entry is dropped
+	 * when it reaches the front, without expiring the timer.
+	 */
+	running &= ~BIT(TA);
+	TEST_EQ(pop(150), -1, "%d");
+	TEST_EQ(q.len, 2, "%d");
+	TEST_ASSERT(next(150) == 200ull);
+
+	/* Cancelled and re-armed later before the queue caught up */
+	running &= ~BIT(TB);
+	arm(TB, 400);
+	TEST_EQ(q.len, 2, "%d");
+	TEST_ASSERT(next(150) == 300ull);
+	TEST_EQ(pop(350), TC, "%d");
+	TEST_EQ(pop(350), -1, "%d");
+	TEST_EQ(pop(400), TB, "%d");
+
+	/* Cancelled and re-armed earlier */
+	arm(TA, 1000);
+	arm(TB, 2000);
+	running &= ~BIT(TB);
+	arm(TB, 500);
+	TEST_EQ(q.len, 2, "%d");
+	TEST_EQ(pop(600), TB, "%d");
+	TEST_EQ(pop(600), -1, "%d");
+
+	/* A timer armed while stopped is not queued */
+	running &= ~BIT(TA);
+	timer_queue_update(&q, BIT(TA), running, deadline);
+	TEST_EQ(q.len, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_overflow(void)
+{
+	const uint64_t epoch = 1ull << 32;
+
+	reset();
+	arm(TA, epoch + 100);
+	arm(TB, epoch - 100);
+
+	/* Only the deadline in the current epoch goes to the comparator */
+	TEST_ASSERT(next(epoch - 1000) == epoch - 100);
+	TEST_EQ(pop(epoch - 100), TB, "%d");
+	TEST_ASSERT(next(epoch - 50) == -1ull);
+	TEST_EQ(pop(epoch - 50), -1, "%d");
+
+	/* After the overflow the later deadline is programmed */
+	TEST_ASSERT(next(epoch) == epoch + 100);
+	TEST_EQ(pop(epoch + 100), TA, "%d");
+
+	/* A deadline already missed in an earlier epoch still expires */
+	arm(TC, epoch - 1);
+	TEST_EQ(pop(epoch + 200), TC, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_insert);
+	RUN_TEST(test_equal_deadlines);
+	RUN_TEST(test_cancel);
+	RUN_TEST(test_overflow);
+
+	test_print_result();
+}
@@ -0,0 +1,97 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test batched UART transmit from the console output buffer.
+ */
+
+#include "common.h"
+#include "console.h"
+#include "test_util.h"
+#include "timer.h"
+#include "uart.h"
+#include "util.h"
+
+#define BENCH_LINES 2000
+
+static char line[CONFIG_UART_TX_BUF_SIZE / 4];
+
+/* Fill line[] with len - 1 printable characters and a newline */
+static void make_line(int len, char first)
+{
+	int i;
+
+	for (i = 0; i < len - 1; i++)
+		line[i] = first + i % 26;
+	line[len - 1] = '\n';
+	line[len] = '\0';
+}
+
+static int test_wrap(void)
+{
+	const char *captured;
+	int i, len = sizeof(line) - 1;
+	int rv = EC_SUCCESS;
+
+	/*
+	 * Write enough to wrap the output buffer a few times, so that spans
+	 * are cut at the end of the buffer.
+	 */
+	test_capture_console(1);
+	for (i = 0; i < 6; i++) {
+		make_line(len, 'a' + i);
+		rv |= uart_puts(line);
+		cflush();
+	}
+	test_capture_console(0);
+	TEST_EQ(rv, EC_SUCCESS, "%d");
+
+	captured = test_get_captured_console();
+	for (i = 0; i < 6; i++) {
+		make_line(len, 'a' + i);
+		TEST_ASSERT_ARRAY_EQ(captured, line, len - 1);
+		TEST_ASSERT_ARRAY_EQ(captured + len - 1, "\r\n", 2);
+		captured += len + 1;
+	}
+
+	return EC_SUCCESS;
+}
+
+static int test_bench(void)
+{
+	struct uart_tx_stats stats;
+	uint64_t t0, t1;
+	int i;
+
+	test_reset_uart_tx_stats();
+	t0 = test_get_bench_time();
+	for (i = 0; i < BENCH_LINES; i++)
+		cprintf(CC_SYSTEM, "line %4d: the quick brown fox jumps over "
+			"the lazy dog\n", i);
+	cflush();
+	t1 = test_get_bench_time();
+	test_get_uart_tx_stats(&stats);
+
+	ccprintf("%lld bytes in %lld us: %lld bytes/s, %lld ns CPU/byte, "
+		 "%lld bytes/write\n",
+		 (long long)stats.bytes, (long long)(t1 - t0),
+		 (long long)(stats.bytes * SECOND / MAX(t1 - t0, 1)),
+		 (long long)(stats.cpu_ns / MAX(stats.bytes, 1)),
+		 (long long)(stats.bytes / MAX(stats.writes, 1)));
+
+	/* Output leaves the buffer a span at a time, not a byte at a time */
+	TEST_ASSERT(stats.bytes >= BENCH_LINES * 56);
+	TEST_ASSERT(stats.writes * 8 < stats.bytes);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_wrap);
+	RUN_TEST(test_bench);
+
+	test_print_result();
+}
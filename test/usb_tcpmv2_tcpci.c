@@ -16,6 +16,20 @@
 
 #define PORT0 0
 
+/*
+ * I2C transactions to handle a CC and power status alert.  Burst reads take
+ * ALERT through ALERT_EXT in one, then clear ALERT and read the status
+ * registers again in another.  Otherwise ALERT, ROLE_CTRL, CC_STATUS,
+ * POWER_STATUS and both mask registers are read one at a time.
+ */
+#ifdef TEST_USB_TCPMV2_TCPCI_BURST
+#define TCPC_FLAGS (TCPC_FLAGS_TCPCI_REV2_0 | TCPC_FLAGS_ALERT_BURST_READ)
+#define ALERT_XFERS 3
+#else
+#define TCPC_FLAGS TCPC_FLAGS_TCPCI_REV2_0
+#define ALERT_XFERS 7
+#endif
+
 enum mock_cc_state {
 	MOCK_CC_SRC_OPEN = 0,
 	MOCK_CC_SNK_OPEN = 0,
@@ -91,7 +105,7 @@ const struct tcpc_config_t tcpc_config[CONFIG_USB_PD_PORT_MAX_COUNT] = {
 			.addr_flags = MOCK_TCPCI_I2C_ADDR_FLAGS,
 		},
 		.drv = &tcpci_tcpm_drv,
-		.flags = TCPC_FLAGS_TCPCI_REV2_0,
+		.flags = TCPC_FLAGS,
 	},
 };
 
@@ -145,6 +159,24 @@ __maybe_unused static int test_startup_and_resume(void)
 }
 
 
+__maybe_unused static int test_alert_xfers(void)
+{
+	int count;
+
+	/* Attached, so the TCPC stays out of low power mode */
+	TEST_EQ(test_connect_as_nonpd_sink(), EC_SUCCESS, "%d");
+
+	mock_tcpci_set_reg(TCPC_REG_ALERT, TCPC_REG_ALERT_CC_STATUS |
+			   TCPC_REG_ALERT_POWER_STATUS);
+	count = mock_tcpci_get_xfer_count();
+	tcpci_tcpc_alert(PORT0);
+	TEST_EQ(mock_tcpci_get_xfer_count() - count, ALERT_XFERS, "%d");
+	TEST_EQ(mock_tcpci_get_reg(TCPC_REG_ALERT), 0, "%d");
+
+	task_wait_event(10 * SECOND);
+	return EC_SUCCESS;
+}
+
 __maybe_unused static int test_connect_as_pd3_source(void)
 {
 	uint32_t rdo = RDO_FIXED(1, 500, 500, 0);
@@ -383,6 +415,7 @@ void run_test(int argc, char **argv)
 
 	RUN_TEST(test_connect_as_nonpd_sink);
 	RUN_TEST(test_startup_and_resume);
+	RUN_TEST(test_alert_xfers);
 	RUN_TEST(test_connect_as_pd3_source);
 	RUN_TEST(test_retry_count_sop);
 	RUN_TEST(test_retry_count_hard_reset);
@@ -0,0 +1,201 @@
+/* Copyright 2021 The Chromium OS Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the vboot hash and its cache of intermediate states.  The
+ * vboot_hash_pipeline variant hashes through non-mapped, asynchronous reads.
+ */
+
+#include "common.h"
+#include "ec_commands.h"
+#include "flash.h"
+#include "host_command.h"
+#include "sha256.h"
+#include "test_util.h"
+#include "util.h"
+#include "vboot_hash.h"
+
+#define HASH_OFFSET (CONFIG_EC_WRITABLE_STORAGE_OFF + CONFIG_RW_STORAGE_OFF)
+/* Not a multiple of the chunk size, so the last read is short */
+#define HASH_SIZE (4 * CONFIG_VBOOT_HASH_CACHE_BLOCK_SIZE - 100)
+
+/* Offset of a write in the third cache block of the region */
+#define WRITE_OFFSET (HASH_OFFSET + 2 * CONFIG_VBOOT_HASH_CACHE_BLOCK_SIZE + 8)
+
+static struct ec_response_vboot_hash resp;
+
+#ifndef CONFIG_FLASH_PSTATE
+/* Like SPI flash, this variant has no persistent protect state */
+int flash_physical_protect_at_boot(uint32_t new_flags)
+{
+	return EC_SUCCESS;
+}
+#endif
+
+#ifdef CONFIG_FLASH_READ_ASYNC
+/* Read in flight; its data only arrives once it is waited for, as by DMA */
+static struct {
+	int offset;
+	int size;
+	char *data;
+} pending;
+static int async_reads;
+
+int flash_physical_read_async(int offset, int size, char *data)
+{
+	if (pending.data)
+		return EC_ERROR_BUSY;
+
+	pending.offset = offset;
+	pending.size = size;
+	pending.data = data;
+	/* Anything hashed before the wait gives a wrong digest */
+	memset(data, 0xa5, size);
+	return EC_SUCCESS;
+}
+
+int flash_physical_read_wait(void)
+{
+	if (!pending.data)
+		return EC_ERROR_UNKNOWN;
+
+	memcpy(pending.data, __host_flash + pending.offset, pending.size);
+	pending.data = NULL;
+	async_reads++;
+	return EC_SUCCESS;
+}
+#endif
+
+/* Recalculate the hash of the region, waiting for it to finish */
+static int recalc_hash(void)
+{
+	struct ec_params_vboot_hash p = {
+		.cmd = EC_VBOOT_HASH_RECALC,
+		.hash_type = EC_VBOOT_HASH_TYPE_SHA256,
+		.offset = HASH_OFFSET,
+		.size = HASH_SIZE,
+	};
+	int rv;
+
+	rv = test_send_host_command(EC_CMD_VBOOT_HASH, 0, &p, sizeof(p),
+				    &resp, sizeof(resp));
+	if (rv != EC_RES_SUCCESS)
+		return rv;
+	return resp.status == EC_VBOOT_HASH_STATUS_DONE ? EC_RES_SUCCESS :
+							  EC_RES_ERROR;
+}
+
+/* Check the last hash against one of the region read by flash_read() */
+static int check_hash(void)
+{
+	struct sha256_ctx ctx;
+	const uint8_t *expected;
+	char buf[256];
+	int i, len;
+
+	SHA256_init(&ctx);
+	for (i = 0; i < HASH_SIZE; i += len) {
+		len = MIN(HASH_SIZE - i, sizeof(buf));
+		TEST_EQ(flash_read(HASH_OFFSET + i, len, buf), EC_SUCCESS,
+			"%d");
+		SHA256_update(&ctx, (const uint8_t *)buf, len);
+	}
+	expected = SHA256_final(&ctx);
+	TEST_EQ(resp.digest_size, SHA256_DIGEST_SIZE, "%d");
+	TEST_ASSERT_ARRAY_EQ(resp.hash_digest, expected, SHA256_DIGEST_SIZE);
+
+	return EC_SUCCESS;
+}
+
+static int test_hash_resume(void)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(check_hash() == EC_SUCCESS);
+	memcpy(digest, resp.hash_digest, sizeof(digest));
+
+	/* Nothing changed, so the cached states give the same hash */
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	TEST_ASSERT_ARRAY_EQ(resp.hash_digest, digest, sizeof(digest));
+
+	return EC_SUCCESS;
+}
+
+#ifdef CONFIG_VBOOT_HASH_PIPELINE
+static int test_pipeline(void)
+{
+	const int chunks = (HASH_SIZE + CONFIG_VBOOT_HASH_CHUNK_SIZE - 1) /
+			   CONFIG_VBOOT_HASH_CHUNK_SIZE;
+
+	/* A hash from scratch reads every chunk asynchronously */
+	TEST_EQ(flash_physical_erase(HASH_OFFSET, CONFIG_FLASH_ERASE_SIZE),
+		EC_SUCCESS, "%d");
+	async_reads = 0;
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	TEST_EQ(async_reads, chunks, "%d");
+	TEST_ASSERT(check_hash() == EC_SUCCESS);
+
+	return EC_SUCCESS;
+}
+#endif
+
+static int test_physical_write(void)
+{
+	const char data[] = {0x12, 0x34, 0x56, 0x78};
+	uint8_t digest[SHA256_DIGEST_SIZE];
+
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	memcpy(digest, resp.hash_digest, sizeof(digest));
+
+	/*
+	 * Write below flash_write(), as update_fw and PD firmware updates do,
+	 * into a block whose state is cached.
+	 */
+	TEST_EQ(flash_physical_write(WRITE_OFFSET, sizeof(data), data),
+		EC_SUCCESS, "%d");
+
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(memcmp(resp.hash_digest, digest, sizeof(digest)));
+	TEST_ASSERT(check_hash() == EC_SUCCESS);
+
+	return EC_SUCCESS;
+}
+
+static int test_physical_erase(void)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	memcpy(digest, resp.hash_digest, sizeof(digest));
+
+	TEST_EQ(flash_physical_erase(WRITE_OFFSET - 8,
+				     CONFIG_FLASH_ERASE_SIZE),
+		EC_SUCCESS, "%d");
+
+	TEST_EQ(recalc_hash(), EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(memcmp(resp.hash_digest, digest, sizeof(digest)));
+	TEST_ASSERT(check_hash() == EC_SUCCESS);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, char **argv)
+{
+	int i;
+
+	/* Give the region contents which change with the offset */
+	for (i = 0; i < HASH_SIZE; i++)
+		__host_flash[HASH_OFFSET + i] = i * 7;
+
+	test_reset();
+
+	RUN_TEST(test_hash_resume);
+#ifdef CONFIG_VBOOT_HASH_PIPELINE
+	RUN_TEST(test_pipeline);
+#endif
+	RUN_TEST(test_physical_write);
+	RUN_TEST(test_physical_erase);
+
+	test_print_result();
+}
@@ -49,6 +49,7 @@
 #include "aes.h"
 #include "common.h"
 #include "endian.h"
+#include "util.h"
 
 static inline uint32_t GETU32(const void *in) {
   return be32toh(*(uint32_t *)in);
@@ -804,3 +805,32 @@ void aes_nohw_decrypt(const uint8_t *in, uint8_t *out,
        ((uint32_t)Td4[(t0) & 0xff]) ^ rk[3];
   PUTU32(out + 12, s3);
 }
+
+void aes_nohw_ctr32_encrypt_blocks(const uint8_t *in, uint8_t *out,
+                                   size_t blocks, const AES_KEY *key,
+                                   const uint8_t ivec[16]) {
+  union {
+    uint32_t w[4];
+    uint8_t c[16];
+  } ctr_block, ks;
+  uint32_t ctr, v;
+  size_t i;
+
+  memcpy(ctr_block.c, ivec, sizeof(ctr_block.c));
+  ctr = GETU32(&ctr_block.w[3]);
+
+  while (blocks--) {
+    aes_nohw_encrypt(ctr_block.c, ks.c, key);
+    ++ctr;
+    PUTU32(&ctr_block.w[3], ctr);
+
+    // |in| and |out| may be unaligned; go through memcpy for each word.
+    for (i = 0; i < 4; ++i) {
+      memcpy(&v, in + 4 * i, sizeof(v));
+      v ^= ks.w[i];
+      memcpy(out + 4 * i, &v, sizeof(v));
+    }
+    in += 16;
+    out += 16;
+  }
+}
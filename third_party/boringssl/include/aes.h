@@ -49,6 +49,7 @@
 #ifndef __CROS_EC_AES_H
 #define __CROS_EC_AES_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define AES_ENCRYPT 1
@@ -79,6 +80,9 @@ int aes_nohw_set_encrypt_key(const uint8_t *key, unsigned bits,
                              AES_KEY *aeskey);
 int aes_nohw_set_decrypt_key(const uint8_t *key, unsigned bits,
                              AES_KEY *aeskey);
+void aes_nohw_ctr32_encrypt_blocks(const uint8_t *in, uint8_t *out,
+                                   size_t blocks, const AES_KEY *key,
+                                   const uint8_t ivec[16]);
 
 /**
  * AES_set_encrypt_key configures |aeskey| to encrypt with the |bits|-bit key,
@@ -126,4 +130,17 @@ static inline void AES_decrypt(const uint8_t *in, uint8_t *out,
 	aes_nohw_decrypt(in, out, key);
 }
 
+/**
+ * AES_ctr32_encrypt_blocks encrypts |blocks| whole blocks from |in| to |out| in
+ * counter mode, starting from the counter block |ivec| and incrementing its
+ * last 32 bits, big endian, for each block. |ivec| is not updated. The |in|
+ * and |out| pointers may be equal.
+ */
+static inline void AES_ctr32_encrypt_blocks(const uint8_t *in, uint8_t *out,
+					    size_t blocks, const AES_KEY *key,
+					    const uint8_t ivec[16])
+{
+	aes_nohw_ctr32_encrypt_blocks(in, out, blocks, key, ivec);
+}
+
 #endif  /* __CROS_EC_AES_H */
@@ -35,6 +35,7 @@
  * SUCH DAMAGE.
  */
 
+#include "byteorder.h"
 #include "sha256.h"
 #include "util.h"
 
@@ -115,8 +116,8 @@ void SHA256_init(struct sha256_ctx *ctx)
 	ctx->tot_len = 0;
 }
 
-static void SHA256_transform(struct sha256_ctx *ctx, const uint8_t *message,
-			     unsigned int block_nb)
+static void SHA256_transform_sw(struct sha256_ctx *ctx,
+				const uint8_t *message, unsigned int block_nb)
 {
 	/* Note: this function requires a considerable amount of stack */
 	uint32_t w[64];
@@ -128,6 +129,15 @@ static void SHA256_transform(struct sha256_ctx *ctx, const uint8_t *message,
 	for (i = 0; i < (int) block_nb; i++) {
 		sub_block = message + (i << 6);
 
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+		/* Word-aligned input can be loaded a word at a time */
+		if (!((uintptr_t)sub_block & 3)) {
+			const uint32_t *words = (const uint32_t *)sub_block;
+
+			for (j = 0; j < 16; j++)
+				w[j] = be32toh(words[j]);
+		} else
+#endif
 		for (j = 0; j < 16; j++)
 			PACK32(&sub_block[j << 2], &w[j]);
 
@@ -182,36 +192,49 @@ static void SHA256_transform(struct sha256_ctx *ctx, const uint8_t *message,
 	}
 }
 
-void SHA256_update(struct sha256_ctx *ctx, const uint8_t *data, uint32_t len)
+static void SHA256_transform(struct sha256_ctx *ctx, const uint8_t *message,
+			     unsigned int block_nb)
 {
-	unsigned int block_nb;
-	unsigned int new_len, rem_len, tmp_len;
-	const uint8_t *shifted_data;
-
-	tmp_len = SHA256_BLOCK_SIZE - ctx->len;
-	rem_len = len < tmp_len ? len : tmp_len;
-
-	memcpy(&ctx->block[ctx->len], data, rem_len);
-
-	if (ctx->len + len < SHA256_BLOCK_SIZE) {
-		ctx->len += len;
+	if (!block_nb)
 		return;
-	}
-
-	new_len = len - rem_len;
-	block_nb = new_len / SHA256_BLOCK_SIZE;
 
-	shifted_data = data + rem_len;
+#ifdef CONFIG_SHA256_HW_ACCELERATE
+	if (chip_sha256_transform(ctx->h, message, block_nb) == EC_SUCCESS)
+		return;
+#endif
 
-	SHA256_transform(ctx, ctx->block, 1);
-	SHA256_transform(ctx, shifted_data, block_nb);
+	SHA256_transform_sw(ctx, message, block_nb);
+}
 
-	rem_len = new_len % SHA256_BLOCK_SIZE;
+void SHA256_update(struct sha256_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+	unsigned int block_nb;
+	unsigned int rem_len;
+
+	/* Complete a partially filled block first. */
+	if (ctx->len) {
+		rem_len = MIN(len, SHA256_BLOCK_SIZE - ctx->len);
+		memcpy(&ctx->block[ctx->len], data, rem_len);
+		ctx->len += rem_len;
+
+		if (ctx->len < SHA256_BLOCK_SIZE)
+			return;
+
+		SHA256_transform(ctx, ctx->block, 1);
+		ctx->tot_len += SHA256_BLOCK_SIZE;
+		ctx->len = 0;
+		data += rem_len;
+		len -= rem_len;
+	}
 
-	memcpy(ctx->block, &shifted_data[block_nb << 6], rem_len);
+	/* Whole blocks are hashed straight from the caller's buffer. */
+	block_nb = len / SHA256_BLOCK_SIZE;
+	SHA256_transform(ctx, data, block_nb);
+	ctx->tot_len += block_nb << 6;
 
+	rem_len = len % SHA256_BLOCK_SIZE;
+	memcpy(ctx->block, &data[block_nb << 6], rem_len);
 	ctx->len = rem_len;
-	ctx->tot_len += (block_nb + 1) << 6;
 }
 
 /*
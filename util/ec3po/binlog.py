@@ -0,0 +1,344 @@
+#!/usr/bin/env python3
+# Copyright 2021 The Chromium OS Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""Binary console log decoder
+
+With CONFIG_CONSOLE_BINARY_LOG, the EC writes each cprints() call as a record
+line instead of formatted text (see include/console_binlog.h).  This module
+expands those records back into text, looking up the format strings in the EC
+ELF image.  Other console output is passed through unchanged.
+
+It is used by the ec3po console when given --elf, and can also be run on its
+own, for example:
+
+  ectool console | util/ec3po/binlog.py build/<board>/RW/ec.RW.elf
+"""
+
+# Note: This is a py2/3 compatible file.
+
+from __future__ import print_function
+
+import argparse
+import base64
+import binascii
+import struct
+import sys
+
+
+MARKER = ord('$')  # BINLOG_MARKER
+MAX_LINE = 256  # Longest record line; longer lines are passed through.
+TIMESTAMP_MSEC = 0x80  # BINLOG_TIMESTAMP_MSEC, set in the channel byte.
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class ElfStrings(object):
+  """Looks up null-terminated strings by address in an ELF image.
+
+  Attributes:
+    data: The contents of the ELF file.
+    sections: A list of (address, size, file offset) tuples for each section
+      which is loaded from the file.
+  """
+
+  def __init__(self, path):
+    """Reads the section table of an ELF file.
+
+    Args:
+      path: A string containing the path to the ELF file.
+
+    Raises:
+      ValueError: The file is not an ELF file.
+    """
+    with open(path, 'rb') as f:
+      self.data = f.read()
+
+    if self.data[:4] != b'\x7fELF':
+      raise ValueError('%s is not an ELF file' % path)
+
+    endian = '<' if bytearray(self.data)[5] == 1 else '>'
+    if bytearray(self.data)[4] == 1:
+      shoff, = struct.unpack_from(endian + 'I', self.data, 0x20)
+      shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x2e)
+      shdr = endian + 'IIIIIIIIII'
+    else:
+      shoff, = struct.unpack_from(endian + 'Q', self.data, 0x28)
+      shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x3a)
+      shdr = endian + 'IIQQQQIIQQ'
+
+    self.sections = []
+    for i in range(shnum):
+      (_, sh_type, flags, addr, offset, size, _, _, _, _) = struct.unpack_from(
+          shdr, self.data, shoff + i * shentsize)
+      if flags & SHF_ALLOC and sh_type != SHT_NOBITS and size:
+        self.sections.append((addr, size, offset))
+
+  def Lookup(self, addr):
+    """Returns the string at addr as bytes, or None if there is none."""
+    for start, size, offset in self.sections:
+      if start <= addr < start + size:
+        begin = offset + addr - start
+        end = self.data.find(b'\0', begin, offset + size)
+        if end < 0:
+          return None
+        return self.data[begin:end]
+    return None
+
+
+class Record(object):
+  """Reads the fields of a decoded record in order."""
+
+  def __init__(self, data):
+    self.data = bytearray(data)
+    self.pos = 0
+
+  def Bytes(self, count):
+    if self.pos + count > len(self.data):
+      raise ValueError('record too short')
+    value = bytes(self.data[self.pos:self.pos + count])
+    self.pos += count
+    return value
+
+  def Varint(self):
+    value = 0
+    shift = 0
+    while True:
+      byte = bytearray(self.Bytes(1))[0]
+      value |= (byte & 0x7f) << shift
+      shift += 7
+      if not byte & 0x80:
+        return value
+
+  def SignedVarint(self):
+    value = self.Varint()
+    return (value >> 1) ^ -(value & 1)
+
+
+def FormatTimestamp(us, ts_digits=6):
+  """Formats a timestamp in microseconds the way %pT does.
+
+  Args:
+    us: The timestamp in microseconds.
+    ts_digits: 6 if the EC was built with CONFIG_CONSOLE_VERBOSE, else 3.
+  """
+  if ts_digits == 3:
+    return '%d.%03d' % (us // 1000000, us // 1000 % 1000)
+  return '%d.%06d' % (us // 1000000, us % 1000000)
+
+
+def FormatRecord(fmt, record, ts_digits=6):
+  """Expands one cprints() format string using the arguments in a record.
+
+  This follows the conversions in common/printf.c.
+
+  Args:
+    fmt: The format string, as a str.
+    record: A Record positioned at the first argument.
+    ts_digits: The number of digits after the point in timestamps.
+
+  Returns:
+    The formatted text as a str.
+  """
+  out = []
+  i = 0
+  while i < len(fmt):
+    c = fmt[i]
+    i += 1
+    if c != '%':
+      out.append(c)
+      continue
+
+    if i == len(fmt) or fmt[i] == '%':
+      out.append('%')
+      i += 1
+      continue
+
+    left = plus = zero = False
+    while fmt[i] in '-+0':
+      left |= fmt[i] == '-'
+      plus |= fmt[i] == '+'
+      zero |= fmt[i] == '0'
+      i += 1
+
+    width = 0
+    if fmt[i] == '*':
+      width = record.SignedVarint()
+      i += 1
+    while fmt[i].isdigit():
+      width = width * 10 + int(fmt[i])
+      i += 1
+
+    precision = -1
+    if fmt[i] == '.':
+      i += 1
+      precision = 0
+      if fmt[i] == '*':
+        precision = record.SignedVarint()
+        i += 1
+      while fmt[i].isdigit():
+        precision = precision * 10 + int(fmt[i])
+        i += 1
+
+    while fmt[i] in 'lz':
+      i += 1
+
+    conv = fmt[i]
+    i += 1
+    if conv == 'p':
+      spec = fmt[i]
+      i += 1
+      if spec == 'T':
+        out.append(FormatTimestamp(record.Varint(), ts_digits))
+      elif spec == 'P':
+        out.append('%x' % record.Varint())
+      elif spec == 'h':
+        size = record.Varint()
+        if size:
+          out.append(binascii.hexlify(record.Bytes(size - 1)).decode())
+      elif spec == 'b':
+        count = record.Varint()
+        if count:
+          out.append(bin(record.Varint())[2:].rjust(count - 1, '0'))
+      continue
+
+    if conv == 's':
+      text = record.Bytes(record.Varint()).decode('utf-8', 'replace')
+      if precision >= 0:
+        text = text[:precision]
+        width = min(width, precision)
+    elif conv == 'c':
+      text = chr(record.Varint())
+    else:
+      if conv in 'di':
+        value = record.SignedVarint()
+      else:
+        value = record.Varint()
+      sign = '-' if value < 0 else ('+' if plus and conv in 'di' else '')
+      digits = {'x': '%x', 'X': '%X'}.get(conv, '%d') % abs(value)
+      if precision >= 0:
+        # Fixed point: precision is the number of digits after the point.
+        digits = digits.rjust(precision + 1, '0')
+        digits = digits[:len(digits) - precision] + '.' + (
+            digits[len(digits) - precision:])
+      text = sign + digits
+
+    pad = max(width - len(text), 0)
+    if left:
+      out.append(text + ' ' * pad)
+    else:
+      out.append(('0' if zero else ' ') * pad + text)
+
+  return ''.join(out)
+
+
+class Decoder(object):
+  """Expands record lines in a stream of console output.
+
+  Attributes:
+    strings: An object with a Lookup(address) method which returns the format
+      string at that address as bytes, such as an ElfStrings.
+    line_start: True if the next byte starts a new line.
+    pending: A bytearray holding a record line which has not been terminated
+      yet, or None.
+  """
+
+  def __init__(self, strings):
+    self.strings = strings
+    self.line_start = True
+    self.pending = None
+
+  def Expand(self, line):
+    """Expands a complete record line.
+
+    Args:
+      line: The line as bytes, starting with the marker and without the
+        trailing newline.
+
+    Returns:
+      The text of the line as bytes, or the line unchanged if it is not a
+      record this decoder can expand.
+    """
+    encoded = line[1:].rstrip(b'\r')
+    eol = line[len(encoded) + 1:]
+    try:
+      data = base64.b64decode(encoded + b'=' * (-len(encoded) % 4))
+      if base64.b64encode(data).rstrip(b'=') != encoded:
+        return line
+      record = Record(data)
+      addr, = struct.unpack('<I', record.Bytes(4))
+      channel = bytearray(record.Bytes(1))[0]
+      ts_digits = 3 if channel & TIMESTAMP_MSEC else 6
+      timestamp = record.Varint()
+      fmt = self.strings.Lookup(addr)
+      if fmt is None:
+        return line
+      text = FormatRecord(fmt.decode('utf-8', 'replace'), record, ts_digits)
+    except (ValueError, IndexError, TypeError, binascii.Error):
+      return line
+    return ('[%s %s]' % (FormatTimestamp(timestamp, ts_digits),
+                         text)).encode('utf-8') + eol
+
+  def Feed(self, data):
+    """Processes a chunk of console output.
+
+    Args:
+      data: Console output as bytes.
+
+    Returns:
+      The output with all completed record lines expanded, as bytes.  A record
+      line which is not complete yet is held back until its newline arrives.
+    """
+    out = bytearray()
+    for byte in bytearray(data):
+      if self.pending is not None:
+        if byte == ord('\n'):
+          out += self.Expand(bytes(self.pending))
+          out += b'\n'
+          self.pending = None
+          self.line_start = True
+        elif len(self.pending) >= MAX_LINE:
+          out += self.pending
+          out.append(byte)
+          self.pending = None
+          self.line_start = False
+        else:
+          self.pending.append(byte)
+        continue
+
+      if self.line_start and byte == MARKER:
+        self.pending = bytearray([byte])
+        continue
+
+      out.append(byte)
+      self.line_start = byte == ord('\n')
+    return bytes(out)
+
+
+def main(argv):
+  """Expands binary log records in a console log."""
+  parser = argparse.ArgumentParser(description=('Expand binary console log '
+                                                'records in EC output.'))
+  parser.add_argument('elf', help='EC ELF image the log was written by')
+  parser.add_argument('log', nargs='?',
+                      help='console log to read; default is stdin')
+  opts = parser.parse_args(argv)
+
+  decoder = Decoder(ElfStrings(opts.elf))
+  infile = open(opts.log, 'rb') if opts.log else getattr(sys.stdin, 'buffer',
+                                                         sys.stdin)
+  outfile = getattr(sys.stdout, 'buffer', sys.stdout)
+  while True:
+    data = infile.read1(4096) if hasattr(infile, 'read1') else infile.read(4096)
+    if not data:
+      break
+    outfile.write(decoder.Feed(data))
+    outfile.flush()
+  if decoder.pending is not None:
+    outfile.write(bytes(decoder.pending))
+
+
+if __name__ == '__main__':
+  main(sys.argv[1:])
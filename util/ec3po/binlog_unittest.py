@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+# Copyright 2021 The Chromium OS Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""Unit tests for the binary console log decoder."""
+
+# Note: This is a py2/3 compatible file.
+
+from __future__ import print_function
+
+import base64
+import struct
+import unittest
+
+import binlog
+
+
+def Varint(value):
+  out = bytearray()
+  while value >= 0x80:
+    out.append((value & 0x7f) | 0x80)
+    value >>= 7
+  out.append(value)
+  return bytes(out)
+
+
+def SignedVarint(value):
+  return Varint(((value << 1) ^ (value >> 63)) & ((1 << 64) - 1))
+
+
+def String(value):
+  return Varint(len(value)) + value
+
+
+def RecordLine(addr, timestamp, args, channel=0):
+  """Builds a record line the way common/console_binlog.c does."""
+  record = (struct.pack('<IB', addr, channel) + Varint(timestamp) +
+            b''.join(args))
+  return b'$' + base64.b64encode(record).rstrip(b'=') + b'\r\n'
+
+
+class FakeStrings(object):
+  """String table backed by a dict."""
+
+  def __init__(self, strings):
+    self.strings = strings
+
+  def Lookup(self, addr):
+    return self.strings.get(addr)
+
+
+class TestBinlogDecoder(unittest.TestCase):
+  """Test case to verify that records are expanded like cprints() output."""
+
+  def setUp(self):
+    """Setup the test harness."""
+    self.decoder = binlog.Decoder(FakeStrings({
+        0x1000: b'C%d: PE %s -> %s, flags 0x%08x',
+        0x2000: b'%c %+d %llu %-*s| %ph %pT %%',
+        0x3000: b'%5d|%-5d|%05d|%.3d|%.3s|%6.2s|%X|%pb',
+    }))
+
+  def Expand(self, addr, timestamp, args):
+    return self.decoder.Feed(RecordLine(addr, timestamp, args))
+
+  def test_Record(self):
+    """Verify that a typical record is expanded."""
+    self.assertEqual(
+        self.Expand(0x1000, 12345678,
+                    [SignedVarint(1), String(b'SRC_READY'),
+                     String(b'SRC_TRANSITION'), Varint(0xdeadbeef)]),
+        b'[12.345678 C1: PE SRC_READY -> SRC_TRANSITION, '
+        b'flags 0xdeadbeef]\r\n')
+
+  def test_Conversions(self):
+    """Verify the less common conversions."""
+    self.assertEqual(
+        self.Expand(0x2000, 5,
+                    [Varint(ord('x')), SignedVarint(300), Varint(1 << 40),
+                     SignedVarint(4), String(b'ab'), Varint(3), b'\x00\x5e',
+                     Varint(1234567)]),
+        b'[0.000005 x +300 1099511627776 ab  | 005e 1.234567 %]\r\n')
+
+  def test_Milliseconds(self):
+    """Verify timestamps from an EC built without CONFIG_CONSOLE_VERBOSE."""
+    line = RecordLine(0x2000, 12345678,
+                      [Varint(ord('x')), SignedVarint(0), Varint(0),
+                       SignedVarint(0), String(b''), Varint(0),
+                       Varint(1234567)],
+                      channel=binlog.TIMESTAMP_MSEC | 3)
+    self.assertEqual(self.decoder.Feed(line),
+                     b'[12.345 x +0 0 |  1.234 %]\r\n')
+
+  def test_Padding(self):
+    """Verify width, precision and fixed point output."""
+    self.assertEqual(
+        self.Expand(0x3000, 0,
+                    [SignedVarint(-42), SignedVarint(7), SignedVarint(-42),
+                     SignedVarint(12345), String(b'abcdef'), String(b'xyz'),
+                     Varint(0xabc), Varint(6), Varint(5)]),
+        b'[0.000000   -42|7    |00-42|12.345|abc|xy|ABC|00101]\r\n')
+
+  def test_PassThrough(self):
+    """Verify that text and unknown records are left alone."""
+    text = b'Console is enabled; type HELP for help.\r\n> $ not a record\r\n'
+    self.assertEqual(self.decoder.Feed(text), text)
+    unknown = RecordLine(0x4000, 0, [])
+    self.assertEqual(self.decoder.Feed(unknown), unknown)
+    self.assertEqual(self.decoder.Feed(b'$!!!\n'), b'$!!!\n')
+
+  def test_SplitRecord(self):
+    """Verify that a record split across reads is held back until complete."""
+    line = RecordLine(0x1000, 0, [SignedVarint(0), String(b'a'), String(b'b'),
+                                  Varint(0)])
+    self.assertEqual(self.decoder.Feed(b'text\n' + line[:7]), b'text\n')
+    self.assertEqual(self.decoder.Feed(line[7:]),
+                     b'[0.000000 C0: PE a -> b, flags 0x00000000]\r\n')
+
+
+if __name__ == '__main__':
+  unittest.main()
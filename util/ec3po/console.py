@@ -30,6 +30,7 @@ import traceback
 
 import six
 
+import binlog
 import interpreter
 import threadproc_shim
 
@@ -138,6 +139,8 @@ class Console(object):
     raw_debug: Flag to indicate whether per interrupt data should be logged to
       debug
     output_line_log_buffer: buffer for lines coming from the EC to log to debug
+    binlog: A binlog.Decoder which expands binary log records in EC output, or
+      None to pass them through unchanged.
   """
 
   def __init__(self, master_pty, user_pty, interface_pty, cmd_pipe, dbg_pipe,
@@ -186,6 +189,7 @@ class Console(object):
     self.look_buffer = b''
     self.raw_debug = False
     self.output_line_log_buffer = []
+    self.binlog = None
 
   def __str__(self):
     """Show internal state of Console object as a string."""
@@ -1025,6 +1029,11 @@ def StartLoop(console, command_active, shutdown_pipe=None):
             console.logger.debug('ec3po console received EOF from dbg_pipe')
             continue_looping = False
           else:
+            if console.binlog:
+              # Expand binary log records; partial ones are held back.
+              data = console.binlog.Feed(data)
+              if not data:
+                continue
             if console.interrogation_mode == b'auto':
               # Search look buffer for enhanced EC image string.
               console.CheckBufferForEnhancedImage(data)
@@ -1103,6 +1112,9 @@ def main(argv):
   parser.add_argument('--log-level',
                       default='info',
                       help='info, debug, warning, error, or critical')
+  parser.add_argument('--elf',
+                      help=('EC ELF image used to expand binary console log '
+                            'records (CONFIG_CONSOLE_BINARY_LOG)'))
 
   # Parse arguments.
   opts = parser.parse_args(argv)
@@ -1153,6 +1165,8 @@ def main(argv):
   # Create a console.
   console = Console(master_pty, os.ttyname(user_pty), cmd_pipe_interactive,
                     dbg_pipe_interactive)
+  if opts.elf:
+    console.binlog = binlog.Decoder(binlog.ElfStrings(opts.elf))
   # Start serving the console.
   v = threadproc_shim.Value(ctypes.c_bool, False)
   StartLoop(console, v)
@@ -170,14 +170,22 @@ const char help_str[] =
 	"      Checks for basic communication with EC\n"
 	"  hibdelay [sec]\n"
 	"      Set the delay before going into hibernation\n"
+	"  hookstats [hooks|deferred] [clear]\n"
+	"      Prints per-routine profile of hooks or deferred functions\n"
 	"  hostsleepstate\n"
 	"      Report host sleep state to the EC\n"
+	"  hoststats [clear]\n"
+	"      Prints per-command profile of host command handlers\n"
 	"  hostevent\n"
 	"      Get & set host event masks.\n"
 	"  i2cprotect <port> [status]\n"
 	"      Protect EC's I2C bus\n"
 	"  i2cread\n"
 	"      Read I2C bus\n"
+	"  i2cstats [clear]\n"
+	"      Prints per-device I2C transfer counts and bus utilization\n"
+	"  i2ctrace [-f] [file]\n"
+	"      Prints or saves the EC's I2C transfer trace\n"
 	"  i2cwrite\n"
 	"      Write I2C bus\n"
 	"  i2cxfer <port> <slave_addr> <read_count> [write bytes...]\n"
@@ -559,6 +567,101 @@ int cmd_hibdelay(int argc, char *argv[])
 	return 0;
 }
 
+int cmd_hook_stats(int argc, char *argv[])
+{
+	struct ec_params_hook_stats p = {
+		.kind = EC_HOOK_STATS_HOOKS,
+	};
+	struct ec_response_hook_stats *r = ec_inbuf;
+	struct ec_hook_stats_entry *e;
+	int rv, i, b;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcasecmp(argv[i], "hooks")) {
+			p.kind = EC_HOOK_STATS_HOOKS;
+		} else if (!strcasecmp(argv[i], "deferred")) {
+			p.kind = EC_HOOK_STATS_DEFERRED;
+		} else if (!strcasecmp(argv[i], "clear")) {
+			p.flags |= EC_HOOK_STATS_FLAG_CLEAR;
+		} else {
+			fprintf(stderr, "Usage: %s [hooks|deferred] [clear]\n",
+				argv[0]);
+			return -1;
+		}
+	}
+
+	printf("routine     type prio      calls   total_us  max_us  "
+	       "late <64us/256us/1ms/4ms/16ms/64ms/256ms/more\n");
+	do {
+		rv = ec_command(EC_CMD_HOOK_STATS, 0, &p, sizeof(p),
+				ec_inbuf, ec_max_insize);
+		if (rv < 0) {
+			fprintf(stderr, "ERROR: EC_CMD_HOOK_STATS failed; %d\n",
+				rv);
+			return rv;
+		}
+
+		for (i = 0; i < r->count; i++) {
+			e = &r->entries[i];
+			if (e->type == EC_HOOK_STATS_TYPE_DEFERRED)
+				printf("0x%08x  def     - ", e->routine);
+			else
+				printf("0x%08x  %3d %5d ", e->routine, e->type,
+				       e->priority);
+			printf("%10u %10" PRIu64 " %7u ", e->calls,
+			       e->total_us, e->max_us);
+			for (b = 0; b < EC_HOOK_STATS_LATE_BUCKETS; b++)
+				printf(" %u", e->late[b]);
+			printf("\n");
+		}
+		p.offset += r->count;
+	} while (r->count && p.offset < r->total);
+
+	return 0;
+}
+
+int cmd_host_stats(int argc, char *argv[])
+{
+	struct ec_params_host_stats p = { 0 };
+	struct ec_response_host_stats *r = ec_inbuf;
+	struct ec_host_stats_entry *e;
+	int rv, i, b;
+
+	if (argc > 2 || (argc == 2 && strcasecmp(argv[1], "clear"))) {
+		fprintf(stderr, "Usage: %s [clear]\n", argv[0]);
+		return -1;
+	}
+	if (argc == 2)
+		p.flags |= EC_HOST_STATS_FLAG_CLEAR;
+
+	printf("cmd         calls errors last    min_us    max_us  "
+	       "mean_us  <16us/32us/.../16ms/more\n");
+	do {
+		rv = ec_command(EC_CMD_HOST_STATS, 0, &p, sizeof(p),
+				ec_inbuf, ec_max_insize);
+		if (rv < 0) {
+			fprintf(stderr, "ERROR: EC_CMD_HOST_STATS failed; %d\n",
+				rv);
+			return rv;
+		}
+
+		for (i = 0; i < r->count; i++) {
+			e = &r->entries[i];
+			if (!e->calls)
+				continue;
+			printf("0x%04x %10u %6u %4u %9u %9u %8" PRIu64 " ",
+			       e->command, e->calls, e->errors, e->last_error,
+			       e->min_us, e->max_us, e->total_us / e->calls);
+			for (b = 0; b < EC_HOST_STATS_BUCKETS; b++)
+				printf(" %u", e->hist[b]);
+			printf("\n");
+		}
+		p.offset += r->count;
+	} while (r->count && p.offset < r->total);
+
+	return 0;
+}
+
 static void cmd_hostevent_help(char *cmd)
 {
 	fprintf(stderr,
@@ -7218,6 +7321,160 @@ int cmd_i2c_xfer(int argc, char *argv[])
 	return 0;
 }
 
+int cmd_i2c_stats(int argc, char *argv[])
+{
+	struct ec_params_i2c_stats p = { 0 };
+	struct ec_response_i2c_stats *r = ec_inbuf;
+	struct ec_i2c_stats_entry *e;
+	struct {
+		uint32_t xfers;
+		uint32_t failed;
+		uint32_t bytes;
+		uint64_t total_us;
+	} ports[256] = { 0 };
+	uint32_t window_ms = 0;
+	int rv, i, b;
+
+	if (argc > 2 || (argc == 2 && strcasecmp(argv[1], "clear"))) {
+		fprintf(stderr, "Usage: %s [clear]\n", argv[0]);
+		return -1;
+	}
+	if (argc == 2)
+		p.flags |= EC_I2C_STATS_FLAG_CLEAR;
+
+	printf("port addr      xfers errors tmouts retries      bytes  "
+	       "max_us  mean_us  busy%%  <32us/64us/.../8ms/more\n");
+	do {
+		rv = ec_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p),
+				ec_inbuf, ec_max_insize);
+		if (rv < 0) {
+			fprintf(stderr, "ERROR: EC_CMD_I2C_STATS failed; %d\n",
+				rv);
+			return rv;
+		}
+		if (!p.offset)
+			window_ms = MAX(r->window_ms, 1);
+
+		for (i = 0; i < r->count; i++) {
+			e = &r->entries[i];
+			printf("%4u 0x%02x %10u %6u %6u %7u %10u %7u %8" PRIu64
+			       " %5.1f ",
+			       e->port, e->addr, e->xfers, e->errors,
+			       e->timeouts, e->retries, e->bytes, e->max_us,
+			       e->xfers ? e->total_us / e->xfers : 0,
+			       e->total_us / (10.0 * window_ms));
+			for (b = 0; b < EC_I2C_STATS_BUCKETS; b++)
+				printf(" %u", e->hist[b]);
+			printf("\n");
+
+			ports[e->port].xfers += e->xfers;
+			ports[e->port].failed += e->errors + e->timeouts;
+			ports[e->port].bytes += e->bytes;
+			ports[e->port].total_us += e->total_us;
+		}
+		p.offset += r->count;
+	} while (r->count && p.offset < r->total);
+
+	printf("\nport      xfers failed      bytes  busy%% over %u.%03u s\n",
+	       window_ms / 1000, window_ms % 1000);
+	for (i = 0; i < ARRAY_SIZE(ports); i++) {
+		if (!ports[i].xfers)
+			continue;
+		printf("%4d %10u %6u %10u %5.1f\n", i, ports[i].xfers,
+		       ports[i].failed, ports[i].bytes,
+		       ports[i].total_us / (10.0 * window_ms));
+	}
+	if (r->dropped)
+		printf("%u transfers to untracked devices\n", r->dropped);
+
+	return 0;
+}
+
+static void print_i2c_trace_record(uint32_t seq,
+				   const struct ec_i2c_trace_record *t)
+{
+	int out = MIN(t->out_size, EC_I2C_TRACE_DATA_SIZE);
+	int in = MIN(t->in_size, EC_I2C_TRACE_DATA_SIZE - out);
+	int i;
+
+	printf("%10u %10u.%06u %4u 0x%02x %5u %3u %3u %3u ", seq,
+	       t->timestamp / 1000000, t->timestamp % 1000000, t->port,
+	       t->addr, t->duration_us, t->out_size, t->in_size, t->status);
+	for (i = 0; i < out; i++)
+		printf(" %02x", t->data[i]);
+	if (t->status)
+		in = 0;
+	if (in)
+		printf(" :");
+	for (i = 0; i < in; i++)
+		printf(" %02x", t->data[out + i]);
+	printf("\n");
+}
+
+int cmd_i2c_trace(int argc, char *argv[])
+{
+	struct ec_params_i2c_trace p = { 0 };
+	struct ec_response_i2c_trace *r = ec_inbuf;
+	FILE *f = NULL;
+	int follow = 0;
+	int first = 1;
+	int rv, i;
+
+	if (argc > 1 && !strcmp(argv[1], "-f")) {
+		follow = 1;
+		argc--;
+		argv++;
+	}
+	if (argc > 2) {
+		fprintf(stderr, "Usage: %s [-f] [file]\n", argv[0]);
+		return -1;
+	}
+	if (argc == 2) {
+		f = fopen(argv[1], "wb");
+		if (!f) {
+			perror(argv[1]);
+			return -1;
+		}
+	} else {
+		printf("       seq       time (s) port addr    us out  in err"
+		       "  data\n");
+	}
+
+	/* Start from the oldest record the EC still has */
+	while (1) {
+		rv = ec_command(EC_CMD_I2C_TRACE, 0, &p, sizeof(p),
+				ec_inbuf, ec_max_insize);
+		if (rv < 0) {
+			fprintf(stderr, "ERROR: EC_CMD_I2C_TRACE failed; %d\n",
+				rv);
+			break;
+		}
+		if (!first && r->seq != p.seq)
+			fprintf(stderr, "%u records lost\n", r->seq - p.seq);
+		first = 0;
+
+		if (f) {
+			fwrite(r->records, sizeof(r->records[0]), r->count, f);
+			fflush(f);
+		} else {
+			for (i = 0; i < r->count; i++)
+				print_i2c_trace_record(r->seq + i,
+						       &r->records[i]);
+		}
+		p.seq = r->seq + r->count;
+
+		if (p.seq == r->head) {
+			if (!follow)
+				break;
+			usleep(100000);
+		}
+	}
+
+	if (f)
+		fclose(f);
+	return rv < 0 ? rv : 0;
+}
+
 static void cmd_locate_chip_help(const char *const cmd)
 {
 	fprintf(stderr,
@@ -10080,11 +10337,15 @@ const struct command commands[] = {
 	{"hangdetect", cmd_hang_detect},
 	{"hello", cmd_hello},
 	{"hibdelay", cmd_hibdelay},
+	{"hookstats", cmd_hook_stats},
 	{"hostevent", cmd_hostevent},
 	{"hostsleepstate", cmd_hostsleepstate},
+	{"hoststats", cmd_host_stats},
 	{"locatechip", cmd_locate_chip},
 	{"i2cprotect", cmd_i2c_protect},
 	{"i2cread", cmd_i2c_read},
+	{"i2cstats", cmd_i2c_stats},
+	{"i2ctrace", cmd_i2c_trace},
 	{"i2cwrite", cmd_i2c_write},
 	{"i2cxfer", cmd_i2c_xfer},
 	{"infopddev", cmd_pd_device_info},
@@ -0,0 +1,250 @@
+#!/usr/bin/env python
+# Copyright 2021 The Chromium OS Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+# Note: This is a py2/3 compatible file.
+
+"""Decode an EC I2C trace saved with 'ectool i2ctrace <file>'.
+
+The trace is a series of struct ec_i2c_trace_record.  This prints each
+device's transfers as a lane on a shared time axis, like a logic analyzer,
+followed by per-device and per-port totals.
+"""
+
+from __future__ import print_function
+import argparse
+import collections
+import struct
+import sys
+
+# struct ec_i2c_trace_record
+RECORD = struct.Struct('<IHBBBBBB4s')
+DATA_SIZE = 4
+
+I2C_XFER_START = 1 << 0
+I2C_XFER_STOP = 1 << 1
+
+EC_ERRORS = {
+    0: 'ok',
+    1: 'UNKNOWN',
+    4: 'TIMEOUT',
+    5: 'INVAL',
+    6: 'BUSY',
+    10: 'CRC',
+}
+
+Transfer = collections.namedtuple(
+    'Transfer', ['start', 'us', 'port', 'addr', 'out_size', 'in_size',
+                 'status', 'flags', 'out', 'in_'])
+
+
+def read_trace(f):
+  """Read records from f, with timestamps unwrapped past 32 bits."""
+  xfers = []
+  base = 0
+  last = None
+  while True:
+    raw = f.read(RECORD.size)
+    if len(raw) < RECORD.size:
+      break
+    (ts, us, port, addr, out_size, in_size, status, flags,
+     data) = RECORD.unpack(raw)
+    data = bytearray(data)
+    if last is not None and ts < last and last - ts > 1 << 31:
+      base += 1 << 32
+    last = ts
+    n_out = min(out_size, DATA_SIZE)
+    n_in = 0 if status else min(in_size, DATA_SIZE - n_out)
+    xfers.append(Transfer(base + ts, us, port, addr, out_size, in_size,
+                          status, flags, data[:n_out],
+                          data[n_out:n_out + n_in]))
+  return xfers
+
+
+def parse_names(names):
+  """Turn 'port:addr=label' arguments into a dict."""
+  labels = {}
+  for name in names or []:
+    try:
+      dev, label = name.split('=', 1)
+      port, addr = dev.split(':')
+      labels[(int(port, 0), int(addr, 0))] = label
+    except ValueError:
+      raise argparse.ArgumentTypeError('bad --name %r' % name)
+  return labels
+
+
+def device_name(dev, labels):
+  if dev in labels:
+    return labels[dev]
+  return '%d:0x%02x' % dev
+
+
+def hexbytes(data):
+  return ' '.join('%02x' % b for b in data)
+
+
+def print_list(xfers, labels, t0):
+  """Print one line per transfer."""
+  print('     time (ms)      gap     us  device      status  data')
+  last_end = {}
+  for x in xfers:
+    end = last_end.get(x.port)
+    gap = '%8d' % (x.start - end) if end is not None else '%8s' % '-'
+    last_end[x.port] = x.start + x.us
+    data = hexbytes(x.out)
+    if x.out_size > len(x.out):
+      data += ' ..'
+    if x.in_size and not x.status:
+      data += ' : ' + hexbytes(x.in_)
+      if x.in_size > len(x.in_):
+        data += ' ..'
+    if not x.flags & I2C_XFER_STOP:
+      data += ' (no stop)'
+    print('%14.3f %s %6d  %-10s  %-7s %s' % (
+        (x.start - t0) / 1000.0, gap, x.us,
+        device_name((x.port, x.addr), labels),
+        EC_ERRORS.get(x.status, str(x.status)), data))
+
+
+def print_timeline(xfers, labels, t0, t1, width):
+  """Print one lane per device, grouped by port.
+
+  Each column covers (t1 - t0) / width us.  A column shows '#' if the device
+  was on the bus during it and 'x' if a transfer to it failed then.  The port
+  lane shows which device held the bus, or '*' if several did.
+  """
+  span = max(t1 - t0, 1)
+  lanes = collections.OrderedDict()
+  ports = collections.OrderedDict()
+  letters = {}
+
+  for dev in sorted(set((x.port, x.addr) for x in xfers)):
+    lanes[dev] = [' '] * width
+    ports.setdefault(dev[0], [' '] * width)
+    letters[dev] = chr(ord('A') + len(
+        [d for d in letters if d[0] == dev[0]]) % 26)
+
+  for x in xfers:
+    dev = (x.port, x.addr)
+    first = (x.start - t0) * width // span
+    last = (x.start + x.us - t0) * width // span
+    for col in range(max(first, 0), min(last, width - 1) + 1):
+      mark = 'x' if x.status else '#'
+      if lanes[dev][col] != 'x':
+        lanes[dev][col] = mark
+      held = ports[x.port][col]
+      if held == ' ':
+        ports[x.port][col] = letters[dev]
+      elif held != letters[dev]:
+        ports[x.port][col] = '*'
+
+  print('%.3f ms to %.3f ms, %.3f ms per column' % (
+      0.0, (t1 - t0) / 1000.0, span / 1000.0 / width))
+  for port, lane in ports.items():
+    print()
+    print('port %-12d|%s|' % (port, ''.join(lane)))
+    for dev, lane in lanes.items():
+      if dev[0] != port:
+        continue
+      print('  %s %-12s|%s|' % (letters[dev],
+                                device_name(dev, labels)[:12],
+                                ''.join(lane)))
+
+
+def print_summary(xfers, labels, t0, t1, gap_us):
+  """Print totals per device and per port.
+
+  A transfer which starts within gap_us of the end of a transfer to another
+  device on the same port most likely waited for the bus; these are counted
+  as contended.
+  """
+  span = max(t1 - t0, 1)
+  devs = collections.OrderedDict()
+  ports = collections.OrderedDict()
+  last = {}
+
+  for x in xfers:
+    dev = (x.port, x.addr)
+    d = devs.setdefault(dev, collections.Counter())
+    p = ports.setdefault(x.port, collections.Counter())
+    for c in (d, p):
+      c['xfers'] += 1
+      c['bytes'] += x.out_size + x.in_size
+      c['busy'] += x.us
+      c['errors'] += bool(x.status)
+    d['max'] = max(d['max'], x.us)
+
+    prev = last.get(x.port)
+    if prev and prev[0] != dev and x.start - prev[1] <= gap_us:
+      d['contended'] += 1
+      p['contended'] += 1
+    last[x.port] = (dev, x.start + x.us)
+
+  print('device            xfers errors    bytes   max_us  busy%  contended')
+  for dev in sorted(devs):
+    d = devs[dev]
+    print('%-16s %6d %6d %8d %8d %6.2f %10d' % (
+        device_name(dev, labels), d['xfers'], d['errors'], d['bytes'],
+        d['max'], 100.0 * d['busy'] / span, d['contended']))
+  print()
+  print('port              xfers errors    bytes          busy%  contended')
+  for port in sorted(ports):
+    p = ports[port]
+    print('%-16d %6d %6d %8d %15.2f %10d' % (
+        port, p['xfers'], p['errors'], p['bytes'],
+        100.0 * p['busy'] / span, p['contended']))
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('trace', type=argparse.FileType('rb'),
+                      help='file written by ectool i2ctrace')
+  parser.add_argument('-l', '--list', action='store_true',
+                      help='list every transfer')
+  parser.add_argument('-w', '--width', type=int, default=100,
+                      help='timeline width in columns (default %(default)s)')
+  parser.add_argument('-s', '--start', type=float, default=None,
+                      help='start of the window, in ms from the first record')
+  parser.add_argument('-e', '--end', type=float, default=None,
+                      help='end of the window, in ms from the first record')
+  parser.add_argument('-p', '--port', type=int, action='append',
+                      help='only show this port; may be repeated')
+  parser.add_argument('-g', '--gap', type=int, default=50,
+                      help='max idle us before a transfer to count it as '
+                      'contended (default %(default)s)')
+  parser.add_argument('-n', '--name', action='append',
+                      help='label a device, as port:addr=label')
+  args = parser.parse_args(argv)
+
+  labels = parse_names(args.name)
+  xfers = read_trace(args.trace)
+  if not xfers:
+    print('no transfers in trace', file=sys.stderr)
+    return 1
+
+  t0 = xfers[0].start
+  t1 = max(x.start + x.us for x in xfers)
+  if args.start is not None:
+    t0 += int(args.start * 1000)
+  if args.end is not None:
+    t1 = xfers[0].start + int(args.end * 1000)
+  xfers = [x for x in xfers
+           if x.start + x.us >= t0 and x.start <= t1 and
+           (not args.port or x.port in args.port)]
+  if not xfers:
+    print('no transfers in window', file=sys.stderr)
+    return 1
+
+  if args.list:
+    print_list(xfers, labels, t0)
+    print()
+  print_timeline(xfers, labels, t0, t1, args.width)
+  print()
+  print_summary(xfers, labels, t0, t1, args.gap)
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))